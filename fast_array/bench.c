@@ -0,0 +1,1036 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Benchmark harness of the fast array API.
+** Each case is swept over sizes from L1 resident to DRAM sized
+** buffers and reported as ns/sample, GB/s and p50 / p99 latency,
+** as a text table, CSV or JSON lines.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "bench.h"
+
+static const size_t bench_default_sizes[] = { 256, 4096, 65536, 1 << 20, 1 << 22 }; // 2 KB (L1) .. 32 MB (DRAM)
+static const size_t bench_quick_sizes[] = { 256, 4096, 65536 };
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          SETUP
+*******************************************************************************/
+static dtype* bench_alloc(const size_t n)
+{
+	/* aligned buffer of random samples, touched once so the timing does not include page faults */
+
+	dtype* arr = (dtype*)fa_aligned_malloc(sizeof(dtype) * n);
+	size_t i;
+
+	if (arr == NULL) return NULL;
+	for (i = 0; i < n; i++) arr[i] = (dtype)((double)rand() / RAND_MAX - 0.5);
+	return arr;
+}
+
+static void bench_teardown(bench_state_t* st)
+{
+	fa_aligned_free(st->a);
+	fa_aligned_free(st->b);
+	fa_aligned_free(st->c);
+	fa_aligned_free(st->ta);
+	fa_aligned_free(st->tb);
+	fa_destroy(st->fa);
+	fir_destroy(st->fir);
+	resampler_destroy(st->rs);
+	biquad_destroy(st->bq);
+	stats_destroy(st->stats);
+	lms_destroy(st->lms);
+	bank_destroy(st->bank);
+	fft_destroy(st->plan);
+	autocor_stream_destroy(st->ac);
+	sdft_destroy(st->sdft);
+	xcorr_destroy(st->xc);
+	expr_destroy(st->expr);
+	osc_destroy(st->osc);
+	osc_bank_destroy(st->osc_bank);
+	noise_destroy(st->noise);
+	spsc_destroy(st->spsc);
+	simd_force_level(SIMD_AVX512); // back to the widest level of the cpu
+}
+
+static int setup_push(bench_state_t* st)
+{
+	/* a : window (mirrored for the pidx variants), b : input stream */
+
+	if ((st->a = bench_alloc(2 * st->size)) == NULL || (st->b = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	st->samples = 1;
+	st->bytes = 2.0 * sizeof(dtype) * st->size; // naive push reads and writes the window
+	return 0;
+}
+
+static int setup_push_fast(bench_state_t* st)
+{
+	if (setup_push(st) < 0) return -1;
+	st->bytes = 2.0 * sizeof(dtype); // two stores
+	return 0;
+}
+
+static int setup_push_handle(bench_state_t* st)
+{
+	/* arg : FA_MIRROR_COPY or FA_MIRROR_MAPPED */
+
+	if ((st->fa = fa_create_mode(st->size, st->arg)) == NULL || (st->b = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	if (fa_mirror_mode(st->fa) != st->arg) return -1; // no double mapping here
+	zeros_fa(st->fa);
+	st->samples = 1;
+	st->bytes = (st->arg == FA_MIRROR_MAPPED ? 1.0 : 2.0) * sizeof(dtype);
+	return 0;
+}
+
+static int setup_push_handle_block(bench_state_t* st)
+{
+	if (setup_push_handle(st) < 0) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes += sizeof(dtype); // one load
+	return 0;
+}
+
+static int setup_push_block(bench_state_t* st)
+{
+	if (setup_push(st) < 0) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes = 3.0 * sizeof(dtype); // one load, two stores
+	return 0;
+}
+
+static int setup_push_spsc(bench_state_t* st)
+{
+	if ((st->spsc = spsc_create(st->size, BENCH_BLOCK)) == NULL || (st->b = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes = 3.0 * sizeof(dtype);
+	return 0;
+}
+
+static int setup_dot(bench_state_t* st)
+{
+	simd_force_level(st->arg);
+	if (simd_level() != st->arg) return -1; // not supported by the cpu
+
+	// run_dot shifts both windows by up to 7, b gets the same slack as a
+	if ((st->a = bench_alloc(2 * st->size)) == NULL || (st->b = bench_alloc(st->size + 8)) == NULL) return -1;
+	st->samples = st->size;
+	st->bytes = 2.0 * sizeof(dtype);
+	return 0;
+}
+
+static int setup_dot_f32(bench_state_t* st)
+{
+	size_t i;
+
+	if ((st->ta = fa_aligned_malloc(sizeof(f32_t) * st->size)) == NULL || (st->tb = fa_aligned_malloc(sizeof(f32_t) * st->size)) == NULL) return -1;
+	for (i = 0; i < st->size; i++) ((f32_t*)st->ta)[i] = (f32_t)rand() / RAND_MAX, ((f32_t*)st->tb)[i] = (f32_t)rand() / RAND_MAX;
+	st->samples = st->size;
+	st->bytes = 2.0 * sizeof(f32_t);
+	return 0;
+}
+
+static int setup_dot_q15(bench_state_t* st)
+{
+	size_t i;
+
+	if ((st->ta = fa_aligned_malloc(sizeof(q15_t) * st->size)) == NULL || (st->tb = fa_aligned_malloc(sizeof(q15_t) * st->size)) == NULL) return -1;
+	for (i = 0; i < st->size; i++) ((q15_t*)st->ta)[i] = (q15_t)(rand() - RAND_MAX / 2), ((q15_t*)st->tb)[i] = (q15_t)(rand() - RAND_MAX / 2);
+	st->samples = st->size;
+	st->bytes = 2.0 * sizeof(q15_t);
+	return 0;
+}
+
+static int setup_generate(bench_state_t* st)
+{
+	if ((st->a = bench_alloc(st->size)) == NULL) return -1;
+	st->samples = st->size;
+	st->bytes = sizeof(dtype);
+	return 0;
+}
+
+static int setup_expr(bench_state_t* st)
+{
+	/* a : data, b : window, c : reference, ta : noise, arg bit 0 : fused, bit 1 : add noise */
+
+	size_t i;
+
+	if ((st->a = bench_alloc(st->size)) == NULL || (st->b = bench_alloc(st->size)) == NULL
+		|| (st->c = bench_alloc(st->size)) == NULL || (st->ta = bench_alloc(st->size)) == NULL) return -1;
+	if ((st->noise = noise_create(1, 0)) == NULL || (st->expr = expr_create()) == NULL) return -1;
+	for (i = 0; i < st->size; i++) st->b[i] = (dtype)(0.5 - 0.5 * cos(PI2 * i / st->size));
+
+	expr_scale(st->expr, 0.5);
+	if (st->arg & 2) expr_noise(st->expr, 0, 0.1, st->noise);
+	expr_mul(st->expr, st->b);
+	expr_reduce(st->expr, EXPR_REDUCE_DOT, st->c);
+
+	st->samples = st->size;
+	st->bytes = 5.0 * sizeof(dtype); // fused : read data, window, reference, write data
+	return 0;
+}
+
+static int setup_dot_mt(bench_state_t* st)
+{
+	if ((st->a = bench_alloc(st->size)) == NULL || (st->b = bench_alloc(st->size)) == NULL) return -1;
+	st->samples = st->size;
+	st->bytes = 2.0 * sizeof(dtype);
+	return 0;
+}
+
+static int setup_fir(bench_state_t* st)
+{
+	if ((st->a = bench_alloc(st->size)) == NULL || (st->b = bench_alloc(BENCH_BLOCK)) == NULL || (st->c = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	if ((st->fir = fir_create(st->a, st->size, FIR_DEFAULT_BLOCK)) == NULL) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes = 2.0 * sizeof(dtype) * st->size; // taps and history per output
+	return 0;
+}
+
+static int setup_resample(bench_state_t* st)
+{
+	/* size : prototype taps, samples : input samples */
+
+	const size_t up = (size_t)st->arg / 256, down = (size_t)st->arg % 256;
+
+	if ((st->a = bench_alloc(st->size)) == NULL || (st->b = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	if ((st->c = bench_alloc(BENCH_BLOCK * up / down + 1)) == NULL) return -1;
+	if ((st->rs = resampler_create(st->a, st->size, up, down, FIR_DEFAULT_BLOCK)) == NULL) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes = sizeof(dtype) * (1.0 + (double)up / down);
+	return 0;
+}
+
+static int setup_biquad(bench_state_t* st)
+{
+	/* size : frames per call, arg : channels */
+
+	const size_t C = (size_t)st->arg;
+	dtype coef[5];
+	size_t c, s;
+
+	if ((st->a = bench_alloc(st->size * C)) == NULL || (st->bq = biquad_create(BENCH_SECTIONS, C, BIQUAD_DEFAULT_BLOCK)) == NULL) return -1;
+	for (s = 0; s < BENCH_SECTIONS; s++)
+	{
+		biquad_design(BIQUAD_PEAK, 250.0 * (s + 1), 48000, 1, 3, coef);
+		for (c = 0; c < C; c++) biquad_set_section(st->bq, c, s, coef);
+	}
+	st->samples = st->size * C;
+	st->bytes = 2.0 * sizeof(dtype);
+	return 0;
+}
+
+static int setup_lms(bench_state_t* st)
+{
+	if ((st->a = bench_alloc(BENCH_BLOCK)) == NULL || (st->b = bench_alloc(BENCH_BLOCK)) == NULL || (st->c = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	if ((st->lms = lms_create(st->arg, st->size, 1e-4)) == NULL) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes = 3.0 * sizeof(dtype) * st->size; // taps read and written, history read
+	return 0;
+}
+
+static int setup_bank(bench_state_t* st)
+{
+	const size_t n = BENCH_BLOCK * BENCH_CHANNELS;
+
+	if ((st->a = bench_alloc(n)) == NULL || (st->b = bench_alloc(n)) == NULL || (st->c = bench_alloc(n)) == NULL) return -1;
+	if (st->arg == BANK_FIR) st->bank = bank_fir_create(BENCH_CHANNELS, st->size, BENCH_BLOCK);
+	else st->bank = bank_lms_create(LMS_NORMALIZED, BENCH_CHANNELS, st->size, 1e-4, BENCH_BLOCK);
+	if (st->bank == NULL) return -1;
+	st->samples = n;
+	st->bytes = (st->arg == BANK_FIR ? 2.0 : 3.0) * sizeof(dtype) * st->size;
+	return 0;
+}
+
+static int setup_osc(bench_state_t* st)
+{
+	if ((st->a = bench_alloc(st->size)) == NULL || (st->osc = osc_create(440, 48000, 1, 0)) == NULL) return -1;
+	st->samples = st->size;
+	st->bytes = sizeof(dtype);
+	return 0;
+}
+
+static int setup_osc_bank(bench_state_t* st)
+{
+	/* size : number of tones, BENCH_BLOCK frames per call */
+	size_t t;
+
+	if ((st->a = bench_alloc(st->arg ? BENCH_BLOCK : BENCH_BLOCK * st->size)) == NULL) return -1;
+	if ((st->osc_bank = osc_bank_create(st->size)) == NULL) return -1;
+	for (t = 0; t < st->size; t++) osc_bank_set_tone(st->osc_bank, t, 50.0f + t, 48000, 1, 0);
+	st->samples = BENCH_BLOCK * st->size;
+	st->bytes = (st->arg ? 2.0 : 1.0) * sizeof(dtype); // mix : out is read and written per tone
+	return 0;
+}
+
+static int setup_stats(bench_state_t* st)
+{
+	/* size : window length, arg : STATS_* flags, 0 : rescan of a fast array after every push */
+
+	size_t i;
+
+	if ((st->b = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	for (i = 0; i < BENCH_BLOCK; i++) st->b[i] = (dtype)((i * 2654435761u) % 1000);
+	if (st->arg == 0)
+	{
+		if ((st->fa = fa_create(st->size)) == NULL) return -1;
+		zeros_fa(st->fa);
+	}
+	else if ((st->stats = stats_create(st->size, st->arg)) == NULL) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes = sizeof(dtype);
+	return 0;
+}
+
+static int setup_noise(bench_state_t* st)
+{
+	if ((st->a = bench_alloc(st->size)) == NULL || (st->noise = noise_create(1, 0)) == NULL) return -1;
+	st->samples = st->size;
+	st->bytes = sizeof(dtype);
+	return 0;
+}
+
+static int setup_fft(bench_state_t* st)
+{
+	const size_t n = st->arg ? st->size : 2 * st->size; // real : n samples, complex : n pairs
+
+	if ((st->plan = (st->arg ? rfft_create(st->size) : fft_create(st->size))) == NULL) return -1;
+	if ((st->a = bench_alloc(n)) == NULL || (st->b = bench_alloc(2 * st->size + 2)) == NULL) return -1;
+	st->samples = st->size;
+	st->bytes = (st->arg ? 3.0 : 4.0) * sizeof(dtype); // one read, one complex write
+	return 0;
+}
+
+static int setup_autocor(bench_state_t* st)
+{
+	if ((st->a = bench_alloc(st->size + BENCH_LAG)) == NULL || (st->b = bench_alloc(BENCH_LAG)) == NULL) return -1;
+	st->samples = st->size;
+	st->bytes = sizeof(dtype);
+	return 0;
+}
+
+static int setup_autocor_stream(bench_state_t* st)
+{
+	if ((st->ac = autocor_stream_create((int)st->size, BENCH_LAG, 0)) == NULL || (st->a = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+	st->samples = BENCH_BLOCK;
+	st->bytes = 3.0 * sizeof(dtype);
+	return 0;
+}
+
+static int setup_xcorr(bench_state_t* st)
+{
+	/* a : reference, b : input block, c : correlations, arg 0 : rescan, 1 : overlap-save, 2 : sliding dft */
+
+	size_t bins[BENCH_BINS], k;
+
+	if ((st->a = bench_alloc(st->size)) == NULL || (st->b = bench_alloc(BENCH_BLOCK)) == NULL
+		|| (st->c = bench_alloc(BENCH_BLOCK)) == NULL) return -1;
+
+	if (st->arg == 0 && (st->fa = fa_create(st->size)) == NULL) return -1;
+	if (st->arg == 1 && (st->xc = xcorr_create(st->a, st->size, BENCH_BLOCK)) == NULL) return -1;
+	if (st->arg == 2)
+	{
+		if (st->size < 2 * BENCH_BINS) return -1;
+		for (k = 0; k < BENCH_BINS; k++) bins[k] = k + 1;
+		if ((st->sdft = sdft_create(st->size, bins, BENCH_BINS, 0)) == NULL) return -1;
+		sdft_set_reference(st->sdft, st->a);
+	}
+	st->samples = BENCH_BLOCK;
+	st->bytes = 2.0 * sizeof(dtype);
+	return 0;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          RUN
+*******************************************************************************/
+static void run_push_for(bench_state_t* st, size_t calls)
+{
+	const size_t n = st->size;
+	dtype* arr = st->a;
+	size_t i;
+
+	for (i = 0; i < calls; i++)
+	{
+		fa_push_(arr, n, st->b[i & (BENCH_BLOCK - 1)]);
+	}
+	st->sink = arr[0];
+}
+
+static void run_push_memmove(bench_state_t* st, size_t calls)
+{
+	const size_t n = st->size;
+	dtype* arr = st->a;
+	size_t i;
+
+	for (i = 0; i < calls; i++)
+	{
+		fa_push(arr, n, st->b[i & (BENCH_BLOCK - 1)]);
+	}
+	st->sink = arr[0];
+}
+
+static void run_push_pidx(bench_state_t* st, size_t calls)
+{
+	const int n = (int)st->size;
+	dtype* arr = st->a;
+	pIdx idx = st->idx;
+	size_t i;
+
+	for (i = 0; i < calls; i++)
+	{
+		fa_fast_push_shift(arr, n, idx, st->b[i & (BENCH_BLOCK - 1)]);
+	}
+	st->idx = idx;
+	st->sink = arr[idx];
+}
+
+static void run_push_handle(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) fa_handle_push(st->fa, st->b[i & (BENCH_BLOCK - 1)]);
+	st->sink = fa_window(st->fa)[0];
+}
+
+static void run_push_handle_block(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) fa_handle_push_block(st->fa, st->b, BENCH_BLOCK);
+	st->sink = fa_window(st->fa)[0];
+}
+
+static void run_push_block(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) fa_fast_push_block(st->a, st->size, &st->idx, st->b, BENCH_BLOCK);
+	st->sink = st->a[st->idx];
+}
+
+static void run_push_spsc(bench_state_t* st, size_t calls)
+{
+	/* producer and consumer on one thread : cost of the atomics, not of contention */
+	const dtype* window;
+	size_t i;
+
+	for (i = 0; i < calls; i++)
+	{
+		spsc_push(st->spsc, st->b, BENCH_BLOCK);
+		if ((window = spsc_acquire(st->spsc)) != NULL)
+		{
+			st->sink = window[0];
+			spsc_release(st->spsc);
+		}
+	}
+}
+
+static void run_dot(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) st->sink = fast_fir_filtering(st->a, st->b, st->size, (pIdx)(i & 7));
+}
+
+static void run_dot_f32(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) st->sink = dot_f32((const f32_t*)st->ta, (const f32_t*)st->tb, st->size);
+}
+
+static void run_dot_q15(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) st->sink = (dtype)dot_q15((const q15_t*)st->ta, (const q15_t*)st->tb, st->size);
+}
+
+static void run_zeros(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) zeros(st->a, st->size);
+	st->sink = st->a[0];
+}
+
+static void run_ones(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) ones(st->a, st->size);
+	st->sink = st->a[0];
+}
+
+static void run_scaling(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) scaling(st->a, st->size, (i & 1) ? 2.0 : 0.5);
+	st->sink = st->a[0];
+}
+
+static void run_rands(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) rands(st->a, st->size, 0, 1);
+	st->sink = st->a[0];
+}
+
+static void run_sin(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) sin_(st->a, st->size, 440, 48000, 0);
+	st->sink = st->a[1];
+}
+
+static void run_expr(bench_state_t* st, size_t calls)
+{
+	/* scaling, noise, window, dot : one pass per step, or one fused pass */
+
+	dtype* tmp = (dtype*)st->ta;
+	size_t i, k;
+
+	for (i = 0; i < calls; i++)
+	{
+		if (st->arg & 1)
+		{
+			st->sink = expr_run(st->expr, st->a, st->a, st->size);
+			continue;
+		}
+		scaling(st->a, st->size, 0.5);
+		if (st->arg & 2)
+		{
+			noise_gaussian(st->noise, tmp, st->size, 0, 0.1);
+			for (k = 0; k < st->size; k++) st->a[k] += tmp[k];
+		}
+		for (k = 0; k < st->size; k++) st->a[k] *= st->b[k];
+		st->sink = dot_product(st->a, st->c, (pIdx)st->size);
+	}
+}
+
+static void run_dot_mt(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) st->sink = dot_product_mt(st->a, st->b, st->size);
+}
+
+static void run_zeros_mt(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) zeros_mt(st->a, st->size);
+	st->sink = st->a[0];
+}
+
+static void run_scaling_mt(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) scaling_mt(st->a, st->size, (i & 1) ? 2.0 : 0.5);
+	st->sink = st->a[0];
+}
+
+static void run_rands_mt(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) rands_mt(st->a, st->size, 0, 1, i);
+	st->sink = st->a[0];
+}
+
+static void run_sin_mt(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) sin_mt(st->a, st->size, 440, 48000, 0);
+	st->sink = st->a[1];
+}
+
+static void run_fast_sin(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) fast_sin(st->a, st->size, 440, 48000);
+	st->sink = st->a[1];
+}
+
+static void run_osc(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) osc_process(st->osc, st->a, st->size);
+	st->sink = st->a[1];
+}
+
+static void run_osc_bank(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++)
+	{
+		if (st->arg) osc_bank_mix(st->osc_bank, st->a, BENCH_BLOCK);
+		else osc_bank_process(st->osc_bank, st->a, BENCH_BLOCK);
+	}
+	st->sink = st->a[1];
+}
+
+static void run_stats(bench_state_t* st, size_t calls)
+{
+	const dtype* w;
+	dtype sum;
+	size_t i, j, k;
+
+	for (i = 0; i < calls; i++)
+	{
+		for (j = 0; j < BENCH_BLOCK; j++)
+		{
+			if (st->stats)
+			{
+				stats_push(st->stats, st->b[j]);
+				continue;
+			}
+			fa_handle_push(st->fa, st->b[j]); // what the running statistics replace
+			w = fa_window(st->fa);
+			for (k = 0, sum = 0; k < st->size; k++) sum += w[k];
+			st->sink = sum;
+		}
+	}
+	if (st->stats) st->sink = st->arg == STATS_MEDIAN ? stats_median(st->stats) : st->arg == STATS_MINMAX ? stats_max(st->stats) : stats_mean(st->stats);
+}
+
+static void run_noise(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++)
+	{
+		if (st->arg) noise_uniform(st->noise, st->a, st->size);
+		else noise_gaussian(st->noise, st->a, st->size, 0, 1);
+	}
+	st->sink = st->a[1];
+}
+
+static void run_fir(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) fir_process(st->fir, st->b, st->c, BENCH_BLOCK);
+	st->sink = st->c[0];
+}
+
+static void run_resample(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) resampler_process(st->rs, st->b, BENCH_BLOCK, st->c);
+	st->sink = st->c[0];
+}
+
+static void run_biquad(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) biquad_process(st->bq, st->a, st->a, st->size);
+	st->sink = st->a[0];
+}
+
+static void run_lms(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) st->sink = lms_process(st->lms, st->a, st->b, st->c, NULL, BENCH_BLOCK);
+}
+
+static void run_bank(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) bank_process(st->bank, st->a, st->b, st->c, NULL, BENCH_BLOCK);
+	st->sink = st->c[0];
+}
+
+static void run_fft(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++)
+	{
+		if (st->arg) rfft_forward(st->plan, st->a, st->b);
+		else fft_forward(st->plan, st->a, st->b);
+	}
+	st->sink = st->b[0];
+}
+
+static void run_autocor_direct(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) autocor_direct(st->b, st->a, (int)st->size, BENCH_LAG);
+	st->sink = st->b[0];
+}
+
+static void run_autocor_fft(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) autocor_fft(st->b, st->a, (int)st->size, BENCH_LAG);
+	st->sink = st->b[0];
+}
+
+static void run_autocor_stream(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) autocor_stream_push_block(st->ac, st->a, BENCH_BLOCK);
+	st->sink = autocor_stream_result(st->ac)[0];
+}
+
+static void run_xcorr_direct(bench_state_t* st, size_t calls)
+{
+	size_t i, j;
+
+	for (i = 0; i < calls; i++)
+	{
+		for (j = 0; j < BENCH_BLOCK; j++)
+		{
+			fa_handle_push(st->fa, st->b[j]);
+			st->c[j] = simd_dot(st->a, fa_window(st->fa), st->size);
+		}
+	}
+	st->sink = st->c[0];
+}
+
+static void run_xcorr_fft(bench_state_t* st, size_t calls)
+{
+	size_t i;
+
+	for (i = 0; i < calls; i++) xcorr_process(st->xc, st->b, st->c, BENCH_BLOCK);
+	st->sink = st->c[0];
+}
+
+static void run_xcorr_sdft(bench_state_t* st, size_t calls)
+{
+	size_t i, j;
+
+	for (i = 0; i < calls; i++)
+	{
+		for (j = 0; j < BENCH_BLOCK; j++)
+		{
+			sdft_push(st->sdft, st->b[j]);
+			st->c[j] = sdft_correlation(st->sdft);
+		}
+	}
+	st->sink = st->c[0];
+}
+
+/******************************************************************************
+**                          CASE TABLE
+*******************************************************************************/
+static const bench_case_t bench_cases[] = {
+	{ "push", "for", 0, 1 << 20, setup_push, run_push_for },
+	{ "push", "memmove", 0, 0, setup_push, run_push_memmove },
+	{ "push", "pidx", 0, 0, setup_push_fast, run_push_pidx },
+	{ "push", "handle", FA_MIRROR_COPY, 0, setup_push_handle, run_push_handle },
+	{ "push", "mapped", FA_MIRROR_MAPPED, 0, setup_push_handle, run_push_handle },
+	{ "push", "block", 0, 0, setup_push_block, run_push_block },
+	{ "push", "handle_block", FA_MIRROR_COPY, 0, setup_push_handle_block, run_push_handle_block },
+	{ "push", "mapped_block", FA_MIRROR_MAPPED, 0, setup_push_handle_block, run_push_handle_block },
+	{ "push", "spsc", 0, 0, setup_push_spsc, run_push_spsc },
+
+	{ "dot", "scalar", SIMD_SCALAR, 0, setup_dot, run_dot },
+	{ "dot", "sse2", SIMD_SSE2, 0, setup_dot, run_dot },
+	{ "dot", "avx2", SIMD_AVX2, 0, setup_dot, run_dot },
+	{ "dot", "avx512", SIMD_AVX512, 0, setup_dot, run_dot },
+	{ "dot", "f32", 0, 0, setup_dot_f32, run_dot_f32 },
+	{ "dot", "q15", 0, 0, setup_dot_q15, run_dot_q15 },
+	{ "dot", "mt", 0, 0, setup_dot_mt, run_dot_mt },
+	{ "expr", "passes", 0, 0, setup_expr, run_expr },
+	{ "expr", "fused", 1, 0, setup_expr, run_expr },
+	{ "expr", "passes_noise", 2, 0, setup_expr, run_expr },
+	{ "expr", "fused_noise", 3, 0, setup_expr, run_expr },
+
+	{ "generate", "zeros", 0, 0, setup_generate, run_zeros },
+	{ "generate", "ones", 0, 0, setup_generate, run_ones },
+	{ "generate", "scaling", 0, 0, setup_generate, run_scaling },
+	{ "generate", "rands", 0, 0, setup_generate, run_rands },
+	{ "generate", "sin", 0, 0, setup_generate, run_sin },
+	{ "generate", "fast_sin", 0, 0, setup_generate, run_fast_sin },
+	{ "generate", "zeros_mt", 0, 0, setup_generate, run_zeros_mt },
+	{ "generate", "scaling_mt", 0, 0, setup_generate, run_scaling_mt },
+	{ "generate", "rands_mt", 0, 0, setup_generate, run_rands_mt },
+	{ "generate", "sin_mt", 0, 0, setup_generate, run_sin_mt },
+	{ "stats", "rescan", 0, 65536, setup_stats, run_stats },
+	{ "stats", "moments", STATS_MOMENTS, 0, setup_stats, run_stats },
+	{ "stats", "minmax", STATS_MINMAX, 0, setup_stats, run_stats },
+	{ "stats", "median", STATS_MEDIAN, 0, setup_stats, run_stats },
+	{ "noise", "gaussian", 0, 0, setup_noise, run_noise },
+	{ "noise", "uniform", 1, 0, setup_noise, run_noise },
+	{ "osc", "process", 0, 0, setup_osc, run_osc },
+	{ "osc", "bank", 0, 4096, setup_osc_bank, run_osc_bank },
+	{ "osc", "mix", 1, 4096, setup_osc_bank, run_osc_bank },
+
+	{ "fir", "engine", 0, 65536, setup_fir, run_fir },
+	{ "resample", "decim6", BENCH_RATIO(1, 6), 65536, setup_resample, run_resample },
+	{ "resample", "interp6", BENCH_RATIO(6, 1), 65536, setup_resample, run_resample },
+	{ "resample", "2/3", BENCH_RATIO(2, 3), 65536, setup_resample, run_resample },
+	{ "biquad", "mono", 1, 65536, setup_biquad, run_biquad },
+	{ "biquad", "8ch", 8, 65536, setup_biquad, run_biquad },
+	{ "biquad", "16ch", BENCH_CHANNELS, 65536, setup_biquad, run_biquad },
+	{ "lms", "standard", LMS_STANDARD, 65536, setup_lms, run_lms },
+	{ "lms", "normalized", LMS_NORMALIZED, 65536, setup_lms, run_lms },
+	{ "lms", "leaky", LMS_LEAKY, 65536, setup_lms, run_lms },
+	{ "bank", "fir", BANK_FIR, 4096, setup_bank, run_bank },
+	{ "bank", "lms", BANK_LMS, 4096, setup_bank, run_bank },
+
+	{ "fft", "complex", 0, 0, setup_fft, run_fft },
+	{ "fft", "real", 1, 0, setup_fft, run_fft },
+	{ "autocor", "direct", 0, 0, setup_autocor, run_autocor_direct },
+	{ "autocor", "fft", 0, 0, setup_autocor, run_autocor_fft },
+	{ "autocor", "stream", 0, 65536, setup_autocor_stream, run_autocor_stream },
+	{ "xcorr", "direct", 0, 65536, setup_xcorr, run_xcorr_direct },
+	{ "xcorr", "fft", 1, 0, setup_xcorr, run_xcorr_fft },
+	{ "xcorr", "sdft", 2, 0, setup_xcorr, run_xcorr_sdft },
+};
+
+#define BENCH_N_CASES (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          MEASUREMENT
+*******************************************************************************/
+static int compare_double(const void* a, const void* b)
+{
+	const double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+static uint64_t bench_time(const bench_case_t* bc, bench_state_t* st, const size_t calls)
+{
+	const uint64_t start = time_now_ns();
+	bc->run(st, calls);
+	return time_now_ns() - start;
+}
+
+static int bench_measure(const bench_case_t* bc, bench_state_t* st, const bench_options_t* opt, bench_result_t* res)
+{
+	/*
+	Description
+	-	Doubles the calls per repetition until one repetition takes BENCH_REP_NS
+		(this is also the warm-up), runs one more repetition that is thrown away,
+		then times opt->reps repetitions or as many as fit in opt->budget_ns.
+	*/
+
+	double* ns;
+	size_t calls = 1, reps, r;
+	uint64_t t;
+	double sum = 0;
+
+	while ((t = bench_time(bc, st, calls)) < BENCH_REP_NS && calls < ((size_t)1 << 30)) calls *= 2;
+
+	reps = opt->reps;
+	if (t > 0 && (double)t * reps > opt->budget_ns) reps = (size_t)(opt->budget_ns / (double)t);
+	if (reps < 3) reps = 3;
+
+	if ((ns = (double*)malloc(sizeof(double) * reps)) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return -1;
+	}
+
+	bench_time(bc, st, calls);
+	for (r = 0; r < reps; r++)
+	{
+		ns[r] = (double)bench_time(bc, st, calls) / ((double)calls * st->samples);
+		sum += ns[r];
+	}
+	qsort(ns, reps, sizeof(double), compare_double);
+
+	res->reps = reps;
+	res->min = ns[0];
+	res->p50 = ns[reps / 2];
+	res->p99 = ns[(size_t)ceil(0.99 * reps) - 1];
+	res->mean = sum / reps;
+	res->gbps = st->bytes / res->p50; // bytes per ns == GB/s
+
+	free(ns);
+	return 0;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          REPORT
+*******************************************************************************/
+static void bench_header(const bench_options_t* opt)
+{
+	switch (opt->format)
+	{
+	case BENCH_CSV:
+		fprintf(opt->out, "kernel,variant,size,simd,ns_per_sample,gb_per_s,p50_ns,p99_ns,min_ns,mean_ns,reps\n");
+		break;
+	case BENCH_JSON:
+		break;
+	default:
+		fprintf(opt->out, "simd level : %s, times in ns/sample\n", simd_level_name(simd_level()));
+		fprintf(opt->out, "%-10s %-11s %10s %10s %12s %12s %12s %12s %6s\n",
+			"kernel", "variant", "size", "GB/s", "p50 ns", "p99 ns", "min ns", "mean ns", "reps");
+		break;
+	}
+}
+
+static void bench_report(const bench_options_t* opt, const bench_case_t* bc, const size_t size, const bench_result_t* res)
+{
+	const char* level = simd_level_name(simd_level());
+
+	switch (opt->format)
+	{
+	case BENCH_CSV:
+		fprintf(opt->out, "%s,%s,%zu,%s,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%zu\n",
+			bc->kernel, bc->variant, size, level, res->p50, res->gbps, res->p50, res->p99, res->min, res->mean, res->reps);
+		break;
+	case BENCH_JSON:
+		fprintf(opt->out, "{\"kernel\":\"%s\",\"variant\":\"%s\",\"size\":%zu,\"simd\":\"%s\",\"ns_per_sample\":%.6g,"
+			"\"gb_per_s\":%.6g,\"p50_ns\":%.6g,\"p99_ns\":%.6g,\"min_ns\":%.6g,\"mean_ns\":%.6g,\"reps\":%zu}\n",
+			bc->kernel, bc->variant, size, level, res->p50, res->gbps, res->p50, res->p99, res->min, res->mean, res->reps);
+		break;
+	default:
+		fprintf(opt->out, "%-10s %-11s %10zu %10.3f %12.4f %12.4f %12.4f %12.4f %6zu\n",
+			bc->kernel, bc->variant, size, res->gbps, res->p50, res->p99, res->min, res->mean, res->reps);
+		break;
+	}
+	fflush(opt->out);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          MAIN
+*******************************************************************************/
+static int bench_selected(const bench_options_t* opt, const bench_case_t* bc)
+{
+	char name[64];
+
+	if (opt->filter == NULL) return 1;
+	snprintf(name, sizeof(name), "%s/%s", bc->kernel, bc->variant);
+	return strstr(name, opt->filter) != NULL;
+}
+
+static int bench_parse_sizes(bench_options_t* opt, const char* list)
+{
+	char* end;
+	size_t n;
+
+	opt->n_sizes = 0;
+	while (*list && opt->n_sizes < (int)(sizeof(opt->sizes) / sizeof(opt->sizes[0])))
+	{
+		n = (size_t)strtoull(list, &end, 10);
+		if (end == list || n == 0) return -1;
+		opt->sizes[opt->n_sizes++] = n;
+		list = (*end == ',') ? end + 1 : end;
+	}
+	return opt->n_sizes > 0 ? 0 : -1;
+}
+
+static void bench_usage(void)
+{
+	fprintf(stderr, "usage : bench [--quick] [--sizes n,n,..] [--filter kernel[/variant]] [--reps n]\n"
+		"              [--budget ms] [--format text|csv|json] [--out file] [--list]\n");
+}
+
+int bench_main(int argc, char** argv)
+{
+	/*
+	Description
+	-	Runs every selected case over every size and writes one record per
+		(case, size). Cases that the cpu does not support or that fail to
+		allocate are skipped with a note on stderr.
+	*/
+
+	bench_options_t opt;
+	bench_state_t st;
+	bench_result_t res;
+	size_t c;
+	int i, list = 0;
+
+	memset(&opt, 0, sizeof(opt));
+	opt.reps = BENCH_DEFAULT_REPS;
+	opt.budget_ns = BENCH_DEFAULT_BUDGET * 1e6;
+	opt.format = BENCH_TEXT;
+	opt.out = stdout;
+	opt.n_sizes = sizeof(bench_default_sizes) / sizeof(bench_default_sizes[0]);
+	memcpy(opt.sizes, bench_default_sizes, sizeof(bench_default_sizes));
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--quick"))
+		{
+			opt.n_sizes = sizeof(bench_quick_sizes) / sizeof(bench_quick_sizes[0]);
+			memcpy(opt.sizes, bench_quick_sizes, sizeof(bench_quick_sizes));
+			opt.reps = 20;
+		}
+		else if (!strcmp(argv[i], "--sizes") && i + 1 < argc)
+		{
+			if (bench_parse_sizes(&opt, argv[++i]) < 0) { bench_usage(); return -1; }
+		}
+		else if (!strcmp(argv[i], "--filter") && i + 1 < argc) opt.filter = argv[++i];
+		else if (!strcmp(argv[i], "--reps") && i + 1 < argc) opt.reps = (size_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--budget") && i + 1 < argc) opt.budget_ns = atof(argv[++i]) * 1e6;
+		else if (!strcmp(argv[i], "--format") && i + 1 < argc)
+		{
+			i++;
+			if (!strcmp(argv[i], "csv")) opt.format = BENCH_CSV;
+			else if (!strcmp(argv[i], "json")) opt.format = BENCH_JSON;
+			else if (!strcmp(argv[i], "text")) opt.format = BENCH_TEXT;
+			else { bench_usage(); return -1; }
+		}
+		else if (!strcmp(argv[i], "--out") && i + 1 < argc)
+		{
+			if ((opt.out = fopen(argv[++i], "w")) == NULL)
+			{
+				fprintf(stderr, "File Open Error!\n");
+				return -1;
+			}
+		}
+		else if (!strcmp(argv[i], "--list")) list = 1;
+		else { bench_usage(); return -1; }
+	}
+	if (opt.reps < 3) opt.reps = 3;
+
+	if (list)
+	{
+		for (c = 0; c < BENCH_N_CASES; c++) printf("%s/%s\n", bench_cases[c].kernel, bench_cases[c].variant);
+		return 0;
+	}
+
+	bench_header(&opt);
+
+	for (c = 0; c < BENCH_N_CASES; c++)
+	{
+		if (!bench_selected(&opt, &bench_cases[c])) continue;
+
+		for (i = 0; i < opt.n_sizes; i++)
+		{
+			if (bench_cases[c].max_size && opt.sizes[i] > bench_cases[c].max_size) continue;
+
+			memset(&st, 0, sizeof(st));
+			st.size = opt.sizes[i];
+			st.arg = bench_cases[c].arg;
+
+			if (bench_cases[c].setup(&st) < 0)
+				fprintf(stderr, "bench : %s/%s size %zu skipped\n", bench_cases[c].kernel, bench_cases[c].variant, st.size);
+			else if (bench_measure(&bench_cases[c], &st, &opt, &res) == 0)
+				bench_report(&opt, &bench_cases[c], st.size, &res);
+
+			bench_teardown(&st);
+		}
+	}
+
+	if (opt.out != stdout) fclose(opt.out);
+	return 0;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include "fast_array.h"
+#include "util.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          BENCHMARK HARNESS
+*******************************************************************************/
+/*
+* Every case is one (kernel, variant) pair run over a sweep of sizes.
+* A case is calibrated until one repetition takes BENCH_REP_NS, then
+* timed for a number of repetitions; the per repetition ns/sample values
+* give p50 / p99 / min / mean. GB/s is computed from the p50 time and
+* the bytes the kernel moves per sample.
+*
+* usage : bench [--quick] [--sizes n,n,..] [--filter kernel] [--reps n]
+*               [--budget ms] [--format text|csv|json] [--out file] [--list]
+*/
+#define BENCH_REP_NS 1000000ULL		// target time of one repetition
+#define BENCH_DEFAULT_REPS 50
+#define BENCH_DEFAULT_BUDGET 250	// ms per case and size
+#define BENCH_BLOCK 256				// samples per call of the block kernels
+#define BENCH_CHANNELS 16			// channels of the bank cases
+#define BENCH_LAG 64				// lag of the autocorrelation cases
+#define BENCH_BINS 8				// tracked bins of the sliding dft case
+#define BENCH_SECTIONS 4			// sections of the biquad cases
+#define BENCH_RATIO(up, down) ((up) * 256 + (down))	// arg of the resampler cases
+
+#define BENCH_TEXT 0
+#define BENCH_CSV 1
+#define BENCH_JSON 2
+
+typedef struct _bench_state
+{
+	size_t size;			// window length, transform length or tap count
+	size_t samples;			// samples per call, set by setup
+	double bytes;			// bytes moved per sample, set by setup
+	int arg;				// variant parameter of the case
+	dtype* a, * b, * c;		// work buffers
+	void* ta, * tb;			// typed work buffers
+	pIdx idx;
+	fa_handle fa;
+	fir_handle fir;
+	resampler_handle rs;
+	biquad_handle bq;
+	stats_handle stats;
+	lms_handle lms;
+	bank_handle bank;
+	fft_plan plan;
+	autocor_handle ac;
+	sdft_handle sdft;
+	xcorr_handle xc;
+	expr_handle expr;
+	osc_handle osc;
+	osc_bank_handle osc_bank;
+	noise_handle noise;
+	spsc_handle spsc;
+	volatile dtype sink;	// keeps results alive
+} bench_state_t;
+
+typedef struct _bench_case
+{
+	const char* kernel;
+	const char* variant;
+	int arg;						// copied to bench_state_t.arg
+	size_t max_size;				// sizes above are skipped, 0 : no limit
+	int (*setup)(bench_state_t* st);	// -1 : case not available
+	void (*run)(bench_state_t* st, size_t calls);
+} bench_case_t;
+
+typedef struct _bench_result
+{
+	size_t reps;
+	double p50, p99, min, mean;		// ns/sample
+	double gbps;					// at p50
+} bench_result_t;
+
+typedef struct _bench_options
+{
+	size_t sizes[32];
+	int n_sizes;
+	const char* filter;		// substring of "kernel/variant", NULL : all
+	size_t reps;
+	double budget_ns;
+	int format;
+	FILE* out;
+} bench_options_t;
+
+int bench_main(int argc, char** argv);
+
+#endif
@@ -1,38 +1,59 @@
-#pragma once
-
-#ifndef __COMMON_H__
-#define __COMMON_H__
-
-#include <stdio.h>
-#include <stdlib.h>
-
-#include <string.h>
-
-#include <stdarg.h>
-
-#include <time.h>
-#include <math.h>
-
-#define PI 3.141592  //3.14159265359f
-#define PI2 6.283185 //6.28318530718f
-
-#define PI_M ((4) * atan(1));
-#define DEG2RAD(x) ((x)*((PI)/(180)))
-
-#define DTYPE double
-#define MACRO_TO_STRING(x) #x
-
-typedef char* string_dir;
-typedef char* type_t;
-
-typedef DTYPE dtype; // for general programming
-
-typedef int pIdx; // pointer index
-
-
-#ifdef _GCC_COMPILER
-// no use msvc compiler
-typedef unsigned int size_t;
-#endif
-
+#pragma once
+
+#ifndef __COMMON_H__
+#define __COMMON_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include <stdarg.h>
+
+#include <time.h>
+#include <math.h>
+#include <stdint.h>
+
+#define PI 3.141592  //3.14159265359f
+#define PI2 6.283185 //6.28318530718f
+
+#define PI_M ((4) * atan(1));
+#define DEG2RAD(x) ((x)*((PI)/(180)))
+
+#define DTYPE double
+#define MACRO_TO_STRING(x) #x
+
+typedef char* string_dir;
+typedef char* type_t;
+
+typedef DTYPE dtype; // for general programming
+
+typedef int pIdx; // pointer index
+
+/* element types of the typed kernels (typed.h), dtype stays the default */
+typedef float f32_t;
+typedef double f64_t;
+typedef int16_t q15_t; // 1.15 fixed point, also used for int16 samples
+typedef int32_t q31_t; // 1.31 fixed point, also used for int32 samples
+
+typedef enum _elem_t
+{
+	ELEM_UNKNOWN = -1,
+	ELEM_F64 = 0,
+	ELEM_F32,
+	ELEM_Q15,
+	ELEM_Q31
+} elem_t;
+
+#define FA_ALIGNMENT 64 // cache line size, alignment of fast array storage
+
+/* per kernel profiling counters and report (prof.h), off by default : define here or pass -DFA_PROFILE */
+// #define FA_PROFILE
+
+
+#ifdef _GCC_COMPILER
+// no use msvc compiler
+typedef unsigned int size_t;
+#endif
+
 #endif
\ No newline at end of file
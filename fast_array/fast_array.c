@@ -1,553 +1,4085 @@
-/**
-* @ author : junyeong heo
-*
-\brief
-** These functions are the data structure API
-** of the high-speed insertion array.
-** The time complexity of the stack insertion algorithm of
-** the existing array is O(n), but this array is O(1).
-*/
-
-#include "fast_array.h"
-
-// math api
-float gaussian_random(float average, float stdev)
-{
-	float v1, v2, s, temp;
-
-	do {
-		v1 = 2 * ((float)rand() / RAND_MAX) - 1;      // range = [-1.0, 1.0]
-		v2 = 2 * ((float)rand() / RAND_MAX) - 1;      // range = [-1.0, 1.0]
-		s = v1 * v1 + v2 * v2;
-	} while (s >= 1 || s == 0);
-
-	s = sqrt((-2 * log(s)) / s);
-
-	temp = v1 * s;
-	temp = (stdev * temp) + average;
-
-	return temp;
-}
-
-// Functions Implementation
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          UTIL FUNCTIONS of ARRAY
-*******************************************************************************/
-void zeros(dtype* arr, const size_t size)
-{
-	int i; for (i = 0; i < size; i++) arr[i] = 0;
-}
-void zeros_pidx(dtype* arr, const size_t size, pIdx idx)
-{
-	int i; for (i = idx; i < idx + size; i++) arr[i] = 0;
-}
-void ones(dtype* arr, const size_t size)
-{
-	int i; for (i = 0; i < size; i++) arr[i] = 1;
-}
-void ones_pidx(dtype* arr, const size_t size, pIdx idx)
-{
-	int i; for (i = idx; i < idx + size; i++) arr[i] = 1;
-}
-void rands(dtype* arr, const size_t size, float average, float stdev)
-{
-	int i; for (i = 0; i < size; i++) arr[i] = gaussian_random(average, stdev);
-}
-void rands_pidx(dtype* arr, const size_t size, float average, float stdev, pIdx idx)
-{
-	int i; for (i = idx; i < idx + size; i++) arr[i] = gaussian_random(average, stdev);
-}
-void sin_(dtype* arr, const size_t size, float f0, float fs, float phase)
-{
-	int i; for (i = 0; i < size; i++) arr[i] = (dtype)sin(PI2 * (f0 / fs) * i + DEG2RAD(phase));
-}
-void sin_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx)
-{
-	int i; for (i = idx; i < idx + size; i++) arr[i] = (dtype)sin(PI2 * (f0 / fs) * i + DEG2RAD(phase));
-}
-void cos_(dtype* arr, const size_t size, float f0, float fs, float phase)
-{
-	int i; for (i = 0; i < size; i++) arr[i] = (dtype)cos(PI2 * (f0 / fs) * i + DEG2RAD(phase));
-}
-void cos_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx)
-{
-	int i; for (i = idx; i < idx + size; i++) arr[i] = (dtype)cos(PI2 * (f0 / fs) * i + DEG2RAD(phase));
-}
-void scaling(dtype* arr, const size_t size, dtype scailing_factor)
-{
-	int i; for (i = 0; i < size; i++) arr[i] *= scailing_factor;
-}
-void scaling_pidx(dtype* arr, const size_t size, dtype scailing_factor, pIdx idx)
-{
-	int i; for (i = idx; i < idx + size; i++) arr[i] *= scailing_factor;
-}
-
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          FAST SIGNAL GENERATION
-*******************************************************************************/
-void fast_sin(dtype* arr, const size_t size, float f0, float fs)
-{
-	/*
-	% init
-		a1 = fnd_amp * cos(2 * pi * fnd_freq * (1 / sampling_rate));
-		b0 = fnd_amp * sin(2 * pi * fnd_freq * (1 / sampling_rate));
-
-		qn1 = 1; qn2 = 0;
-
-		for n = 1 : length(t),
-			cos_signal(n) = qn1 - a1 * qn2; % data push
-			sin_signal(n) = b0 * qn2;
-
-		qn0 = 2 * a1 * qn1 - qn2; % q(n) = a1 * qn(n - 1) - q(n - 2)
-		qn2 = qn1;
-		qn1 = qn0;
-	end
-	*/
-	dtype a1 = cos(PI2 * f0 / fs), b0 = sin(PI2 * f0 / fs);
-	dtype qn0, qn1 = 1, qn2 = 0;
-	int i;
-
-	for (i = 0; i < size; i++)
-	{
-		qn0 = 2 * a1 * qn1 - qn2;
-		qn2 = qn1;
-		qn1 = qn0;
-
-		arr[i] = b0 * qn2;
-	}
-
-	return;
-}
-void fast_cos(dtype* arr, const size_t size, float f0, float fs)
-{
-	/*
-	% init
-		a1 = fnd_amp * cos(2 * pi * fnd_freq * (1 / sampling_rate));
-		b0 = fnd_amp * sin(2 * pi * fnd_freq * (1 / sampling_rate));
-
-		qn1 = 1; qn2 = 0;
-
-		for n = 1 : length(t),
-			cos_signal(n) = qn1 - a1 * qn2; % data push
-			sin_signal(n) = b0 * qn2;
-
-		qn0 = 2 * a1 * qn1 - qn2; % q(n) = a1 * qn(n - 1) - q(n - 2)
-		qn2 = qn1;
-		qn1 = qn0;
-	end
-	*/
-
-	dtype a1 = cos(PI2 * f0 / fs), b0 = sin(PI2 * f0 / fs);
-	dtype qn0, qn1 = 1, qn2 = 0;
-	int i;
-
-	for (i = 0; i < size; i++)
-	{
-		qn0 = 2 * a1 * qn1 - qn2;
-		qn2 = qn1;
-		qn1 = qn0;
-
-		arr[i] = qn1 - a1 * qn2;
-	}
-
-	return;
-}
-void fast_sin_pidx(dtype* arr, const size_t size, float f0, float fs, pIdx idx)
-{
-	/*
-	% init
-		a1 = fnd_amp * cos(2 * pi * fnd_freq * (1 / sampling_rate));
-		b0 = fnd_amp * sin(2 * pi * fnd_freq * (1 / sampling_rate));
-
-		qn1 = 1; qn2 = 0;
-
-		for n = 1 : length(t),
-			cos_signal(n) = qn1 - a1 * qn2; % data push
-			sin_signal(n) = b0 * qn2;
-
-		qn0 = 2 * a1 * qn1 - qn2; % q(n) = a1 * qn(n - 1) - q(n - 2)
-		qn2 = qn1;
-		qn1 = qn0;
-	end
-	*/
-	dtype a1 = cos(PI2 * f0 / fs), b0 = sin(PI2 * f0 / fs);
-	dtype qn0, qn1 = 1, qn2 = 0;
-	int i;
-
-	for (i = idx; i < idx + size; i++)
-	{
-		qn0 = 2 * a1 * qn1 - qn2;
-		qn2 = qn1;
-		qn1 = qn0;
-
-		arr[i] = b0 * qn2;
-	}
-
-	return;
-}
-void fast_cos_pidx(dtype* arr, const size_t size, float f0, float fs, pIdx idx)
-{
-	/*
-	% init
-		a1 = fnd_amp * cos(2 * pi * fnd_freq * (1 / sampling_rate));
-		b0 = fnd_amp * sin(2 * pi * fnd_freq * (1 / sampling_rate));
-
-		qn1 = 1; qn2 = 0;
-
-		for n = 1 : length(t),
-			cos_signal(n) = qn1 - a1 * qn2; % data push
-			sin_signal(n) = b0 * qn2;
-
-		qn0 = 2 * a1 * qn1 - qn2; % q(n) = a1 * qn(n - 1) - q(n - 2)
-		qn2 = qn1;
-		qn1 = qn0;
-	end
-	*/
-
-	dtype a1 = cos(PI2 * f0 / fs), b0 = sin(PI2 * f0 / fs);
-	dtype qn0, qn1 = 1, qn2 = 0;
-	int i;
-	for (i = idx; i < size + idx; i++)
-	{
-		qn0 = 2 * a1 * qn1 - qn2;
-		qn2 = qn1;
-		qn1 = qn0;
-
-		arr[i] = qn1 - a1 * qn2;
-	}
-	return;
-}
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          DOT PRODUCTS
-*******************************************************************************/
-dtype dot_product(dtype* a, dtype* b, pIdx size)
-{
-	dtype sum = 0; int i;
-	for (i = 0; i < size; i++)  sum += a[i] * b[i];
-	return sum;
-}
-dtype dot_product_pidx(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx)
-{
-	dtype sum = 0; int i;
-	for (i = ptr_idx; i < ptr_idx + size; i++) sum += arr1[i] * arr2[i];
-	return sum;
-}
-dtype dot_product_pidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx)
-{
-	dtype sum = 0; int i;
-	for (i = ptr_idx; i < ptr_idx + size; i++)
-	{
-		sum += arr1[i] * arr2[i];
-		printf("arr[%d] = %.4f * arr2[%d]= %.4f = %.4f \n", i, arr1[i], i, arr2[i], sum);
-	}
-	return sum;
-}
-dtype dot_product_dpidx(dtype* arr1, dtype* arr2, const  size_t size, pIdx ptr_idx1, pIdx ptr_idx2)
-{
-	dtype sum = 0; int i, j;
-	for (i = ptr_idx1, j = ptr_idx2; i < ptr_idx1 + size; i++, j++) sum += arr1[i] * arr2[j];
-	return sum;
-}
-dtype dot_product_dpidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2)
-{
-	dtype sum = 0; int i, j;
-	for (i = ptr_idx1, j = ptr_idx2; i < ptr_idx1 + size; i++, j++)
-	{
-		sum += arr1[i] * arr2[j];
-		printf("arr[%d] = %.4f * arr2[%d]= %.4f = %.4f \n", i, arr1[i], i, arr2[j], sum);
-	}
-	return sum;
-}
-dtype dot_product4(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2)
-{
-	dtype sum = 0; int i, j;
-	for (i = ptr_idx1, j = ptr_idx2; i < ptr_idx1 + size; i++, j++) sum += arr2[i] * arr1[j];
-	return sum;
-}
-
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          PRINT ARRAY
-*******************************************************************************/
-void print_arr1d(dtype* arr, const size_t size, type_t data_type)
-{
-	/*
-	* Arguments
-	- r : Pointer to output array of autocorrelation of length audocor_len.
-	- x : Pointer to input array of length nx+nr. Input data must be padded with nr consecutive zeros at the beginning.
-	- autocor_len : Length of autocorrelation vector
-	- lag : Length of lag
-
-	Description
-	-	This routine performs the autocorrelation of the input array x.
-		It is assumed that the length of the input array, x, is a multiple of 2
-		and the length of the output array, r, is a multiple of 4.
-		The assembly routine computes 4 output samples at a time.
-		It is assumed that input vector x is padded with nr no of zeros in the beginning.
-	*/
-
-	char* fn = NULL;
-	int i;
-
-	// data type
-	if (!(strcmp(data_type, "int") && strcmp(data_type, "int32") && strcmp(data_type, "signed int") && strcmp(data_type, "signed int32")))
-		fn = "%d ";
-
-	else if (!(strcmp(data_type, "uint") && strcmp(data_type, "uint32") && strcmp(data_type, "unsigned int") && strcmp(data_type, "unsigned int32")))
-		fn = "%u ";
-
-	else if (!(strcmp(data_type, "short") && strcmp(data_type, "int16") && strcmp(data_type, "signed short") && strcmp(data_type, "signed int16")))
-		fn = "%d ";
-
-	else if (!(strcmp(data_type, "ushort") && strcmp(data_type, "uint16") && strcmp(data_type, "unsigned short") && strcmp(data_type, "unsigned int16")))
-		fn = "%u ";
-
-	else if (!(strcmp(data_type, "float") && strcmp(data_type, "float32") && strcmp(data_type, "signed float") && strcmp(data_type, "signed float32")))
-		fn = "%.3f ";
-
-	else if (!(strcmp(data_type, "double") && strcmp(data_type, "float64") && strcmp(data_type, "signed double") && strcmp(data_type, "signed float64")))
-		fn = "%.4lf ";
-
-	else
-	{
-		fprintf(stderr, "error : \"(%s)\" is Unsuppored data type \n", data_type);
-		return;
-	}
-
-	for (i = 0; i < size; i++) fprintf(stdout, fn, arr[i]);
-	printf("\n");
-
-	return;
-}
-
-void print_arr1d_pidx(dtype* arr, const size_t size, type_t data_type, pIdx ptr_idx)
-{
-	char* fn = NULL;
-	int i;
-
-	// data type
-	if (!(strcmp(data_type, "int") && strcmp(data_type, "int32") && strcmp(data_type, "signed int") && strcmp(data_type, "signed int32")))
-		fn = "%d ";
-
-	else if (!(strcmp(data_type, "uint") && strcmp(data_type, "uint32") && strcmp(data_type, "unsigned int") && strcmp(data_type, "unsigned int32")))
-		fn = "%u ";
-
-	else if (!(strcmp(data_type, "short") && strcmp(data_type, "int16") && strcmp(data_type, "signed short") && strcmp(data_type, "signed int16")))
-		fn = "%d ";
-
-	else if (!(strcmp(data_type, "ushort") && strcmp(data_type, "uint16") && strcmp(data_type, "unsigned short") && strcmp(data_type, "unsigned int16")))
-		fn = "%u ";
-
-	else if (!(strcmp(data_type, "float") && strcmp(data_type, "float32") && strcmp(data_type, "signed float") && strcmp(data_type, "signed float32")))
-		fn = "%.3f ";
-
-	else if (!(strcmp(data_type, "double") && strcmp(data_type, "float64") && strcmp(data_type, "signed double") && strcmp(data_type, "signed float64")))
-		fn = "%.4lf ";
-
-	else
-	{
-		fprintf(stderr, "error : \"(%s)\" is Unsuppored data type \n", data_type);
-		return;
-	}
-
-	for (i = ptr_idx; i < ptr_idx + size; i++) fprintf(stdout, fn, arr[i]);
-	printf("\n");
-
-	return;
-}
-
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          ADAPTIVE ALGORITHM
-*******************************************************************************/
-dtype least_mean_square(dtype* x, dtype* h, dtype* desired, dtype* y, dtype adapt_rate, dtype error,
-	const int n_coeffecients, const int n_output_samples)
-{
-	/*
-	* Arguments
-	- x : Pointer to input samples
-	- h : Pointer to the coefficient array
-	- desired : Pointer to the desired output array
-	- y : Pointer to filtered output array
-	- adapt_rate : Adaptation rate error Initial error (mu)
-	- n_coeffocients : Number of coefficients
-	- n_output_samples : Number of output samples
-
-	Description
-	-	The least_mean_square implements an LMS adaptive filter.
-		Given an actual input signal and a desired input signal,
-		the filter produces an output signal, the final coefficient values,
-		and returns the final output error signal.
-	*/
-
-	int i, j;
-	dtype sum = 0.0f;
-	for (i = 0; i < n_output_samples; i++)
-	{
-		for (j = 0; j < n_coeffecients; j++) h[j] = h[j] + (adapt_rate * error * x[i + j - 1]); // w(n+1) = w(n) + \mu*x(n)*e(n)
-		sum = 0.0f;
-		for (j = 0; j < n_coeffecients; j++) sum += h[j] * x[i + j];
-		y[i] = sum;
-		error = desired[i] - sum;
-		printf("error : %f \n", error);
-	}
-	return error;
-}
-
-dtype fast_least_mean_square(dtype* x, dtype* h, dtype* desired, dtype* y, dtype adapt_rate, dtype error,
-	const int n_coeffecients, const int n_output_samples, pIdx x_idx, pIdx h_idx, pIdx d_idx, pIdx y_idx)
-{
-	/*
-	* Arguments
-	- x : Pointer to input samples
-	- h : Pointer to the coefficient array
-	- desired : Pointer to the desired output array
-	- y : Pointer to filtered output array
-	- adapt_rate : Adaptation rate error Initial error
-	- n_coeffocients : Number of coefficients
-	- n_output_samples : Number of output samples
-	- x_idx : Index of fast array x
-	- h_idx : Index of fast array h
-	- d_idx : Index of fast array d
-	- y_idx : Index of fast array y
-
-	Description
-	-	The least_mean_square implements an LMS adaptive filter.
-		Given an actual input signal and a desired input signal,
-		the filter produces an output signal, the final coefficient values,
-		and returns the final output error signal.
-	*/
-
-	int i, j;
-	dtype sum = 0.0f;
-	for (i = y_idx; i < n_output_samples + y_idx; i++)
-	{
-		for (j = h_idx; j < n_coeffecients + h_idx; j++) h[j] = h[j] + (adapt_rate * error * x[i + j - 1]); // w(n+1) = w(n) + \mu*x(n)*e(n)
-		for (j = h_idx; j < n_coeffecients + h_idx; j++) sum += h[j] * x[i + j];
-		y[i] = sum;
-		error = desired[i] - sum;
-	}
-	return error;
-}
-
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          OPEARTION
-*******************************************************************************/
-void autocor(dtype* __restrict r, const dtype* __restrict x, const int autocor_len, const int lag)
-{
-	/*
-	* Arguments
-	- r : Pointer to output array of autocorrelation of length audocor_len.
-	- x : Pointer to input array of length nx+nr. Input data must be padded with nr consecutive zeros at the beginning.
-	- autocor_len : Length of autocorrelation vector
-	- lag : Length of lag
-
-	Description
-	-	This routine performs the autocorrelation of the input array x.
-		It is assumed that the length of the input array, x, is a multiple of 2
-		and the length of the output array, r, is a multiple of 4.
-		The assembly routine computes 4 output samples at a time.
-		It is assumed that input vector x is padded with nr no of zeros in the beginning.
-	*/
-
-	int i, k;
-	dtype sum;
-	for (i = 0; i < lag; i++)
-	{
-		sum = 0;
-		for (k = lag; k < autocor_len + lag; k++) sum += x[k] * x[k - i];
-		r[i] = sum;
-	}
-}
-
-void fast_autocor(dtype* __restrict r, const dtype* __restrict x, const int autocor_len, const int lag, pIdx r_idx, pIdx x_idx)
-{
-	/*
-	* Arguments
-	- r : Pointer to output array of autocorrelation of length audocor_len.
-	- x : Pointer to input array of length nx+nr. Input data must be padded with nr consecutive zeros at the beginning.
-	- autocor_len : Length of autocorrelation vector
-	- lag : Length of lag
-
-	Description
-	-	This routine performs the autocorrelation of the input array x.
-		It is assumed that the length of the input array, x, is a multiple of 2
-		and the length of the output array, r, is a multiple of 4.
-		The assembly routine computes 4 output samples at a time.
-		It is assumed that input vector x is padded with nr no of zeros in the beginning.
-	*/
-	int i, k;
-	dtype sum;
-	for (i = 0; i < lag; i++)
-	{
-		sum = 0;
-		for (k = lag; k < autocor_len + lag; k++) sum += x[k] * x[k - i];
-		r[i] = sum;
-	}
-}
-
-dtype fir_filtering(dtype* x1, dtype* x2, const size_t size)
-{
-	/*
-	* Arguments
-	- x1 : Input array 1
-	- x2 : Input array 2
-	- size : Length of x1, x2 array
-
-	Description
-	-	This routine performs the fir filtering of the input array x1 and x2
-	*/
-
-	dtype sum = 0; int i;
-	for (i = 0; i < size; i++)  sum += x1[i] * x2[i];
-	return sum;
-}
-
-dtype fast_fir_filtering(dtype* x1, dtype* x2, const size_t size, pIdx idx)
-{
-	/*
-	* Arguments
-	- x1 : Input fast array 1
-	- x2 : Input fast array 2
-	- size : Length of x1, x2 array
-
-	Description
-	-	This routine performs the fir filtering of the input array x1 and x2
-		using fast array
-	*/
-
-	dtype sum = 0; int i;
-	for (i = idx; i < idx + size; i++)  sum += x1[i] * x2[i];
-	return sum;
-}
-
-dtype fast_fir_filtering_dpidx(dtype* x1, dtype* x2, const  size_t size, pIdx idx1, pIdx idx2)
-{
-	/*
-	* Arguments
-	- x1 : Input fast array 1
-	- x2 : Input fast array 2
-	- size : Length of x1, x2 array
-	- idx1 : Pointer index of x1
-	- idx2 : pointer index of x2
-
-	Description
-	-	This routine performs the fir filtering of the input array x1 and x2
-		using fast array
-
-	Equation
-	-	result = x1(idx1)*x2(idx2) + x1(idx1 + 1)*x2(idx2 + 1) + ... + x1(idx1 + L - 1)*x2(idx2 + L - 1)
-	*/
-	dtype sum = 0; int i, j;
-	for (i = idx1, j = idx2; i < idx1 + size; i++, j++) sum += x1[i] * x2[j];
-	return sum;
-}
-
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          FFT(FAST FOURIER TRANSFORM)
-*******************************************************************************/
+/**
+* @ author : junyeong heo
+*
+\brief
+** These functions are the data structure API
+** of the high-speed insertion array.
+** The time complexity of the stack insertion algorithm of
+** the existing array is O(n), but this array is O(1).
+*/
+
+#ifdef __linux__
+#define _GNU_SOURCE // memfd_create
+#endif
+
+#include "fast_array.h"
+
+#ifdef _MSC_VER
+#include <malloc.h> // _aligned_malloc
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// math api
+float gaussian_random(float average, float stdev)
+{
+	/* one sample of the calling thread's noise stream, computed in double */
+	return (float)(average + stdev * noise_gaussian1(noise_thread()));
+}
+
+// Functions Implementation
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          UTIL FUNCTIONS of ARRAY
+*******************************************************************************/
+void zeros(dtype* arr, const size_t size)
+{
+	int i; for (i = 0; i < size; i++) arr[i] = 0;
+}
+void zeros_pidx(dtype* arr, const size_t size, pIdx idx)
+{
+	int i; for (i = idx; i < idx + size; i++) arr[i] = 0;
+}
+void ones(dtype* arr, const size_t size)
+{
+	int i; for (i = 0; i < size; i++) arr[i] = 1;
+}
+void ones_pidx(dtype* arr, const size_t size, pIdx idx)
+{
+	int i; for (i = idx; i < idx + size; i++) arr[i] = 1;
+}
+void rands(dtype* arr, const size_t size, float average, float stdev)
+{
+	noise_gaussian(noise_thread(), arr, size, average, stdev);
+}
+void rands_pidx(dtype* arr, const size_t size, float average, float stdev, pIdx idx)
+{
+	noise_gaussian(noise_thread(), arr + idx, size, average, stdev);
+}
+void sin_(dtype* arr, const size_t size, float f0, float fs, float phase)
+{
+	int i; for (i = 0; i < size; i++) arr[i] = (dtype)sin(PI2 * (f0 / fs) * i + DEG2RAD(phase));
+}
+void sin_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx)
+{
+	int i; for (i = idx; i < idx + size; i++) arr[i] = (dtype)sin(PI2 * (f0 / fs) * i + DEG2RAD(phase));
+}
+void cos_(dtype* arr, const size_t size, float f0, float fs, float phase)
+{
+	int i; for (i = 0; i < size; i++) arr[i] = (dtype)cos(PI2 * (f0 / fs) * i + DEG2RAD(phase));
+}
+void cos_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx)
+{
+	int i; for (i = idx; i < idx + size; i++) arr[i] = (dtype)cos(PI2 * (f0 / fs) * i + DEG2RAD(phase));
+}
+void scaling(dtype* arr, const size_t size, dtype scailing_factor)
+{
+	int i; for (i = 0; i < size; i++) arr[i] *= scailing_factor;
+}
+void scaling_pidx(dtype* arr, const size_t size, dtype scailing_factor, pIdx idx)
+{
+	int i; for (i = idx; i < idx + size; i++) arr[i] *= scailing_factor;
+}
+
+void zeros_fa(fa_handle fa)
+{
+	zeros(fa->ptr, fa->size + fa->mirror);
+}
+void ones_fa(fa_handle fa)
+{
+	ones(fa->ptr, fa->size + fa->mirror);
+}
+void rands_fa(fa_handle fa, float average, float stdev)
+{
+	rands(fa_window(fa), fa->size, average, stdev); fa_sync_mirror(fa);
+}
+void sin_fa(fa_handle fa, float f0, float fs, float phase)
+{
+	sin_(fa_window(fa), fa->size, f0, fs, phase); fa_sync_mirror(fa);
+}
+void cos_fa(fa_handle fa, float f0, float fs, float phase)
+{
+	cos_(fa_window(fa), fa->size, f0, fs, phase); fa_sync_mirror(fa);
+}
+void scaling_fa(fa_handle fa, dtype scailing_factor)
+{
+	scaling(fa->ptr, fa->size + fa->mirror, scailing_factor); // each sample once
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          BLOCK PUSH
+*******************************************************************************/
+static void push_block_mirrored(dtype* ptr, const size_t size, const size_t mirror, const size_t new_idx, const dtype* block, const size_t n)
+{
+	/*
+	* block is written newest-first to ptr[new_idx .. new_idx + n),
+	* which is contiguous because new_idx < size and n <= size.
+	* The written span is then copied to the other half in at most two memcpy,
+	* unless the halves are double mapped (mirror == 0).
+	*/
+
+	dtype* dst = ptr + new_idx;
+	size_t i, end = new_idx + n;
+
+	for (i = 0; i < n; i++) dst[i] = block[n - 1 - i];
+	if (mirror == 0) return;
+
+	if (end <= size)
+	{
+		memcpy(ptr + new_idx + size, ptr + new_idx, sizeof(dtype) * n);
+	}
+	else
+	{
+		memcpy(ptr + new_idx + size, ptr + new_idx, sizeof(dtype) * (size - new_idx));
+		memcpy(ptr, ptr + size, sizeof(dtype) * (end - size));
+	}
+}
+
+void push_block_pidx(dtype* ptr, const size_t size, pIdx* ptr_idx, const dtype* block, const size_t n)
+{
+	/*
+	* Arguments
+	- ptr : Fast array of length 2 * size
+	- size : Length of the fast array window
+	- ptr_idx : Pointer index, updated to the newest sample
+	- block : Samples to push, block[0] is the oldest
+	- n : Number of samples in block
+
+	Description
+	-	Same result as calling push_using_pidx for block[0] ... block[n - 1],
+		but both mirror halves are written with bulk copies.
+		If n > size only the last size samples are kept.
+	*/
+
+	size_t m = n, new_idx;
+	PROF_BEGIN(PROF_PUSH_BLOCK);
+
+	if (m == 0) return;
+	if (m > size) { block += m - size; m = size; }
+
+	new_idx = ((size_t)*ptr_idx + size - n % size) % size;
+	push_block_mirrored(ptr, size, size, new_idx, block, m);
+	*ptr_idx = (pIdx)new_idx;
+	PROF_END(PROF_PUSH_BLOCK, n);
+}
+
+void push_block_fa(fa_handle fa, const dtype* block, const size_t n)
+{
+	size_t m = n, new_idx;
+	PROF_BEGIN(PROF_PUSH_BLOCK);
+
+	if (m == 0) return;
+	if (m > fa->size) { block += m - fa->size; m = fa->size; }
+
+	new_idx = ((size_t)fa->idx - n) & fa->mask;
+	push_block_mirrored(fa->ptr, fa->size, fa->mirror, new_idx, block, m);
+	fa->idx = (pIdx)new_idx;
+	PROF_END(PROF_PUSH_BLOCK, n);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          FAST ARRAY HANDLE
+*******************************************************************************/
+static size_t next_pow2(size_t n)
+{
+	size_t p = 1;
+	while (p < n) p <<= 1;
+	return p;
+}
+
+void* fa_aligned_malloc(const size_t bytes)
+{
+#ifdef _MSC_VER
+	return _aligned_malloc(bytes, FA_ALIGNMENT);
+#else
+	void* ptr = NULL;
+	if (posix_memalign(&ptr, FA_ALIGNMENT, bytes) != 0) return NULL;
+	return ptr;
+#endif
+}
+
+void fa_aligned_free(void* ptr)
+{
+#ifdef _MSC_VER
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+#ifdef __linux__
+static dtype* fa_map_mirrored(const size_t bytes)
+{
+	/*
+	* Reserves 2 * bytes of address space and maps one memfd of bytes
+	* over both halves. bytes must be a multiple of the page size.
+	* Returns NULL when any step fails; nothing is left mapped then.
+	*/
+
+	char* base;
+	int fd;
+
+	if ((fd = memfd_create("fast_array", MFD_CLOEXEC)) < 0) return NULL;
+	if (ftruncate(fd, (off_t)bytes) != 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	base = (char*)mmap(NULL, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	if (mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+		|| mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+	{
+		munmap(base, 2 * bytes);
+		close(fd);
+		return NULL;
+	}
+
+	close(fd); // the mappings keep the pages alive
+	return (dtype*)base;
+}
+#endif
+
+fa_handle fa_create(const size_t length)
+{
+	/*
+	* Arguments
+	- length : Window length of the fast array
+
+	Description
+	-	Allocates a fast array whose capacity is length rounded up to a power of two.
+		The storage holds two mirrored copies of the ring (2 * capacity elements),
+		is aligned to FA_ALIGNMENT bytes and is zero initialized.
+		Returns NULL on failure.
+	*/
+
+	return fa_create_mode(length, FA_MIRROR_COPY);
+}
+
+fa_handle fa_create_mode(const size_t length, const int mode)
+{
+	/*
+	* Arguments
+	- length : Window length of the fast array
+	- mode : FA_MIRROR_COPY or FA_MIRROR_MAPPED
+
+	Description
+	-	Same as fa_create, but FA_MIRROR_MAPPED backs both halves with the same
+		pages and rounds the capacity up to at least one page.
+		Falls back to FA_MIRROR_COPY when the pages cannot be mapped twice;
+		fa_mirror_mode tells which one was used.
+		Returns NULL on failure.
+	*/
+
+	fa_handle fa;
+
+	if (length == 0)
+	{
+		fprintf(stderr, "fa_create : length must be positive \n");
+		return NULL;
+	}
+
+	if ((fa = (fa_handle)malloc(sizeof(fast_array_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	fa->length = length;
+	fa->size = next_pow2(length);
+	fa->idx = 0;
+	fa->ptr = NULL;
+
+#ifdef __linux__
+	if (mode == FA_MIRROR_MAPPED)
+	{
+		const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+		if (fa->size * sizeof(dtype) < page) fa->size = page / sizeof(dtype); // both powers of two
+		fa->ptr = fa_map_mirrored(sizeof(dtype) * fa->size); // zero filled by ftruncate
+		if (fa->ptr == NULL) fa->size = next_pow2(length);
+	}
+#else
+	(void)mode;
+#endif
+	fa->mask = fa->size - 1;
+
+	if (fa->ptr != NULL)
+	{
+		fa->mirror = 0;
+		return fa;
+	}
+
+	if ((fa->ptr = (dtype*)fa_aligned_malloc(sizeof(dtype) * 2 * fa->size)) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		free(fa);
+		return NULL;
+	}
+	memset(fa->ptr, 0, sizeof(dtype) * 2 * fa->size);
+	fa->mirror = fa->size;
+
+	return fa;
+}
+
+void fa_destroy(fa_handle fa)
+{
+	if (fa == NULL) return;
+#ifdef __linux__
+	if (fa->mirror == 0)
+	{
+		munmap(fa->ptr, sizeof(dtype) * 2 * fa->size);
+		free(fa);
+		return;
+	}
+#endif
+	fa_aligned_free(fa->ptr);
+	free(fa);
+}
+
+int fa_mirror_mode(const fa_handle fa) { return fa->mirror == 0 ? FA_MIRROR_MAPPED : FA_MIRROR_COPY; }
+
+size_t fa_capacity(const fa_handle fa) { return fa->size; }
+size_t fa_length(const fa_handle fa) { return fa->length; }
+pIdx fa_index(const fa_handle fa) { return fa->idx; }
+dtype* fa_window(const fa_handle fa) { return fa->ptr + fa->idx; }
+
+void fa_sync_mirror(fa_handle fa)
+{
+	/*
+	Description
+	-	The window [idx, idx + size) is taken as the valid copy of the ring
+		and is copied to the other half so that ptr[i] == ptr[i + size] holds again.
+		Call after writing the window directly. Nothing to do when double mapped.
+	*/
+
+	size_t idx = (size_t)fa->idx;
+
+	if (fa->mirror == 0) return;
+	memcpy(fa->ptr + idx + fa->size, fa->ptr + idx, sizeof(dtype) * (fa->size - idx));
+	memcpy(fa->ptr, fa->ptr + fa->size, sizeof(dtype) * idx);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          SLIDING WINDOW STATISTICS
+*******************************************************************************/
+stats_handle stats_create(const size_t length, const int flags)
+{
+	/*
+	* Arguments
+	- length : Window length
+	- flags : STATS_MOMENTS, STATS_MINMAX, STATS_MEDIAN or STATS_ALL
+
+	Description
+	-	Creates the running statistics of a window of length samples, all zero.
+		Only the structures of the requested statistics are allocated.
+		Returns NULL on failure.
+	*/
+
+	stats_handle stats;
+	int failed = 0;
+
+	if (length == 0 || (flags & STATS_ALL) == 0)
+	{
+		fprintf(stderr, "stats_create : length and flags must be positive \n");
+		return NULL;
+	}
+
+	if ((stats = (stats_handle)calloc(1, sizeof(fa_stats_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	stats->flags = flags;
+	stats->length = length;
+	failed |= (stats->ring = (dtype*)malloc(sizeof(dtype) * length)) == NULL;
+
+	if (flags & STATS_MINMAX)
+	{
+		stats->mask = next_pow2(length + 1) - 1;
+		failed |= (stats->min.time = (size_t*)malloc(sizeof(size_t) * (stats->mask + 1))) == NULL;
+		failed |= (stats->min.value = (dtype*)malloc(sizeof(dtype) * (stats->mask + 1))) == NULL;
+		failed |= (stats->max.time = (size_t*)malloc(sizeof(size_t) * (stats->mask + 1))) == NULL;
+		failed |= (stats->max.value = (dtype*)malloc(sizeof(dtype) * (stats->mask + 1))) == NULL;
+	}
+
+	if (flags & STATS_MEDIAN)
+	{
+		stats->n_lo = (length + 1) / 2;
+		stats->n_hi = length / 2;
+		failed |= (stats->lo = (size_t*)malloc(sizeof(size_t) * stats->n_lo)) == NULL;
+		failed |= (stats->hi = (size_t*)malloc(sizeof(size_t) * (stats->n_hi + 1))) == NULL;
+		failed |= (stats->where = (size_t*)malloc(sizeof(size_t) * length)) == NULL;
+	}
+
+	if (failed)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		stats_destroy(stats);
+		return NULL;
+	}
+	stats_reset(stats);
+
+	return stats;
+}
+
+void stats_destroy(stats_handle stats)
+{
+	if (stats == NULL) return;
+	free(stats->ring);
+	free(stats->min.time), free(stats->min.value);
+	free(stats->max.time), free(stats->max.value);
+	free(stats->lo), free(stats->hi), free(stats->where);
+	free(stats);
+}
+
+void stats_reset(stats_handle stats)
+{
+	/* a window of zeros : one deque entry and any split of the slots are valid */
+
+	size_t i;
+
+	memset(stats->ring, 0, sizeof(dtype) * stats->length);
+	stats->count = stats->length;
+	stats->slot = 0;
+	stats->mean = 0, stats->m2 = 0;
+
+	if (stats->flags & STATS_MINMAX)
+	{
+		stats->min.time[0] = stats->max.time[0] = stats->length - 1;
+		stats->min.value[0] = stats->max.value[0] = 0;
+		stats->min.head = stats->max.head = 0;
+		stats->min.tail = stats->max.tail = 1;
+	}
+
+	if (stats->flags & STATS_MEDIAN)
+	{
+		for (i = 0; i < stats->n_lo; i++) stats->lo[i] = i, stats->where[i] = i;
+		for (i = 0; i < stats->n_hi; i++) stats->hi[i] = stats->n_lo + i, stats->where[stats->n_lo + i] = stats->n_lo + i;
+	}
+}
+
+static void stats_resync(stats_handle stats)
+{
+	/* exact two pass mean and squared deviations of the window */
+
+	const dtype* x = stats->ring;
+	double sum = 0, m2 = 0, d;
+	size_t i;
+
+	for (i = 0; i < stats->length; i++) sum += x[i];
+	sum /= (double)stats->length;
+	for (i = 0; i < stats->length; i++) d = x[i] - sum, m2 += d * d;
+	stats->mean = sum;
+	stats->m2 = m2;
+}
+
+static void deque_push(stats_deque_t* q, const size_t mask, const size_t t, const dtype x, const size_t length, const int is_max)
+{
+	/* drops the entries that can never be the extreme again, then the expired front */
+
+	while (q->tail != q->head && (is_max ? q->value[(q->tail - 1) & mask] <= x : q->value[(q->tail - 1) & mask] >= x)) q->tail--;
+	q->time[q->tail & mask] = t;
+	q->value[q->tail & mask] = x;
+	q->tail++;
+	while (q->time[q->head & mask] + length <= t) q->head++;
+}
+
+static void heap_sift(stats_handle stats, size_t* heap, const size_t n, const size_t offset, size_t i, const int is_max)
+{
+	/* restores the heap around position i, either up or down */
+
+	const dtype* v = stats->ring;
+	size_t p, c, t;
+
+#define heap_before(a, b) (is_max ? v[a] > v[b] : v[a] < v[b])
+#define heap_swap(i, j) (t = heap[i], heap[i] = heap[j], heap[j] = t, stats->where[heap[i]] = offset + (i), stats->where[heap[j]] = offset + (j))
+
+	while (i > 0 && heap_before(heap[i], heap[p = (i - 1) / 2]))
+	{
+		heap_swap(i, p);
+		i = p;
+	}
+	while ((c = 2 * i + 1) < n)
+	{
+		if (c + 1 < n && heap_before(heap[c + 1], heap[c])) c++;
+		if (!heap_before(heap[c], heap[i])) break;
+		heap_swap(i, c);
+		i = c;
+	}
+
+#undef heap_before
+#undef heap_swap
+}
+
+static void median_replace(stats_handle stats, const size_t slot, const dtype x)
+{
+	/*
+	* The new value keeps the heap of its slot, which is re-sifted. If the
+	* halves then overlap (max of lo > min of hi), the two tops are swapped;
+	* the other elements did not move, so one swap restores the order.
+	*/
+
+	const size_t w = stats->where[slot], n_lo = stats->n_lo;
+	size_t t;
+
+	stats->ring[slot] = x;
+	if (w < n_lo) heap_sift(stats, stats->lo, n_lo, 0, w, 1);
+	else heap_sift(stats, stats->hi, stats->n_hi, n_lo, w - n_lo, 0);
+
+	if (stats->n_hi > 0 && stats->ring[stats->lo[0]] > stats->ring[stats->hi[0]])
+	{
+		t = stats->lo[0], stats->lo[0] = stats->hi[0], stats->hi[0] = t;
+		stats->where[stats->lo[0]] = 0;
+		stats->where[stats->hi[0]] = n_lo;
+		heap_sift(stats, stats->lo, n_lo, 0, 0, 1);
+		heap_sift(stats, stats->hi, stats->n_hi, n_lo, 0, 0);
+	}
+}
+
+void stats_push(stats_handle stats, const dtype x)
+{
+	/*
+	* Arguments
+	- stats : Running statistics
+	- x : New sample, the oldest sample of the window leaves
+
+	Description
+	-	Sliding Welford update : with d = x - old,
+		mean' = mean + d / length, m2' = m2 + d * ((x - mean') + (old - mean)).
+	*/
+
+	const size_t slot = stats->slot;
+	const dtype old = stats->ring[slot];
+	double mean;
+
+	if (stats->flags & STATS_MOMENTS)
+	{
+		mean = stats->mean + (x - old) / (double)stats->length;
+		stats->m2 += (x - old) * ((x - mean) + (old - stats->mean));
+		stats->mean = mean;
+	}
+
+	if (stats->flags & STATS_MEDIAN) median_replace(stats, slot, x);
+	else stats->ring[slot] = x;
+
+	if (stats->flags & STATS_MINMAX)
+	{
+		deque_push(&stats->min, stats->mask, stats->count, x, stats->length, 0);
+		deque_push(&stats->max, stats->mask, stats->count, x, stats->length, 1);
+	}
+
+	stats->count++;
+	if (++stats->slot == stats->length)
+	{
+		stats->slot = 0;
+		if (stats->flags & STATS_MOMENTS) stats_resync(stats); // bounds the drift, O(1) per push amortized
+	}
+}
+
+void stats_push_block(stats_handle stats, const dtype* block, const size_t n)
+{
+	/* block[0] is the oldest sample, same order as push_block_fa */
+
+	size_t i;
+	PROF_BEGIN(PROF_STATS);
+
+	for (i = 0; i < n; i++) stats_push(stats, block[i]);
+	PROF_END(PROF_STATS, n);
+}
+
+dtype stats_mean(const stats_handle stats) { return (dtype)stats->mean; }
+dtype stats_variance(const stats_handle stats) { return (dtype)(stats->m2 > 0 ? stats->m2 / (double)stats->length : 0); }
+dtype stats_rms(const stats_handle stats) { return (dtype)sqrt(stats->mean * stats->mean + (stats->m2 > 0 ? stats->m2 / (double)stats->length : 0)); }
+dtype stats_min(const stats_handle stats) { return stats->min.value[stats->min.head & stats->mask]; }
+dtype stats_max(const stats_handle stats) { return stats->max.value[stats->max.head & stats->mask]; }
+
+dtype stats_median(const stats_handle stats)
+{
+	/* middle sample, or the mean of the two middle samples for an even length */
+
+	const dtype m = stats->ring[stats->lo[0]];
+	return stats->n_hi == stats->n_lo ? (m + stats->ring[stats->hi[0]]) / 2 : m;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          SPSC FAST ARRAY
+*******************************************************************************/
+spsc_handle spsc_create(const size_t length, const size_t slack)
+{
+	/*
+	* Arguments
+	- length : Window length borrowed by the consumer
+	- slack : Samples the producer can push while the consumer holds a window,
+			  capacity is length + slack rounded up to a power of two
+
+	Description
+	-	Returns NULL on failure.
+	*/
+
+	spsc_handle spsc;
+
+	if (length == 0)
+	{
+		fprintf(stderr, "spsc_create : length must be positive \n");
+		return NULL;
+	}
+
+	if ((spsc = (spsc_handle)fa_aligned_malloc(sizeof(fa_spsc_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	memset(spsc, 0, sizeof(fa_spsc_t));
+
+	spsc->length = length;
+	spsc->size = next_pow2(length + (slack ? slack : 1));
+	spsc->mask = spsc->size - 1;
+
+	if ((spsc->ptr = (dtype*)fa_aligned_malloc(sizeof(dtype) * 2 * spsc->size)) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		fa_aligned_free(spsc);
+		return NULL;
+	}
+	memset(spsc->ptr, 0, sizeof(dtype) * 2 * spsc->size);
+
+	return spsc;
+}
+
+void spsc_destroy(spsc_handle spsc)
+{
+	if (spsc == NULL) return;
+	fa_aligned_free(spsc->ptr);
+	fa_aligned_free(spsc);
+}
+
+size_t spsc_push(spsc_handle spsc, const dtype* block, const size_t n)
+{
+	/*
+	* Arguments
+	- block : Samples to push, block[0] is the oldest
+
+	Description
+	-	Producer side. Writes as many of the first samples of block as fit in
+		front of the consumer's tail, then publishes them with one release store.
+		Returns the number of samples pushed.
+	*/
+
+	const size_t h = spsc->head; // only the producer writes head
+	size_t room = spsc->tail_cache + spsc->size - h, m = n;
+	PROF_BEGIN(PROF_SPSC_PUSH);
+
+	if (room < m)
+	{
+		spsc->tail_cache = fa_load_acquire(&spsc->tail);
+		room = spsc->tail_cache + spsc->size - h;
+	}
+	if (m > room)
+	{
+		spsc->dropped += m - room;
+		m = room;
+	}
+	if (m == 0) return 0;
+
+	push_block_mirrored(spsc->ptr, spsc->size, spsc->size, (0 - (h + m)) & spsc->mask, block, m);
+	fa_store_release(&spsc->head, h + m);
+	PROF_END(PROF_SPSC_PUSH, m);
+	return m;
+}
+
+size_t spsc_push_sample(spsc_handle spsc, const dtype x)
+{
+	const size_t h = spsc->head;
+	size_t slot;
+
+	if (spsc->tail_cache + spsc->size - h == 0)
+	{
+		spsc->tail_cache = fa_load_acquire(&spsc->tail);
+		if (spsc->tail_cache + spsc->size - h == 0)
+		{
+			spsc->dropped++;
+			return 0;
+		}
+	}
+
+	slot = (0 - (h + 1)) & spsc->mask;
+	spsc->ptr[slot] = x;
+	spsc->ptr[slot + spsc->size] = x;
+	fa_store_release(&spsc->head, h + 1);
+	return 1;
+}
+
+const dtype* spsc_acquire(spsc_handle spsc)
+{
+	/*
+	Description
+	-	Consumer side. Borrows the latest length samples as one contiguous
+		window, newest first (same layout as fa_window), without copying.
+		The window stays valid until the next spsc_acquire or spsc_release.
+		Returns NULL when nothing was pushed since the previous window or
+		while fewer than length samples were pushed since the last release;
+		the previous window, if any, is then still held.
+	*/
+
+	const size_t h = fa_load_acquire(&spsc->head);
+
+	if (h == spsc->acquired || h - spsc->tail < spsc->length) return NULL;
+
+	// the producer may now reuse everything older than the new window
+	fa_store_release(&spsc->tail, h - spsc->length);
+	spsc->acquired = h;
+	return spsc->ptr + ((0 - h) & spsc->mask);
+}
+
+void spsc_release(spsc_handle spsc)
+{
+	/*
+	Description
+	-	Consumer side. Gives the borrowed window back; the next window then
+		holds only samples pushed after it (block by block processing
+		instead of a sliding window).
+	*/
+
+	fa_store_release(&spsc->tail, spsc->acquired);
+}
+
+size_t spsc_dropped(const spsc_handle spsc)
+{
+	return spsc->dropped;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          FAST SIGNAL GENERATION
+*******************************************************************************/
+static void osc_setup(osc_handle osc, const double c, const double s, const dtype amplitude, const double z_re, const double z_im);
+static void osc_run(osc_handle osc, dtype* out, const size_t n, const int accumulate);
+
+void fast_sin(dtype* arr, const size_t size, float f0, float fs)
+{
+	/*
+	Description
+	-	arr[i] = sin((i + 1) w), w = 2 pi f0 / fs.
+		Used to be the second-order recurrence q(n) = 2 cos(w) q(n - 1) - q(n - 2),
+		which runs one sample per iteration and drifts; now a multi-lane oscillator.
+	*/
+
+	const double w = PI2 * f0 / fs;
+	const double c = cos(w), s = sin(w);
+	oscillator_t osc;
+
+	osc_setup(&osc, c, s, 1, c, s);
+	osc_run(&osc, arr, size, 0);
+}
+void fast_cos(dtype* arr, const size_t size, float f0, float fs)
+{
+	/*
+	Description
+	-	arr[i] = cos((i + 1) w), the sine oscillator started a quarter turn ahead.
+	*/
+
+	const double w = PI2 * f0 / fs;
+	const double c = cos(w), s = sin(w);
+	oscillator_t osc;
+
+	osc_setup(&osc, c, s, 1, -s, c);
+	osc_run(&osc, arr, size, 0);
+}
+void fast_sin_pidx(dtype* arr, const size_t size, float f0, float fs, pIdx idx)
+{
+	fast_sin(arr + idx, size, f0, fs);
+}
+void fast_cos_pidx(dtype* arr, const size_t size, float f0, float fs, pIdx idx)
+{
+	fast_cos(arr + idx, size, f0, fs);
+}
+void fast_sin_fa(fa_handle fa, float f0, float fs)
+{
+	fast_sin(fa_window(fa), fa->size, f0, fs); fa_sync_mirror(fa);
+}
+void fast_cos_fa(fa_handle fa, float f0, float fs)
+{
+	fast_cos(fa_window(fa), fa->size, f0, fs); fa_sync_mirror(fa);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          OSCILLATOR
+*******************************************************************************/
+static void osc_renorm(dtype* re, dtype* im, const size_t n)
+{
+	/* one newton step towards |z| = 1, enough since |z| only drifts by rounding */
+	dtype g;
+	size_t l;
+
+	for (l = 0; l < n; l++)
+	{
+		g = (dtype)1.5 - (dtype)0.5 * (re[l] * re[l] + im[l] * im[l]);
+		re[l] *= g;
+		im[l] *= g;
+	}
+}
+
+static void osc_setup(osc_handle osc, const double c, const double s, const dtype amplitude, const double z_re, const double z_im)
+{
+	/*
+	* Arguments
+	- c, s : cos(w), sin(w)
+	- z_re, z_im : Unit phasor of the first sample
+
+	Description
+	-	The lane phasors and powers come from e^(j w) by complex multiplication,
+		so setting up costs no libm call and fast_sin only needs one sin / cos pair.
+	*/
+
+	double pr = 1, pi = 0, t;
+	int l;
+
+	for (l = 0; l < OSC_LANES; l++)
+	{
+		osc->pow_re[l] = (dtype)pr, osc->pow_im[l] = (dtype)pi;
+		osc->re[l] = (dtype)(z_re * pr - z_im * pi);
+		osc->im[l] = (dtype)(z_re * pi + z_im * pr);
+		osc->amp[l] = amplitude;
+		t = pr * c - pi * s;
+		pi = pr * s + pi * c;
+		pr = t;
+	}
+	for (l = 0; l < OSC_LANES; l++) osc->step_re[l] = (dtype)pr, osc->step_im[l] = (dtype)pi;
+}
+
+static void osc_run(osc_handle osc, dtype* out, const size_t n, const int accumulate)
+{
+	const size_t steps = n / OSC_LANES, tail = n % OSC_LANES;
+	dtype r, pr, pi;
+	size_t s, c, l;
+
+	for (s = 0; s < steps; s += c)
+	{
+		c = (steps - s < OSC_RENORM) ? steps - s : OSC_RENORM;
+		simd_osc_lanes(osc->re, osc->im, osc->step_re, osc->step_im, osc->amp, out + s * OSC_LANES, c, OSC_LANES, accumulate);
+		osc_renorm(osc->re, osc->im, OSC_LANES);
+	}
+
+	if (tail == 0) return;
+
+	// the first tail lanes are the last samples, then every lane moves tail samples ahead
+	out += steps * OSC_LANES;
+	for (l = 0; l < tail; l++)
+	{
+		if (accumulate) out[l] += osc->amp[l] * osc->im[l];
+		else out[l] = osc->amp[l] * osc->im[l];
+	}
+	pr = osc->pow_re[tail], pi = osc->pow_im[tail];
+	for (l = 0; l < OSC_LANES; l++)
+	{
+		r = osc->re[l] * pr - osc->im[l] * pi;
+		osc->im[l] = osc->re[l] * pi + osc->im[l] * pr;
+		osc->re[l] = r;
+	}
+}
+
+osc_handle osc_create(float f0, float fs, dtype amplitude, float phase)
+{
+	/*
+	* Arguments
+	- f0 : Frequency
+	- fs : Sampling frequency
+	- amplitude : Peak amplitude
+	- phase : Phase of the first sample in degree, as in sin_
+
+	Description
+	-	Creates an oscillator whose output matches amplitude * sin_(f0, fs, phase).
+		Returns NULL on failure.
+	*/
+
+	const double w = PI2 * (f0 / fs);
+	osc_handle osc;
+
+	if ((osc = (osc_handle)calloc(1, sizeof(oscillator_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	osc_setup(osc, cos(w), sin(w), amplitude, cos(DEG2RAD(phase)), sin(DEG2RAD(phase)));
+	return osc;
+}
+
+void osc_destroy(osc_handle osc)
+{
+	free(osc);
+}
+
+void osc_reset(osc_handle osc, float phase)
+{
+	/* restarts at phase (degree), frequency and amplitude are kept */
+	osc_setup(osc, osc->pow_re[1], osc->pow_im[1], osc->amp[0], cos(DEG2RAD(phase)), sin(DEG2RAD(phase)));
+}
+
+void osc_process(osc_handle osc, dtype* out, const size_t n)
+{
+	/*
+	* Arguments
+	- out : n samples, continuing from the previous call
+
+	Description
+	-	OSC_LANES samples per kernel step, any n is accepted.
+	*/
+
+	osc_run(osc, out, n, 0);
+}
+
+osc_bank_handle osc_bank_create(const size_t n_tones)
+{
+	/*
+	* Arguments
+	- n_tones : Number of tones, silent until set with osc_bank_set_tone
+
+	Description
+	-	Returns NULL on failure.
+	*/
+
+	osc_bank_handle bank;
+	size_t t;
+
+	if (n_tones == 0)
+	{
+		fprintf(stderr, "osc_bank_create : n_tones must be positive \n");
+		return NULL;
+	}
+
+	if ((bank = (osc_bank_handle)calloc(1, sizeof(osc_bank_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	bank->n_tones = n_tones;
+	bank->stride = (n_tones + OSC_LANES - 1) / OSC_LANES * OSC_LANES;
+	bank->re = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+	bank->im = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+	bank->step_re = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+	bank->step_im = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+	bank->amp = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+	if (bank->stride != n_tones) bank->frames = (dtype*)fa_aligned_malloc(sizeof(dtype) * OSC_BLOCK * bank->stride);
+
+	if (bank->re == NULL || bank->im == NULL || bank->step_re == NULL || bank->step_im == NULL || bank->amp == NULL
+		|| (bank->stride != n_tones && bank->frames == NULL))
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		osc_bank_destroy(bank);
+		return NULL;
+	}
+
+	for (t = 0; t < bank->stride; t++)
+	{
+		bank->re[t] = 1, bank->im[t] = 0;
+		bank->step_re[t] = 1, bank->step_im[t] = 0;
+		bank->amp[t] = 0;
+	}
+	return bank;
+}
+
+void osc_bank_destroy(osc_bank_handle bank)
+{
+	if (bank == NULL) return;
+	fa_aligned_free(bank->re);
+	fa_aligned_free(bank->im);
+	fa_aligned_free(bank->step_re);
+	fa_aligned_free(bank->step_im);
+	fa_aligned_free(bank->amp);
+	fa_aligned_free(bank->frames);
+	free(bank);
+}
+
+void osc_bank_set_tone(osc_bank_handle bank, const size_t tone, float f0, float fs, dtype amplitude, float phase)
+{
+	/*
+	Description
+	-	The next sample of the tone is amplitude * sin(phase), phase in degree.
+	*/
+
+	const double w = PI2 * (f0 / fs);
+
+	if (tone >= bank->n_tones) return;
+	bank->re[tone] = (dtype)cos(DEG2RAD(phase)), bank->im[tone] = (dtype)sin(DEG2RAD(phase));
+	bank->step_re[tone] = (dtype)cos(w), bank->step_im[tone] = (dtype)sin(w);
+	bank->amp[tone] = amplitude;
+}
+
+void osc_bank_process(osc_bank_handle bank, dtype* out, const size_t n)
+{
+	/*
+	* Arguments
+	- out : Interleaved output, n frames of n_tones samples
+
+	Description
+	-	Each kernel call advances OSC_LANES adjacent tones by one sample per step.
+		With n_tones not a multiple of OSC_LANES the frames go through a padded
+		buffer, one pass of OSC_BLOCK frames at a time.
+	*/
+
+	const size_t S = bank->stride, T = bank->n_tones;
+	size_t done, c, s, k, t, j;
+	dtype* dst;
+
+	for (done = 0; done < n; done += c)
+	{
+		c = (n - done < OSC_BLOCK) ? n - done : OSC_BLOCK;
+		dst = (S == T) ? out + done * T : bank->frames;
+
+		for (s = 0; s < c; s += k) // a few frames across every tone, so the frames stay in cache
+		{
+			k = (c - s < OSC_BANK_FRAMES) ? c - s : OSC_BANK_FRAMES;
+			for (t = 0; t < S; t += OSC_LANES)
+				simd_osc_lanes(bank->re + t, bank->im + t, bank->step_re + t, bank->step_im + t, bank->amp + t,
+					dst + s * S + t, k, S, 0);
+		}
+		osc_renorm(bank->re, bank->im, S);
+
+		if (S != T)
+			for (j = 0; j < c; j++) memcpy(out + (done + j) * T, bank->frames + j * S, sizeof(dtype) * T);
+	}
+}
+
+void osc_bank_mix(osc_bank_handle bank, dtype* out, const size_t n)
+{
+	/*
+	* Arguments
+	- out : n samples of the sum of every tone
+
+	Description
+	-	Every tone is expanded to an OSC_LANES lane oscillator and accumulated into out,
+		so one kernel step adds OSC_LANES consecutive samples of one tone.
+		Continues where the previous osc_bank_process / osc_bank_mix stopped.
+	*/
+
+	oscillator_t osc;
+	size_t t;
+
+	zeros(out, n);
+	for (t = 0; t < bank->n_tones; t++)
+	{
+		if (bank->amp[t] == 0) continue;
+
+		osc_setup(&osc, bank->step_re[t], bank->step_im[t], bank->amp[t], bank->re[t], bank->im[t]);
+		osc_run(&osc, out, n, 1);
+
+		osc_renorm(osc.re, osc.im, 1);
+		bank->re[t] = osc.re[0], bank->im[t] = osc.im[0];
+	}
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          DOT PRODUCTS
+*******************************************************************************/
+/*
+* The dot products run on the simd kernel selected at the first call
+* (see simd.c). The *_debug variants stay scalar and record every step
+* as a binary trace record (trace.h) while a trace is running.
+*/
+dtype dot_product(dtype* a, dtype* b, pIdx size)
+{
+	dtype sum;
+	PROF_BEGIN(PROF_DOT);
+
+	if (size <= 0) return 0;
+	sum = simd_dot(a, b, (size_t)size);
+	PROF_END(PROF_DOT, size);
+	return sum;
+}
+dtype dot_product_pidx(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx)
+{
+	dtype sum;
+	PROF_BEGIN(PROF_DOT);
+
+	sum = simd_dot(arr1 + ptr_idx, arr2 + ptr_idx, size);
+	PROF_END(PROF_DOT, size);
+	return sum;
+}
+dtype dot_product_pidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx)
+{
+	dtype sum = 0; int i;
+	for (i = ptr_idx; i < ptr_idx + size; i++)
+	{
+		sum += arr1[i] * arr2[i];
+		TRACE(TRACE_DOT_PIDX, i, i, arr1[i], arr2[i], sum);
+	}
+	return sum;
+}
+dtype dot_product_dpidx(dtype* arr1, dtype* arr2, const  size_t size, pIdx ptr_idx1, pIdx ptr_idx2)
+{
+	dtype sum;
+	PROF_BEGIN(PROF_DOT);
+
+	sum = simd_dot(arr1 + ptr_idx1, arr2 + ptr_idx2, size);
+	PROF_END(PROF_DOT, size);
+	return sum;
+}
+dtype dot_product_dpidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2)
+{
+	dtype sum = 0; int i, j;
+	for (i = ptr_idx1, j = ptr_idx2; i < ptr_idx1 + size; i++, j++)
+	{
+		sum += arr1[i] * arr2[j];
+		TRACE(TRACE_DOT_DPIDX, i, j, arr1[i], arr2[j], sum);
+	}
+	return sum;
+}
+dtype dot_product4(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2)
+{
+	dtype sum;
+	PROF_BEGIN(PROF_DOT);
+
+	sum = simd_dot(arr2 + ptr_idx1, arr1 + ptr_idx2, size);
+	PROF_END(PROF_DOT, size);
+	return sum;
+}
+dtype dot_product_fa(const fa_handle fa, dtype* arr)
+{
+	return dot_product(fa_window(fa), arr, (pIdx)fa->length);
+}
+dtype dot_product_dfa(const fa_handle fa1, const fa_handle fa2)
+{
+	size_t size = fa1->length < fa2->length ? fa1->length : fa2->length;
+	return dot_product(fa_window(fa1), fa_window(fa2), (pIdx)size);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          PARALLEL BULK KERNELS
+*******************************************************************************/
+#define BULK_ZEROS 0
+#define BULK_ONES 1
+#define BULK_SCALE 2
+#define BULK_SIN 3
+#define BULK_COS 4
+#define BULK_RANDS 5
+#define BULK_DOT 6
+
+typedef struct _bulk_job
+{
+	int op;
+	dtype* arr;
+	const dtype* a, * b;	// dot operands
+	size_t size, n_chunks;
+	dtype value;			// scaling factor
+	float f0, fs, phase;
+	float average, stdev;
+	uint64_t seed;
+	dtype* partial;			// n_chunks dot sums
+} bulk_job_t;
+
+static fa_pool bulk_pool = NULL;
+static int bulk_workers = 0;		// 0 : cpu_count() at the first parallel call
+static volatile long bulk_busy = 0;	// held while the pool runs a job
+
+static void bulk_rands_task(bulk_job_t* job, const size_t first, const size_t last)
+{
+	/* chunk c is the start of stream c : seed once, then one jump per chunk from the saved chunk start */
+
+	noise_t noise;
+	uint64_t start[4 * NOISE_LANES];
+	size_t c, begin;
+
+	if (first == last) return;
+	noise_seed(&noise, job->seed, first);
+	for (c = first; c < last; c++)
+	{
+		begin = c * BULK_CHUNK;
+		memcpy(start, noise.state, sizeof(start));
+		noise_gaussian(&noise, job->arr + begin, job->size - begin < BULK_CHUNK ? job->size - begin : BULK_CHUNK,
+			job->average, job->stdev);
+		memcpy(noise.state, start, sizeof(start));
+		noise_jump(&noise);
+	}
+}
+
+static void bulk_task(void* arg, int worker, int n_workers)
+{
+	bulk_job_t* job = (bulk_job_t*)arg;
+	dtype* __restrict arr = job->arr;
+	const dtype value = job->value;
+	const double w = PI2 * (job->f0 / job->fs), phase = DEG2RAD(job->phase);
+	size_t first, last, c, begin, end, i;
+
+	pool_range(job->n_chunks, worker, n_workers, first, last);
+	if (job->op == BULK_RANDS)
+	{
+		bulk_rands_task(job, first, last);
+		return;
+	}
+
+	for (c = first; c < last; c++)
+	{
+		begin = c * BULK_CHUNK;
+		end = job->size - begin < BULK_CHUNK ? job->size : begin + BULK_CHUNK;
+		switch (job->op)
+		{
+		case BULK_ZEROS:
+			zeros(arr + begin, end - begin);
+			break;
+		case BULK_ONES:
+			ones(arr + begin, end - begin);
+			break;
+		case BULK_SCALE:
+			scaling(arr + begin, end - begin, value);
+			break;
+		case BULK_SIN:
+			for (i = begin; i < end; i++) arr[i] = (dtype)sin(w * i + phase);
+			break;
+		case BULK_COS:
+			for (i = begin; i < end; i++) arr[i] = (dtype)cos(w * i + phase);
+			break;
+		case BULK_DOT:
+			job->partial[c] = simd_dot(job->a + begin, job->b + begin, end - begin);
+			break;
+		}
+	}
+}
+
+static void bulk_run(bulk_job_t* job)
+{
+	/*
+	Description
+	-	Runs the job on the internal pool, created and pinned on the first parallel call.
+		Small jobs, a single worker or a pool already busy on another thread
+		run the same chunks on the calling thread.
+	*/
+
+	job->n_chunks = (job->size + BULK_CHUNK - 1) / BULK_CHUNK;
+
+	if (job->size < BULK_PARALLEL_MIN || bulk_workers == 1 || !fa_try_lock(&bulk_busy))
+	{
+		bulk_task(job, 0, 1);
+		return;
+	}
+
+	if (bulk_pool == NULL)
+	{
+		if ((bulk_pool = pool_create(bulk_workers)) == NULL) bulk_workers = 1;
+		pool_pin(bulk_pool);
+	}
+	pool_run(bulk_pool, bulk_task, job);
+	fa_unlock(&bulk_busy);
+}
+
+int bulk_set_threads(int n_threads)
+{
+	/*
+	* Arguments
+	- n_threads : Workers of the bulk kernels including the caller, <= 0 selects cpu_count(), 1 : serial
+
+	Description
+	-	Replaces the internal pool, the new one starts at the next parallel call.
+		Returns -1 and changes nothing while a bulk kernel runs on another thread.
+	*/
+
+	if (!fa_try_lock(&bulk_busy)) return -1;
+	pool_destroy(bulk_pool);
+	bulk_pool = NULL;
+	bulk_workers = n_threads > 0 ? n_threads : cpu_count();
+	fa_unlock(&bulk_busy);
+	return 0;
+}
+
+int bulk_get_threads(void)
+{
+	return bulk_workers > 0 ? bulk_workers : cpu_count();
+}
+
+void zeros_mt(dtype* arr, const size_t size)
+{
+	bulk_job_t job = { 0 };
+	job.op = BULK_ZEROS, job.arr = arr, job.size = size;
+	bulk_run(&job);
+}
+
+void ones_mt(dtype* arr, const size_t size)
+{
+	bulk_job_t job = { 0 };
+	job.op = BULK_ONES, job.arr = arr, job.size = size;
+	bulk_run(&job);
+}
+
+void scaling_mt(dtype* arr, const size_t size, dtype scailing_factor)
+{
+	bulk_job_t job = { 0 };
+	job.op = BULK_SCALE, job.arr = arr, job.size = size, job.value = scailing_factor;
+	bulk_run(&job);
+}
+
+void rands_mt(dtype* arr, const size_t size, float average, float stdev, const uint64_t seed)
+{
+	/*
+	Description
+	-	Gaussian noise, chunk c drawn from noise stream c of seed :
+		the same array for any worker count, and the same first BULK_CHUNK samples
+		as noise_create(seed, 0) followed by noise_gaussian.
+	*/
+
+	bulk_job_t job = { 0 };
+	job.op = BULK_RANDS, job.arr = arr, job.size = size, job.average = average, job.stdev = stdev, job.seed = seed;
+	bulk_run(&job);
+}
+
+void sin_mt(dtype* arr, const size_t size, float f0, float fs, float phase)
+{
+	bulk_job_t job = { 0 };
+	job.op = BULK_SIN, job.arr = arr, job.size = size, job.f0 = f0, job.fs = fs, job.phase = phase;
+	bulk_run(&job);
+}
+
+void cos_mt(dtype* arr, const size_t size, float f0, float fs, float phase)
+{
+	bulk_job_t job = { 0 };
+	job.op = BULK_COS, job.arr = arr, job.size = size, job.f0 = f0, job.fs = fs, job.phase = phase;
+	bulk_run(&job);
+}
+
+dtype dot_product_mt(const dtype* a, const dtype* b, const size_t size)
+{
+	/*
+	Description
+	-	Each chunk is summed by the simd kernel, then the chunk sums are added
+		in chunk order on the calling thread : the rounding is fixed by size alone.
+		Inputs of one chunk or less are a plain simd_dot.
+	*/
+
+	bulk_job_t job = { 0 };
+	dtype stack[BULK_PARALLEL_MIN / BULK_CHUNK], sum = 0;
+	size_t c;
+	PROF_BEGIN(PROF_DOT_MT);
+
+	if (size <= BULK_CHUNK)
+	{
+		sum = simd_dot(a, b, size);
+		PROF_END(PROF_DOT_MT, size);
+		return sum;
+	}
+
+	job.op = BULK_DOT, job.a = a, job.b = b, job.size = size;
+	job.partial = stack;
+	if (size > BULK_PARALLEL_MIN && (job.partial = (dtype*)malloc(sizeof(dtype) * ((size + BULK_CHUNK - 1) / BULK_CHUNK))) == NULL)
+	{
+		fprintf(stderr, "dot_product_mt : Memory Allocation Error! use single thread \n");
+		sum = simd_dot(a, b, size);
+		PROF_END(PROF_DOT_MT, size);
+		return sum;
+	}
+
+	bulk_run(&job);
+	for (c = 0; c < job.n_chunks; c++) sum += job.partial[c];
+
+	if (job.partial != stack) free(job.partial);
+	PROF_END(PROF_DOT_MT, size);
+	return sum;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          EXPRESSION PIPELINE
+*******************************************************************************/
+expr_handle expr_create(void)
+{
+	/*
+	Description
+	-	Empty pipeline : no operation, no reduction.
+		Returns NULL on failure.
+	*/
+
+	expr_handle expr;
+
+	if ((expr = (expr_handle)calloc(1, sizeof(fa_expr_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	expr->block = (dtype*)fa_aligned_malloc(sizeof(dtype) * EXPR_BLOCK);
+	expr->scratch = (dtype*)fa_aligned_malloc(sizeof(dtype) * EXPR_BLOCK);
+
+	if (expr->block == NULL || expr->scratch == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		expr_destroy(expr);
+		return NULL;
+	}
+	return expr;
+}
+
+void expr_destroy(expr_handle expr)
+{
+	if (expr == NULL) return;
+	fa_aligned_free(expr->block);
+	fa_aligned_free(expr->scratch);
+	free(expr);
+}
+
+void expr_reset(expr_handle expr)
+{
+	expr->n_ops = 0;
+	expr->reduce = EXPR_REDUCE_NONE;
+	expr->reduce_arr = NULL;
+}
+
+static int expr_push(expr_handle expr, const int type, const dtype a, const dtype b, const dtype* arr, noise_handle noise)
+{
+	/* appends one operation, -1 when the chain is full */
+
+	expr_op_t* op;
+
+	if (expr->n_ops == EXPR_MAX_OPS)
+	{
+		fprintf(stderr, "expr : more than %d operations \n", EXPR_MAX_OPS);
+		return -1;
+	}
+	op = &expr->ops[expr->n_ops++];
+	op->type = type, op->a = a, op->b = b, op->arr = arr, op->noise = noise;
+	return 0;
+}
+
+int expr_scale(expr_handle expr, const dtype factor)
+{
+	return expr_push(expr, EXPR_SCALE, factor, 0, NULL, NULL);
+}
+
+int expr_offset(expr_handle expr, const dtype offset)
+{
+	return expr_push(expr, EXPR_OFFSET, offset, 0, NULL, NULL);
+}
+
+int expr_add(expr_handle expr, const dtype* arr)
+{
+	return expr_push(expr, EXPR_ADD, 0, 0, arr, NULL);
+}
+
+int expr_mul(expr_handle expr, const dtype* arr)
+{
+	return expr_push(expr, EXPR_MUL, 0, 0, arr, NULL);
+}
+
+int expr_noise(expr_handle expr, const dtype average, const dtype stdev, noise_handle noise)
+{
+	/* the samples are the ones noise_gaussian(noise, .., n, average, stdev) gives over the whole run */
+	return expr_push(expr, EXPR_NOISE, average, stdev, NULL, noise);
+}
+
+int expr_clamp(expr_handle expr, const dtype lo, const dtype hi)
+{
+	return expr_push(expr, EXPR_CLAMP, lo, hi, NULL, NULL);
+}
+
+void expr_reduce(expr_handle expr, const int reduce, const dtype* arr)
+{
+	/*
+	* Arguments
+	- reduce : EXPR_REDUCE_*, the value returned by expr_run
+	- arr : Operand of EXPR_REDUCE_DOT, NULL otherwise
+	*/
+
+	expr->reduce = reduce;
+	expr->reduce_arr = arr;
+}
+
+static void expr_apply(const expr_op_t* op, dtype* x, dtype* scratch, const size_t offset, const size_t n)
+{
+	if (op->type == EXPR_NOISE)
+	{
+		noise_gaussian(op->noise ? op->noise : noise_thread(), scratch, n, op->a, op->b);
+		simd_elementwise(x, scratch, 0, 0, n, SIMD_EW_ADD);
+	}
+	else simd_elementwise(x, op->arr ? op->arr + offset : NULL, op->a, op->b, n, op->type);
+}
+
+dtype expr_run(expr_handle expr, const dtype* in, dtype* out, const size_t n)
+{
+	/*
+	* Arguments
+	- in : n input elements
+	- out : n results, may be in (in place) or NULL when only the reduction is wanted
+
+	Description
+	-	Runs the chain block by block and returns the reduction (0 without one).
+		The reduction adds one simd sum per block, so it rounds like a blocked sum
+		rather than like one dot_product over the whole array.
+	*/
+
+	dtype* __restrict x = expr->block;
+	dtype acc = 0;
+	size_t i, k, m;
+	int j;
+	PROF_BEGIN(PROF_EXPR);
+
+	for (i = 0; i < n; i += m)
+	{
+		m = n - i < EXPR_BLOCK ? n - i : EXPR_BLOCK;
+		memcpy(x, in + i, sizeof(dtype) * m);
+		for (j = 0; j < expr->n_ops; j++) expr_apply(&expr->ops[j], x, expr->scratch, i, m);
+
+		switch (expr->reduce)
+		{
+		case EXPR_REDUCE_SUM:
+			for (k = 0; k < m; k++) acc += x[k];
+			break;
+		case EXPR_REDUCE_SUMSQ:
+			acc += simd_dot(x, x, m);
+			break;
+		case EXPR_REDUCE_DOT:
+			acc += simd_dot(x, expr->reduce_arr + i, m);
+			break;
+		}
+		if (out) memcpy(out + i, x, sizeof(dtype) * m);
+	}
+	PROF_END(PROF_EXPR, n);
+	return acc;
+}
+
+dtype expr_run_fa(expr_handle expr, const fa_handle fa, dtype* out)
+{
+	/* the chain over the current window of the handle, newest sample first */
+	return expr_run(expr, fa_window(fa), out, fa->length);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          PRINT ARRAY
+*******************************************************************************/
+void print_arr1d(dtype* arr, const size_t size, type_t data_type)
+{
+	/*
+	* Arguments
+	- r : Pointer to output array of autocorrelation of length audocor_len.
+	- x : Pointer to input array of length nx+nr. Input data must be padded with nr consecutive zeros at the beginning.
+	- autocor_len : Length of autocorrelation vector
+	- lag : Length of lag
+
+	Description
+	-	This routine performs the autocorrelation of the input array x.
+		It is assumed that the length of the input array, x, is a multiple of 2
+		and the length of the output array, r, is a multiple of 4.
+		The assembly routine computes 4 output samples at a time.
+		It is assumed that input vector x is padded with nr no of zeros in the beginning.
+	*/
+
+	char* fn = NULL;
+	int i;
+
+	// data type
+	if (!(strcmp(data_type, "int") && strcmp(data_type, "int32") && strcmp(data_type, "signed int") && strcmp(data_type, "signed int32")))
+		fn = "%d ";
+
+	else if (!(strcmp(data_type, "uint") && strcmp(data_type, "uint32") && strcmp(data_type, "unsigned int") && strcmp(data_type, "unsigned int32")))
+		fn = "%u ";
+
+	else if (!(strcmp(data_type, "short") && strcmp(data_type, "int16") && strcmp(data_type, "signed short") && strcmp(data_type, "signed int16")))
+		fn = "%d ";
+
+	else if (!(strcmp(data_type, "ushort") && strcmp(data_type, "uint16") && strcmp(data_type, "unsigned short") && strcmp(data_type, "unsigned int16")))
+		fn = "%u ";
+
+	else if (!(strcmp(data_type, "float") && strcmp(data_type, "float32") && strcmp(data_type, "signed float") && strcmp(data_type, "signed float32")))
+		fn = "%.3f ";
+
+	else if (!(strcmp(data_type, "double") && strcmp(data_type, "float64") && strcmp(data_type, "signed double") && strcmp(data_type, "signed float64")))
+		fn = "%.4lf ";
+
+	else
+	{
+		fprintf(stderr, "error : \"(%s)\" is Unsuppored data type \n", data_type);
+		return;
+	}
+
+	for (i = 0; i < size; i++) fprintf(stdout, fn, arr[i]);
+	printf("\n");
+
+	return;
+}
+
+void print_arr1d_pidx(dtype* arr, const size_t size, type_t data_type, pIdx ptr_idx)
+{
+	char* fn = NULL;
+	int i;
+
+	// data type
+	if (!(strcmp(data_type, "int") && strcmp(data_type, "int32") && strcmp(data_type, "signed int") && strcmp(data_type, "signed int32")))
+		fn = "%d ";
+
+	else if (!(strcmp(data_type, "uint") && strcmp(data_type, "uint32") && strcmp(data_type, "unsigned int") && strcmp(data_type, "unsigned int32")))
+		fn = "%u ";
+
+	else if (!(strcmp(data_type, "short") && strcmp(data_type, "int16") && strcmp(data_type, "signed short") && strcmp(data_type, "signed int16")))
+		fn = "%d ";
+
+	else if (!(strcmp(data_type, "ushort") && strcmp(data_type, "uint16") && strcmp(data_type, "unsigned short") && strcmp(data_type, "unsigned int16")))
+		fn = "%u ";
+
+	else if (!(strcmp(data_type, "float") && strcmp(data_type, "float32") && strcmp(data_type, "signed float") && strcmp(data_type, "signed float32")))
+		fn = "%.3f ";
+
+	else if (!(strcmp(data_type, "double") && strcmp(data_type, "float64") && strcmp(data_type, "signed double") && strcmp(data_type, "signed float64")))
+		fn = "%.4lf ";
+
+	else
+	{
+		fprintf(stderr, "error : \"(%s)\" is Unsuppored data type \n", data_type);
+		return;
+	}
+
+	for (i = ptr_idx; i < ptr_idx + size; i++) fprintf(stdout, fn, arr[i]);
+	printf("\n");
+
+	return;
+}
+
+void print_arr1d_fa(const fa_handle fa, type_t data_type)
+{
+	print_arr1d(fa_window(fa), fa->length, data_type);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          ADAPTIVE ALGORITHM
+*******************************************************************************/
+dtype least_mean_square(dtype* x, dtype* h, dtype* desired, dtype* y, dtype adapt_rate, dtype error,
+	const int n_coeffecients, const int n_output_samples)
+{
+	/*
+	* Arguments
+	- x : Pointer to input samples
+	- h : Pointer to the coefficient array
+	- desired : Pointer to the desired output array
+	- y : Pointer to filtered output array
+	- adapt_rate : Adaptation rate error Initial error (mu)
+	- n_coeffocients : Number of coefficients
+	- n_output_samples : Number of output samples
+
+	Description
+	-	The least_mean_square implements an LMS adaptive filter.
+		Given an actual input signal and a desired input signal,
+		the filter produces an output signal, the final coefficient values,
+		and returns the final output error signal.
+	*/
+
+	int i, j0;
+	dtype sum;
+	PROF_BEGIN(PROF_LMS);
+
+	for (i = 0; i < n_output_samples; i++)
+	{
+		// w(n+1) = w(n) + \mu*x(n)*e(n) fused with the output sum, one pass over the taps
+		j0 = (i == 0 && n_coeffecients > 0); // x[-1] does not exist
+		sum = j0 ? h[0] * x[0] : 0;
+		sum += simd_lms_update_dot(h + j0, x + i + j0, x + i + j0 - 1, n_coeffecients - j0, 1, adapt_rate * error);
+		y[i] = sum;
+		error = desired[i] - sum;
+		TRACE(TRACE_LMS, i, 0, sum, desired[i], error);
+	}
+	PROF_END(PROF_LMS, n_output_samples);
+	return error;
+}
+
+dtype fast_least_mean_square(dtype* x, dtype* h, dtype* desired, dtype* y, dtype adapt_rate, dtype error,
+	const int n_coeffecients, const int n_output_samples, pIdx x_idx, pIdx h_idx, pIdx d_idx, pIdx y_idx)
+{
+	/*
+	* Arguments
+	- x : Pointer to input samples
+	- h : Pointer to the coefficient array
+	- desired : Pointer to the desired output array
+	- y : Pointer to filtered output array
+	- adapt_rate : Adaptation rate error Initial error
+	- n_coeffocients : Number of coefficients
+	- n_output_samples : Number of output samples
+	- x_idx : Index of fast array x
+	- h_idx : Index of fast array h
+	- d_idx : Index of fast array d
+	- y_idx : Index of fast array y
+
+	Description
+	-	The least_mean_square implements an LMS adaptive filter.
+		Given an actual input signal and a desired input signal,
+		the filter produces an output signal, the final coefficient values,
+		and returns the final output error signal.
+	*/
+
+	int i, j0;
+	dtype sum;
+	PROF_BEGIN(PROF_LMS);
+
+	for (i = y_idx; i < n_output_samples + y_idx; i++)
+	{
+		// w(n+1) = w(n) + \mu*x(n)*e(n) fused with the output sum, one pass over the taps
+		j0 = (i + h_idx == 0 && n_coeffecients > 0); // x[-1] does not exist
+		sum = j0 ? h[h_idx] * x[0] : 0;
+		sum += simd_lms_update_dot(h + h_idx + j0, x + i + h_idx + j0, x + i + h_idx + j0 - 1, n_coeffecients - j0, 1, adapt_rate * error);
+		y[i] = sum;
+		error = desired[i] - sum;
+		TRACE(TRACE_LMS, i, 0, sum, desired[i], error);
+	}
+	PROF_END(PROF_LMS, n_output_samples);
+	return error;
+}
+
+dtype least_mean_square_fa(const fa_handle x, dtype* h, dtype desired, dtype* y, dtype adapt_rate)
+{
+	/*
+	* Arguments
+	- x : Fast array of input samples, the newest sample is x's window[0]
+	- h : Pointer to the coefficient array of length x->length
+	- desired : Desired output of the current sample
+	- y : Pointer to the filtered output of the current sample (may be NULL)
+	- adapt_rate : Adaptation rate (mu)
+
+	Description
+	-	One LMS iteration on the current window of x.
+		Call after pushing each input sample; returns the output error.
+	*/
+
+	dtype* w = fa_window(x);
+	dtype sum, error;
+	size_t j;
+	PROF_BEGIN(PROF_LMS);
+
+	sum = simd_dot(h, w, x->length);
+	error = desired - sum;
+	for (j = 0; j < x->length; j++) h[j] += adapt_rate * error * w[j]; // w(n+1) = w(n) + \mu*x(n)*e(n)
+
+	if (y != NULL) *y = sum;
+	PROF_END(PROF_LMS, 1);
+	return error;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          LMS FILTER ENGINE
+*******************************************************************************/
+#define LMS_ENERGY_REFRESH 4096 // pushes between exact recomputations of the nlms input energy
+
+lms_handle lms_create(const int type, const size_t n_taps, const dtype adapt_rate)
+{
+	/*
+	* Arguments
+	- type : LMS_STANDARD, LMS_NORMALIZED or LMS_LEAKY
+	- n_taps : Number of coefficients
+	- adapt_rate : Adaptation rate (mu)
+
+	Description
+	-	Creates a stateful adaptive filter with zero coefficients.
+		The input history is a fast array of n_taps + 1 samples :
+		the update of sample n - 1 is deferred and fused with the
+		output dot product of sample n, so every sample costs one pass over the taps.
+		Returns NULL on failure.
+	*/
+
+	lms_handle lms;
+
+	if (n_taps == 0 || type < LMS_STANDARD || type > LMS_LEAKY)
+	{
+		fprintf(stderr, "lms_create : invalid arguments \n");
+		return NULL;
+	}
+
+	if ((lms = (lms_handle)calloc(1, sizeof(lms_filter_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	lms->type = type;
+	lms->n_taps = n_taps;
+	lms->adapt_rate = adapt_rate;
+	lms->leakage = LMS_DEFAULT_LEAKAGE;
+	lms->regularization = LMS_DEFAULT_REGULARIZATION;
+	lms->taps = (dtype*)fa_aligned_malloc(sizeof(dtype) * n_taps);
+	lms->history = fa_create(n_taps + 1);
+
+	if (lms->taps == NULL || lms->history == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		lms_destroy(lms);
+		return NULL;
+	}
+	lms_reset(lms);
+
+	return lms;
+}
+
+void lms_destroy(lms_handle lms)
+{
+	if (lms == NULL) return;
+	fa_aligned_free(lms->taps);
+	fa_destroy(lms->history);
+	free(lms);
+}
+
+void lms_reset(lms_handle lms)
+{
+	zeros(lms->taps, lms->n_taps);
+	zeros_fa(lms->history);
+	lms->error = 0;
+	lms->beta = 1;
+	lms->gain = 0;
+	lms->energy = 0;
+	lms->count = 0;
+}
+
+void lms_set_leakage(lms_handle lms, const dtype leakage) { lms->leakage = leakage; }
+void lms_set_regularization(lms_handle lms, const dtype regularization) { lms->regularization = regularization; }
+
+static void lms_flush(lms_handle lms)
+{
+	/* applies the deferred update of the last sample */
+	dtype* w = fa_window(lms->history);
+	size_t k;
+
+	for (k = 0; k < lms->n_taps; k++) lms->taps[k] = lms->beta * lms->taps[k] + lms->gain * w[k];
+	lms->beta = 1;
+	lms->gain = 0;
+}
+
+const dtype* lms_taps(lms_handle lms)
+{
+	lms_flush(lms);
+	return lms->taps;
+}
+
+dtype lms_process_sample(lms_handle lms, const dtype x, const dtype desired, dtype* y)
+{
+	/*
+	* Arguments
+	- lms : Adaptive filter
+	- x : New input sample
+	- desired : Desired output of this sample
+	- y : Pointer to the filtered output (may be NULL)
+
+	Description
+	-	w(n) = beta * w(n-1) + g(n-1) * x(n-1), y(n) = w(n) . x(n), e(n) = d(n) - y(n)
+		LMS			: beta = 1, g = mu * e
+		NLMS		: beta = 1, g = mu * e / (eps + |x(n)|^2)
+		Leaky LMS	: beta = 1 - mu * leakage, g = mu * e
+		Returns e(n).
+	*/
+
+	dtype* w;
+	dtype out, leaving;
+
+	fa_handle_push(lms->history, x);
+	w = fa_window(lms->history); // w[0 ..] : x(n), w[1 ..] : x(n - 1)
+
+	out = simd_lms_update_dot(lms->taps, w, w + 1, lms->n_taps, lms->beta, lms->gain);
+	lms->error = desired - out;
+
+	switch (lms->type)
+	{
+	case LMS_NORMALIZED:
+		leaving = w[lms->n_taps];
+		lms->energy += x * x - leaving * leaving;
+		if (++lms->count >= LMS_ENERGY_REFRESH)
+		{
+			lms->energy = simd_dot(w, w, lms->n_taps);
+			lms->count = 0;
+		}
+		if (lms->energy < 0) lms->energy = 0;
+		lms->gain = lms->adapt_rate * lms->error / (lms->regularization + lms->energy);
+		break;
+	case LMS_LEAKY:
+		lms->beta = 1 - lms->adapt_rate * lms->leakage;
+		lms->gain = lms->adapt_rate * lms->error;
+		break;
+	default:
+		lms->gain = lms->adapt_rate * lms->error;
+		break;
+	}
+
+	if (y != NULL) *y = out;
+	return lms->error;
+}
+
+dtype lms_process(lms_handle lms, const dtype* x, const dtype* desired, dtype* y, dtype* error, const size_t n)
+{
+	/*
+	* Arguments
+	- x : Input block
+	- desired : Desired block
+	- y : Output block (may be NULL)
+	- error : Error block (may be NULL)
+	- n : Number of samples
+
+	Description
+	-	lms_process_sample over a block, returns the last error.
+	*/
+
+	dtype out, e = lms->error;
+	size_t i;
+	PROF_BEGIN(PROF_LMS);
+
+	for (i = 0; i < n; i++)
+	{
+		e = lms_process_sample(lms, x[i], desired[i], &out);
+		if (y != NULL) y[i] = out;
+		if (error != NULL) error[i] = e;
+	}
+	PROF_END(PROF_LMS, n);
+	return e;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          CHANNEL BANK (MULTI-CHANNEL FIR / LMS)
+*******************************************************************************/
+static bank_handle bank_alloc(const int kind, const size_t n_channels, const size_t n_taps, const size_t block)
+{
+	bank_handle bank;
+	size_t frames;
+
+	if (n_channels == 0 || n_taps == 0)
+	{
+		fprintf(stderr, "bank_create : n_channels and n_taps must be positive \n");
+		return NULL;
+	}
+
+	if ((bank = (bank_handle)calloc(1, sizeof(fa_bank_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	bank->kind = kind;
+	bank->n_channels = n_channels;
+	bank->stride = (n_channels + BANK_LANES - 1) / BANK_LANES * BANK_LANES;
+	bank->n_taps = n_taps;
+	bank->block = block ? block : FIR_DEFAULT_BLOCK;
+
+	// fir : n_taps + block - 1 frames, lms : one more for the deferred update
+	frames = n_taps + bank->block;
+	for (bank->size = 1; bank->size < frames; bank->size <<= 1);
+	bank->mask = bank->size - 1;
+
+	bank->taps = (dtype*)fa_aligned_malloc(sizeof(dtype) * n_taps * bank->stride);
+	bank->ring = (dtype*)fa_aligned_malloc(sizeof(dtype) * 2 * bank->size * bank->stride);
+	if (kind == BANK_LMS)
+	{
+		bank->beta = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+		bank->gain = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+		bank->energy = (dtype*)fa_aligned_malloc(sizeof(dtype) * bank->stride);
+	}
+
+	if (bank->taps == NULL || bank->ring == NULL
+		|| (kind == BANK_LMS && (bank->beta == NULL || bank->gain == NULL || bank->energy == NULL)))
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		bank_destroy(bank);
+		return NULL;
+	}
+
+	zeros(bank->taps, n_taps * bank->stride);
+	bank_reset(bank);
+	return bank;
+}
+
+bank_handle bank_fir_create(const size_t n_channels, const size_t n_taps, const size_t block)
+{
+	/*
+	* Arguments
+	- n_channels : Number of channels
+	- n_taps : Taps per channel (set with bank_set_taps, zero initially)
+	- block : Frames per pass, 0 selects FIR_DEFAULT_BLOCK
+
+	Description
+	-	Creates a bank of FIR filters. Returns NULL on failure.
+	*/
+
+	return bank_alloc(BANK_FIR, n_channels, n_taps, block);
+}
+
+bank_handle bank_lms_create(const int lms_type, const size_t n_channels, const size_t n_taps, const dtype adapt_rate, const size_t block)
+{
+	/*
+	* Arguments
+	- lms_type : LMS_STANDARD, LMS_NORMALIZED or LMS_LEAKY
+	- n_channels : Number of channels
+	- n_taps : Taps per channel
+	- adapt_rate : Adaptation rate (mu) of every channel
+	- block : Frames per pass, 0 selects FIR_DEFAULT_BLOCK
+
+	Description
+	-	Creates a bank of adaptive filters with the same update rule as lms_process_sample.
+		Returns NULL on failure.
+	*/
+
+	bank_handle bank;
+
+	if (lms_type < LMS_STANDARD || lms_type > LMS_LEAKY)
+	{
+		fprintf(stderr, "bank_lms_create : invalid lms type \n");
+		return NULL;
+	}
+	if ((bank = bank_alloc(BANK_LMS, n_channels, n_taps, block)) == NULL) return NULL;
+
+	bank->lms_type = lms_type;
+	bank->adapt_rate = adapt_rate;
+	bank->leakage = LMS_DEFAULT_LEAKAGE;
+	bank->regularization = LMS_DEFAULT_REGULARIZATION;
+	return bank;
+}
+
+void bank_destroy(bank_handle bank)
+{
+	if (bank == NULL) return;
+	pool_destroy(bank->pool);
+	fa_aligned_free(bank->taps);
+	fa_aligned_free(bank->ring);
+	fa_aligned_free(bank->beta);
+	fa_aligned_free(bank->gain);
+	fa_aligned_free(bank->energy);
+	free(bank);
+}
+
+void bank_reset(bank_handle bank)
+{
+	zeros(bank->ring, 2 * bank->size * bank->stride);
+	bank->idx = 0;
+	bank->count = 0;
+	if (bank->kind == BANK_LMS)
+	{
+		ones(bank->beta, bank->stride);
+		zeros(bank->gain, bank->stride);
+		zeros(bank->energy, bank->stride);
+	}
+}
+
+int bank_set_threads(bank_handle bank, int n_threads)
+{
+	/*
+	Description
+	-	n_threads > 1 splits the channel groups of every pass across a worker pool,
+		<= 0 uses every cpu, 1 returns to single threaded processing.
+		Returns the number of workers in use.
+	*/
+
+	pool_destroy(bank->pool);
+	bank->pool = NULL;
+
+	if (n_threads <= 0) n_threads = cpu_count();
+	if (n_threads > 1) bank->pool = pool_create(n_threads);
+	return pool_size(bank->pool);
+}
+
+static void bank_flush(bank_handle bank, const size_t c)
+{
+	/* applies the deferred lms update of channel c */
+	const dtype* w = bank->ring + (size_t)bank->idx * bank->stride + c;
+	size_t k;
+
+	if (bank->kind != BANK_LMS) return;
+	for (k = 0; k < bank->n_taps; k++)
+		bank->taps[k * bank->stride + c] = bank->beta[c] * bank->taps[k * bank->stride + c] + bank->gain[c] * w[k * bank->stride];
+	bank->beta[c] = 1;
+	bank->gain[c] = 0;
+}
+
+void bank_set_taps(bank_handle bank, const size_t channel, const dtype* taps)
+{
+	size_t k;
+	bank_flush(bank, channel);
+	for (k = 0; k < bank->n_taps; k++) bank->taps[k * bank->stride + channel] = taps[k];
+}
+
+void bank_get_taps(bank_handle bank, const size_t channel, dtype* taps)
+{
+	size_t k;
+	bank_flush(bank, channel);
+	for (k = 0; k < bank->n_taps; k++) taps[k] = bank->taps[k * bank->stride + channel];
+}
+
+static void bank_fir_group(bank_handle bank, const size_t c0)
+{
+	const size_t S = bank->stride, L = bank->n_taps, C = bank->n_channels, c = bank->n_frames;
+	const dtype* w;
+	dtype acc[BANK_LANES];
+	size_t j, l;
+
+	for (j = 0; j < c; j++)
+	{
+		w = bank->ring + ((size_t)bank->idx + c - 1 - j) * S + c0;
+		simd_lanes_fir(bank->taps + c0, w, L, S, acc);
+
+		for (l = 0; l < BANK_LANES && c0 + l < C; l++) bank->out[(bank->offset + j) * C + c0 + l] = acc[l];
+	}
+}
+
+static void bank_lms_group(bank_handle bank, const size_t c0)
+{
+	const size_t S = bank->stride, L = bank->n_taps, C = bank->n_channels, c = bank->n_frames;
+	dtype* __restrict beta = bank->beta + c0, * __restrict gain = bank->gain + c0, * __restrict energy = bank->energy + c0;
+	const dtype* cur, * x;
+	dtype acc[BANK_LANES], e[BANK_LANES], leaving, d;
+	size_t j, k, l, frame;
+
+	for (j = 0; j < c; j++)
+	{
+		x = bank->ring + ((size_t)bank->idx + c - 1 - j) * S + c0; // newest frame of sample j
+
+		// deferred update of the previous sample fused with the output of this one
+		simd_lanes_lms(bank->taps + c0, x, L, S, beta, gain, acc);
+
+		frame = bank->offset + j;
+		for (l = 0; l < BANK_LANES; l++)
+		{
+			d = (c0 + l < C) ? bank->desired[frame * C + c0 + l] : 0;
+			e[l] = d - acc[l];
+		}
+
+		switch (bank->lms_type)
+		{
+		case LMS_NORMALIZED:
+			if ((bank->count + frame + 1) % LMS_ENERGY_REFRESH == 0)
+			{
+				for (l = 0; l < BANK_LANES; l++) energy[l] = 0;
+				for (k = 0, cur = x; k < L; k++, cur += S)
+					for (l = 0; l < BANK_LANES; l++) energy[l] += cur[l] * cur[l];
+			}
+			else
+			{
+				for (l = 0; l < BANK_LANES; l++)
+				{
+					leaving = x[L * S + l];
+					energy[l] += x[l] * x[l] - leaving * leaving;
+					if (energy[l] < 0) energy[l] = 0;
+				}
+			}
+			for (l = 0; l < BANK_LANES; l++)
+			{
+				beta[l] = 1;
+				gain[l] = bank->adapt_rate * e[l] / (bank->regularization + energy[l]);
+			}
+			break;
+		case LMS_LEAKY:
+			for (l = 0; l < BANK_LANES; l++)
+			{
+				beta[l] = 1 - bank->adapt_rate * bank->leakage;
+				gain[l] = bank->adapt_rate * e[l];
+			}
+			break;
+		default:
+			for (l = 0; l < BANK_LANES; l++) gain[l] = bank->adapt_rate * e[l];
+			break;
+		}
+
+		for (l = 0; l < BANK_LANES && c0 + l < C; l++)
+		{
+			if (bank->out != NULL) bank->out[frame * C + c0 + l] = acc[l];
+			if (bank->error != NULL) bank->error[frame * C + c0 + l] = e[l];
+		}
+	}
+}
+
+static void bank_worker(void* arg, int worker, int n_workers)
+{
+	bank_handle bank = (bank_handle)arg;
+	size_t g, g0, g1;
+
+	pool_range(bank->stride / BANK_LANES, worker, n_workers, g0, g1);
+	for (g = g0; g < g1; g++)
+	{
+		if (bank->kind == BANK_FIR) bank_fir_group(bank, g * BANK_LANES);
+		else bank_lms_group(bank, g * BANK_LANES);
+	}
+}
+
+void bank_process(bank_handle bank, const dtype* in, const dtype* desired, dtype* out, dtype* error, const size_t n)
+{
+	/*
+	* Arguments
+	- in : Interleaved input, n frames of n_channels samples
+	- desired : Interleaved desired signal (lms only)
+	- out : Interleaved output (may be NULL for lms)
+	- error : Interleaved error (lms only, may be NULL)
+	- n : Number of frames
+
+	Description
+	-	Each pass pushes up to block frames into the mirrored frame ring,
+		then the channel groups are processed, in parallel when a pool is set.
+	*/
+
+	const size_t S = bank->stride, C = bank->n_channels;
+	size_t c, j, done;
+	dtype* dst;
+	PROF_BEGIN(PROF_BANK);
+
+	bank->in = in, bank->desired = desired, bank->out = out, bank->error = error;
+
+	for (done = 0; done < n; done += c)
+	{
+		c = (n - done < bank->block) ? n - done : bank->block;
+
+		for (j = 0; j < c; j++) // frame push, padded channels stay zero
+		{
+			bank->idx = (bank->idx - 1) & (pIdx)bank->mask;
+			dst = bank->ring + (size_t)bank->idx * S;
+			memcpy(dst, in + (done + j) * C, sizeof(dtype) * C);
+			memcpy(dst + bank->size * S, dst, sizeof(dtype) * C);
+		}
+
+		bank->n_frames = c;
+		bank->offset = done;
+		pool_run(bank->pool, bank_worker, bank);
+	}
+	bank->count += n;
+	PROF_END(PROF_BANK, n * C);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          OPEARTION
+*******************************************************************************/
+void autocor(dtype* __restrict r, const dtype* __restrict x, const int autocor_len, const int lag)
+{
+	/*
+	* Arguments
+	- r : Pointer to output array of autocorrelation of length lag.
+	- x : Pointer to input array of length autocor_len + lag. The first lag samples are history (or zero padding).
+	- autocor_len : Length of autocorrelation vector
+	- lag : Length of lag
+
+	Description
+	-	This routine performs the autocorrelation of the input array x,
+		r(i) = x(lag) * x(lag - i) + ... + x(lag + len - 1) * x(lag + len - 1 - i), i = 0 .. lag - 1.
+		Short lags use the direct sum (autocor_direct),
+		long lags the FFT path (autocor_fft), see autocor_use_fft.
+	*/
+
+	if (autocor_use_fft(autocor_len, lag)) autocor_fft(r, x, autocor_len, lag);
+	else autocor_direct(r, x, autocor_len, lag);
+}
+
+void fast_autocor(dtype* __restrict r, const dtype* __restrict x, const int autocor_len, const int lag, pIdx r_idx, pIdx x_idx)
+{
+	/*
+	* Arguments
+	- r : Pointer to output fast array, the lag values are written to r[r_idx ..]
+	- x : Pointer to input fast array, the autocor_len + lag samples are read from x[x_idx ..]
+	- autocor_len : Length of autocorrelation vector
+	- lag : Length of lag
+	- r_idx : Pointer index of r
+	- x_idx : Pointer index of x
+
+	Description
+	-	autocor() on the windows of fast arrays.
+	*/
+
+	autocor(r + r_idx, x + x_idx, autocor_len, lag);
+}
+
+dtype fir_filtering(dtype* x1, dtype* x2, const size_t size)
+{
+	/*
+	* Arguments
+	- x1 : Input array 1
+	- x2 : Input array 2
+	- size : Length of x1, x2 array
+
+	Description
+	-	This routine performs the fir filtering of the input array x1 and x2
+	*/
+
+	dtype y;
+	PROF_BEGIN(PROF_FIR);
+
+	y = simd_dot(x1, x2, size);
+	PROF_END(PROF_FIR, size);
+	return y;
+}
+
+dtype fast_fir_filtering(dtype* x1, dtype* x2, const size_t size, pIdx idx)
+{
+	/*
+	* Arguments
+	- x1 : Input fast array 1
+	- x2 : Input fast array 2
+	- size : Length of x1, x2 array
+
+	Description
+	-	This routine performs the fir filtering of the input array x1 and x2
+		using fast array
+	*/
+
+	dtype y;
+	PROF_BEGIN(PROF_FIR);
+
+	y = simd_dot(x1 + idx, x2 + idx, size);
+	PROF_END(PROF_FIR, size);
+	return y;
+}
+
+dtype fast_fir_filtering_dpidx(dtype* x1, dtype* x2, const  size_t size, pIdx idx1, pIdx idx2)
+{
+	/*
+	* Arguments
+	- x1 : Input fast array 1
+	- x2 : Input fast array 2
+	- size : Length of x1, x2 array
+	- idx1 : Pointer index of x1
+	- idx2 : pointer index of x2
+
+	Description
+	-	This routine performs the fir filtering of the input array x1 and x2
+		using fast array
+
+	Equation
+	-	result = x1(idx1)*x2(idx2) + x1(idx1 + 1)*x2(idx2 + 1) + ... + x1(idx1 + L - 1)*x2(idx2 + L - 1)
+	*/
+	dtype y;
+	PROF_BEGIN(PROF_FIR);
+
+	y = simd_dot(x1 + idx1, x2 + idx2, size);
+	PROF_END(PROF_FIR, size);
+	return y;
+}
+
+void autocor_fa(dtype* __restrict r, const fa_handle x, const int lag)
+{
+	/*
+	* Arguments
+	- r : Pointer to output array of autocorrelation of length lag.
+	- x : Fast array, the current window is used as input
+	- lag : Length of lag (0 < lag < x->length)
+
+	Description
+	-	autocor() on the current window. The first lag samples of the window
+		take the role of the zero padding, the remaining length - lag samples
+		are correlated. A lag outside the range leaves nothing to correlate :
+		r is cleared and an error is printed.
+	*/
+
+	if (lag <= 0 || (size_t)lag >= x->length)
+	{
+		fprintf(stderr, "autocor_fa : lag %d out of range 1 .. %zu \n", lag, x->length - 1);
+		if (lag > 0) memset(r, 0, sizeof(dtype) * lag);
+		return;
+	}
+
+	autocor(r, fa_window(x), (int)(x->length - lag), lag);
+}
+
+dtype fir_filtering_fa(const fa_handle x, dtype* h)
+{
+	return fir_filtering(fa_window(x), h, x->length);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          FIR FILTER ENGINE
+*******************************************************************************/
+fir_handle fir_create(const dtype* taps, const size_t n_taps, const size_t block)
+{
+	/*
+	* Arguments
+	- taps : Filter coefficients, taps[0] weights the newest sample (copied)
+	- n_taps : Number of coefficients
+	- block : Samples per internal pass, 0 selects FIR_DEFAULT_BLOCK
+
+	Description
+	-	Creates a stateful FIR filter, y(n) = h(0)*x(n) + ... + h(L-1)*x(n-L+1).
+		The input history lives in a fast array that holds n_taps + block - 1
+		samples so that every output of a pass reads one contiguous window.
+		Returns NULL on failure.
+	*/
+
+	fir_handle fir;
+
+	if (n_taps == 0)
+	{
+		fprintf(stderr, "fir_create : n_taps must be positive \n");
+		return NULL;
+	}
+
+	if ((fir = (fir_handle)malloc(sizeof(fir_filter_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	fir->n_taps = n_taps;
+	fir->block = block ? block : FIR_DEFAULT_BLOCK;
+	fir->taps = (dtype*)fa_aligned_malloc(sizeof(dtype) * n_taps);
+	fir->history = fa_create(n_taps + fir->block - 1);
+
+	if (fir->taps == NULL || fir->history == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		fir_destroy(fir);
+		return NULL;
+	}
+	fir_set_taps(fir, taps);
+
+	return fir;
+}
+
+void fir_destroy(fir_handle fir)
+{
+	if (fir == NULL) return;
+	fa_aligned_free(fir->taps);
+	fa_destroy(fir->history);
+	free(fir);
+}
+
+void fir_reset(fir_handle fir)
+{
+	zeros_fa(fir->history);
+}
+
+void fir_set_taps(fir_handle fir, const dtype* taps)
+{
+	memcpy(fir->taps, taps, sizeof(dtype) * fir->n_taps);
+}
+
+void fir_process(fir_handle fir, const dtype* in, dtype* out, const size_t n)
+{
+	/*
+	* Arguments
+	- fir : FIR filter
+	- in : Input block, in[0] is the oldest sample
+	- out : Output block (may be equal to in)
+	- n : Number of samples
+
+	Description
+	-	Each pass pushes up to block samples into the history with one block push.
+		Output j of the pass then reads the window at w + (c - 1 - j),
+		so four consecutive outputs share one pass over the taps
+		(simd_dot_shift4) and the taps are loaded once for all four.
+	*/
+
+	const dtype* h = fir->taps;
+	const size_t L = fir->n_taps;
+	dtype y4[4], * w;
+	size_t c, j, done;
+	PROF_BEGIN(PROF_FIR);
+
+	for (done = 0; done < n; done += c)
+	{
+		c = (n - done < fir->block) ? n - done : fir->block;
+
+		push_block_fa(fir->history, in + done, c);
+		w = fa_window(fir->history);
+
+		for (j = 0; j + 4 <= c; j += 4)
+		{
+			simd_dot_shift4(h, w + (c - 4 - j), L, y4); // windows of outputs j+3, j+2, j+1, j
+			out[done + j] = y4[3];
+			out[done + j + 1] = y4[2];
+			out[done + j + 2] = y4[1];
+			out[done + j + 3] = y4[0];
+		}
+		for (; j < c; j++) out[done + j] = simd_dot(h, w + (c - 1 - j), L);
+	}
+	PROF_END(PROF_FIR, n * L);
+}
+
+dtype fir_process_sample(fir_handle fir, const dtype in)
+{
+	fa_handle_push(fir->history, in);
+	return simd_dot(fir->taps, fa_window(fir->history), fir->n_taps);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          POLYPHASE RESAMPLER
+*******************************************************************************/
+static size_t gcd_size(size_t a, size_t b)
+{
+	while (b) { size_t t = a % b; a = b; b = t; }
+	return a;
+}
+
+resampler_handle resampler_create(const dtype* taps, const size_t n_taps, const size_t up, const size_t down, const size_t block)
+{
+	/*
+	* Arguments
+	- taps : Prototype lowpass at up * input rate, taps[0] weights the newest sample (copied)
+	- n_taps : Number of coefficients
+	- up : Interpolation factor L
+	- down : Decimation factor M
+	- block : Input samples per internal pass, 0 selects FIR_DEFAULT_BLOCK
+
+	Description
+	-	Creates a stateful L/M resampler, output rate = input rate * up / down.
+		Output m is y(m) = sum h(p + k*up) * x(n - k) with t = m * down,
+		n = t / up and p = t % up, so no zero stuffed input and no discarded
+		output is ever computed. The first output is aligned with the first input.
+		Returns NULL on failure.
+	*/
+
+	resampler_handle rs;
+	size_t g, p, k;
+
+	if (n_taps == 0 || up == 0 || down == 0)
+	{
+		fprintf(stderr, "resampler_create : n_taps, up and down must be positive \n");
+		return NULL;
+	}
+
+	if ((rs = (resampler_handle)calloc(1, sizeof(resampler_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	g = gcd_size(up, down);
+	rs->up = up / g;
+	rs->down = down / g;
+	rs->n_taps = n_taps;
+	rs->phase_taps = (n_taps + rs->up - 1) / rs->up;
+	rs->block = block ? block : FIR_DEFAULT_BLOCK;
+	rs->phases = (dtype*)fa_aligned_malloc(sizeof(dtype) * rs->up * rs->phase_taps);
+	rs->history = fa_create(rs->phase_taps + rs->block - 1);
+
+	if (rs->phases == NULL || rs->history == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		resampler_destroy(rs);
+		return NULL;
+	}
+
+	for (p = 0; p < rs->up; p++)
+	{
+		for (k = 0; k < rs->phase_taps; k++)
+		{
+			const size_t i = p + k * rs->up;
+			rs->phases[p * rs->phase_taps + k] = i < n_taps ? taps[i] : 0;
+		}
+	}
+
+	return rs;
+}
+
+void resampler_destroy(resampler_handle rs)
+{
+	if (rs == NULL) return;
+	fa_aligned_free(rs->phases);
+	fa_destroy(rs->history);
+	free(rs);
+}
+
+void resampler_reset(resampler_handle rs)
+{
+	zeros_fa(rs->history);
+	rs->next = 0;
+}
+
+size_t resampler_max_output(const resampler_handle rs, const size_t n)
+{
+	/* upper bound of the outputs of resampler_process for n inputs */
+	return (rs->up * n + rs->down - 1) / rs->down;
+}
+
+size_t resampler_process(resampler_handle rs, const dtype* in, const size_t n, dtype* out)
+{
+	/*
+	* Arguments
+	- rs : Resampler
+	- in : Input block, in[0] is the oldest sample
+	- n : Number of input samples
+	- out : Output block of at least resampler_max_output(rs, n) samples
+
+	Description
+	-	Each pass pushes up to block samples into the history with one block push.
+		An output at upsampled time t of the pass reads phase t % up against the
+		window of input t / up, which starts at w + (c - 1 - t / up).
+		Outputs m, m + up, m + 2up and m + 3up use the same phase on windows
+		down samples apart, so they share one pass over the phase taps
+		(simd_dot_stride4).
+		Returns the number of outputs written.
+	*/
+
+	const size_t K = rs->phase_taps, up = rs->up, down = rs->down;
+	size_t c, done, r, i, m = 0, t = rs->next;
+	dtype y4[4], * w;
+	PROF_BEGIN(PROF_RESAMPLE);
+
+	for (done = 0; done < n; done += c)
+	{
+		c = (n - done < rs->block) ? n - done : rs->block;
+
+		push_block_fa(rs->history, in + done, c);
+		w = fa_window(rs->history);
+
+		for (; t + (4 * up - 1) * down < up * c; t += 4 * up * down, m += 4 * up)
+		{
+			for (r = 0; r < up; r++)
+			{
+				i = (t + r * down) / up;
+				simd_dot_stride4(rs->phases + (t + r * down - i * up) * K, w + (c - 1 - i - 3 * down), K, down, y4);
+				out[m + r] = y4[3];
+				out[m + r + up] = y4[2];
+				out[m + r + 2 * up] = y4[1];
+				out[m + r + 3 * up] = y4[0];
+			}
+		}
+		for (; t < up * c; t += down)
+		{
+			i = t / up;
+			out[m++] = simd_dot(rs->phases + (t - i * up) * K, w + (c - 1 - i), K);
+		}
+		t -= up * c;
+	}
+	rs->next = t;
+
+	PROF_END(PROF_RESAMPLE, n);
+	return m;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          IIR BIQUAD CASCADE
+*******************************************************************************/
+biquad_handle biquad_create(const size_t n_sections, const size_t n_channels, const size_t block)
+{
+	/*
+	* Arguments
+	- n_sections : Second order sections per channel
+	- n_channels : Number of interleaved channels
+	- block : Frames per internal pass, 0 selects BIQUAD_DEFAULT_BLOCK
+
+	Description
+	-	Creates a biquad cascade, every section passes its input through
+		(b0 = 1) until biquad_set_section. Returns NULL on failure.
+	*/
+
+	biquad_handle bq;
+	size_t groups, i, l;
+
+	if (n_sections == 0 || n_channels == 0)
+	{
+		fprintf(stderr, "biquad_create : n_sections and n_channels must be positive \n");
+		return NULL;
+	}
+
+	if ((bq = (biquad_handle)calloc(1, sizeof(biquad_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	bq->n_sections = n_sections;
+	bq->n_channels = n_channels;
+	bq->stride = (n_channels + BIQUAD_LANES - 1) / BIQUAD_LANES * BIQUAD_LANES;
+	bq->block = block ? block : BIQUAD_DEFAULT_BLOCK;
+	groups = bq->stride / BIQUAD_LANES;
+
+	bq->coef = (dtype*)fa_aligned_malloc(sizeof(dtype) * groups * n_sections * 5 * BIQUAD_LANES);
+	bq->state = (dtype*)fa_aligned_malloc(sizeof(dtype) * groups * n_sections * 2 * BIQUAD_LANES);
+	if (bq->stride != n_channels && n_channels > 1) bq->work = (dtype*)fa_aligned_malloc(sizeof(dtype) * bq->block * bq->stride);
+
+	if (bq->coef == NULL || bq->state == NULL || (bq->work == NULL && bq->stride != n_channels && n_channels > 1))
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		biquad_destroy(bq);
+		return NULL;
+	}
+
+	if (bq->work) memset(bq->work, 0, sizeof(dtype) * bq->block * bq->stride);
+	memset(bq->coef, 0, sizeof(dtype) * groups * n_sections * 5 * BIQUAD_LANES);
+	for (i = 0; i < groups * n_sections; i++)
+	{
+		for (l = 0; l < BIQUAD_LANES; l++) bq->coef[i * 5 * BIQUAD_LANES + l] = 1; // b0
+	}
+	biquad_reset(bq);
+
+	return bq;
+}
+
+void biquad_destroy(biquad_handle bq)
+{
+	if (bq == NULL) return;
+	fa_aligned_free(bq->coef);
+	fa_aligned_free(bq->state);
+	fa_aligned_free(bq->work);
+	free(bq);
+}
+
+void biquad_reset(biquad_handle bq)
+{
+	memset(bq->state, 0, sizeof(dtype) * (bq->stride / BIQUAD_LANES) * bq->n_sections * 2 * BIQUAD_LANES);
+}
+
+void biquad_set_section(biquad_handle bq, const size_t channel, const size_t section, const dtype coef[5])
+{
+	/*
+	* Arguments
+	- channel : Channel index
+	- section : Section index, section 0 sees the input first
+	- coef : b0, b1, b2, a1, a2 (a0 normalized to 1)
+	*/
+
+	const size_t g = channel / BIQUAD_LANES, l = channel % BIQUAD_LANES;
+	dtype* c = bq->coef + (g * bq->n_sections + section) * 5 * BIQUAD_LANES + l;
+	int j;
+
+	for (j = 0; j < 5; j++) c[j * BIQUAD_LANES] = coef[j];
+}
+
+int biquad_design(const int type, const double f0, const double fs, const double q, const double gain_db, dtype coef[5])
+{
+	/*
+	* Arguments
+	- type : BIQUAD_LOWPASS, BIQUAD_HIGHPASS, BIQUAD_BANDPASS, BIQUAD_NOTCH,
+			BIQUAD_PEAK, BIQUAD_LOWSHELF, BIQUAD_HIGHSHELF
+	- f0 : Corner or center frequency
+	- fs : Sampling frequency
+	- q : Quality factor (0.7071 : butterworth)
+	- gain_db : Gain of the peak and shelf types
+	- coef : b0, b1, b2, a1, a2 for biquad_set_section
+
+	Description
+	-	Audio EQ cookbook (R. Bristow-Johnson) designs, normalized by a0.
+		Returns -1 for an unknown type.
+	*/
+
+	const double w = PI2 * f0 / fs, cw = cos(w), alpha = sin(w) / (2 * q);
+	const double A = pow(10, gain_db / 40), sq = 2 * sqrt(A) * alpha;
+	double b0, b1, b2, a0, a1, a2;
+
+	switch (type)
+	{
+	case BIQUAD_LOWPASS:
+		b0 = (1 - cw) / 2, b1 = 1 - cw, b2 = (1 - cw) / 2;
+		a0 = 1 + alpha, a1 = -2 * cw, a2 = 1 - alpha; break;
+	case BIQUAD_HIGHPASS:
+		b0 = (1 + cw) / 2, b1 = -(1 + cw), b2 = (1 + cw) / 2;
+		a0 = 1 + alpha, a1 = -2 * cw, a2 = 1 - alpha; break;
+	case BIQUAD_BANDPASS:
+		b0 = alpha, b1 = 0, b2 = -alpha;
+		a0 = 1 + alpha, a1 = -2 * cw, a2 = 1 - alpha; break;
+	case BIQUAD_NOTCH:
+		b0 = 1, b1 = -2 * cw, b2 = 1;
+		a0 = 1 + alpha, a1 = -2 * cw, a2 = 1 - alpha; break;
+	case BIQUAD_PEAK:
+		b0 = 1 + alpha * A, b1 = -2 * cw, b2 = 1 - alpha * A;
+		a0 = 1 + alpha / A, a1 = -2 * cw, a2 = 1 - alpha / A; break;
+	case BIQUAD_LOWSHELF:
+		b0 = A * ((A + 1) - (A - 1) * cw + sq), b1 = 2 * A * ((A - 1) - (A + 1) * cw), b2 = A * ((A + 1) - (A - 1) * cw - sq);
+		a0 = (A + 1) + (A - 1) * cw + sq, a1 = -2 * ((A - 1) + (A + 1) * cw), a2 = (A + 1) + (A - 1) * cw - sq; break;
+	case BIQUAD_HIGHSHELF:
+		b0 = A * ((A + 1) + (A - 1) * cw + sq), b1 = -2 * A * ((A - 1) + (A + 1) * cw), b2 = A * ((A + 1) + (A - 1) * cw - sq);
+		a0 = (A + 1) - (A - 1) * cw + sq, a1 = 2 * ((A - 1) - (A + 1) * cw), a2 = (A + 1) - (A - 1) * cw - sq; break;
+	default:
+		fprintf(stderr, "biquad_design : unknown type \n");
+		return -1;
+	}
+
+	coef[0] = (dtype)(b0 / a0), coef[1] = (dtype)(b1 / a0), coef[2] = (dtype)(b2 / a0);
+	coef[3] = (dtype)(a1 / a0), coef[4] = (dtype)(a2 / a0);
+	return 0;
+}
+
+static void biquad_process_mono(biquad_handle bq, const dtype* in, dtype* out, const size_t n)
+{
+	/*
+	* sample by sample through all sections : the recurrence of section s
+	* at sample k only waits for section s - 1, so the sections overlap
+	*/
+
+	const size_t S = bq->n_sections, L = BIQUAD_LANES;
+	const dtype* c;
+	dtype* st, v, y;
+	size_t k, s;
+
+	for (k = 0; k < n; k++)
+	{
+		v = in[k];
+		for (s = 0, c = bq->coef, st = bq->state; s < S; s++, c += 5 * L, st += 2 * L)
+		{
+			y = c[0] * v + st[0];
+			st[0] = c[L] * v - c[3 * L] * y + st[L];
+			st[L] = c[2 * L] * v - c[4 * L] * y;
+			v = y;
+		}
+		out[k] = v;
+	}
+}
+
+void biquad_process(biquad_handle bq, const dtype* in, dtype* out, const size_t n)
+{
+	/*
+	* Arguments
+	- bq : Biquad cascade
+	- in : Interleaved input, n frames of n_channels samples
+	- out : Interleaved output (may be equal to in)
+	- n : Number of frames
+
+	Description
+	-	Each pass copies up to block frames to out (or to the padded work
+		buffer) and runs every section of one channel group over the pass
+		in place before the next group, so the pass stays in cache.
+	*/
+
+	const size_t C = bq->n_channels, S = bq->stride, NS = bq->n_sections, L = BIQUAD_LANES;
+	size_t c, g, j, done;
+	dtype* buf;
+	PROF_BEGIN(PROF_BIQUAD);
+
+	if (C == 1)
+	{
+		biquad_process_mono(bq, in, out, n);
+		PROF_END(PROF_BIQUAD, n);
+		return;
+	}
+
+	for (done = 0; done < n; done += c)
+	{
+		c = (n - done < bq->block) ? n - done : bq->block;
+
+		if (bq->work == NULL)
+		{
+			buf = out + done * C;
+			if (buf != in + done * C) memcpy(buf, in + done * C, sizeof(dtype) * c * C);
+		}
+		else
+		{
+			buf = bq->work; // padded channels stay zero
+			for (j = 0; j < c; j++) memcpy(buf + j * S, in + (done + j) * C, sizeof(dtype) * C);
+		}
+
+		for (g = 0; g < S / L; g++)
+		{
+			simd_biquad_lanes(bq->coef + g * NS * 5 * L, bq->state + g * NS * 2 * L, NS, buf + g * L, c, S);
+		}
+
+		if (bq->work != NULL)
+		{
+			for (j = 0; j < c; j++) memcpy(out + (done + j) * C, buf + j * S, sizeof(dtype) * C);
+		}
+	}
+	PROF_END(PROF_BIQUAD, n * C);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          FFT(FAST FOURIER TRANSFORM)
+*******************************************************************************/
+/*
+* The mixed radix plan (fft_factorize, the fft_bfly2/3/4/5/generic butterflies)
+* and the real transform split of rfft_forward / rfft_inverse follow KISS FFT :
+*
+* Copyright (c) 2003-2010, Mark Borgerding. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+*   * Neither the author nor the names of any contributors may be used to
+*     endorse or promote products derived from this software without specific
+*     prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+#define FFT_PI 3.14159265358979323846
+
+static fa_complex cmul(const fa_complex a, const fa_complex b)
+{
+	fa_complex c;
+	c.re = a.re * b.re - a.im * b.im;
+	c.im = a.re * b.im + a.im * b.re;
+	return c;
+}
+
+static int fft_factorize(fft_plan plan)
+{
+	/*
+	Description
+	-	Radix 4 first, then 2, 3, 5 and the remaining odd factors.
+		Returns the largest factor above 5, the scratch length of fft_bfly_generic
+		for every generic stage, 0 when there is none, -1 for too many factors.
+	*/
+	size_t n = plan->n, p = 4, i, largest = 0;
+	double floor_sqrt = floor(sqrt((double)n));
+	int nf = 0;
+
+	while (n > 1)
+	{
+		while (n % p)
+		{
+			switch (p)
+			{
+			case 4: p = 2; break;
+			case 2: p = 3; break;
+			default: p += 2; break;
+			}
+			if (p > floor_sqrt) p = n;
+		}
+		if (nf == FFT_MAX_FACTORS) return -1;
+		n /= p;
+		plan->factors[nf] = p;
+		plan->remain[nf] = n;
+		nf++;
+	}
+	plan->n_factors = nf;
+
+	for (i = 0; i < (size_t)nf; i++) if (plan->factors[i] > 5 && plan->factors[i] > largest) largest = plan->factors[i];
+	return (int)largest;
+}
+
+static void fft_fill_perm(fft_plan plan, size_t* perm, size_t offset, size_t fstride, int stage)
+{
+	/* input index of every leaf of the decimation in time recursion */
+	size_t p = plan->factors[stage], m = plan->remain[stage], j;
+
+	if (m == 1)
+	{
+		for (j = 0; j < p; j++) perm[j] = offset + j * fstride;
+		return;
+	}
+	for (j = 0; j < p; j++) fft_fill_perm(plan, perm + j * m, offset + j * fstride, fstride * p, stage + 1);
+}
+
+fft_plan fft_create(const size_t n)
+{
+	/*
+	* Arguments
+	- n : Transform length (any positive length, fastest for 2^a 3^b 5^c)
+
+	Description
+	-	Creates a complex FFT plan. The factorization, the digit reversal table
+		and the twiddles of both directions are computed once here,
+		so fft_forward / fft_inverse never call sin or cos.
+		Returns NULL on failure.
+	*/
+
+	fft_plan plan;
+	size_t k;
+	int generic;
+	double phase;
+
+	if (n == 0)
+	{
+		fprintf(stderr, "fft_create : n must be positive \n");
+		return NULL;
+	}
+
+	if ((plan = (fft_plan)calloc(1, sizeof(fft_plan_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	plan->n = n;
+
+	if ((generic = fft_factorize(plan)) < 0)
+	{
+		fprintf(stderr, "fft_create : too many factors \n");
+		free(plan);
+		return NULL;
+	}
+
+	plan->perm = (size_t*)malloc(sizeof(size_t) * n);
+	plan->twiddle = (fa_complex*)fa_aligned_malloc(sizeof(fa_complex) * n);
+	plan->itwiddle = (fa_complex*)fa_aligned_malloc(sizeof(fa_complex) * n);
+	plan->work = (fa_complex*)fa_aligned_malloc(sizeof(fa_complex) * n);
+	if (generic) plan->scratch = (fa_complex*)malloc(sizeof(fa_complex) * generic);
+
+	if (plan->perm == NULL || plan->twiddle == NULL || plan->itwiddle == NULL || plan->work == NULL
+		|| (generic && plan->scratch == NULL))
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		fft_destroy(plan);
+		return NULL;
+	}
+
+	for (k = 0; k < n; k++)
+	{
+		phase = -2 * FFT_PI * (double)k / (double)n;
+		plan->twiddle[k].re = (dtype)cos(phase);
+		plan->twiddle[k].im = (dtype)sin(phase);
+		plan->itwiddle[k].re = plan->twiddle[k].re;
+		plan->itwiddle[k].im = -plan->twiddle[k].im;
+	}
+
+	if (plan->n_factors) fft_fill_perm(plan, plan->perm, 0, 1, 0);
+	else plan->perm[0] = 0;
+
+	return plan;
+}
+
+fft_plan rfft_create(const size_t n)
+{
+	/*
+	* Arguments
+	- n : Number of real input samples
+
+	Description
+	-	Creates a real input FFT plan. Even lengths run a complex FFT of n / 2
+		points and split the result with precomputed twiddles,
+		odd lengths fall back to a complex FFT of n points.
+		The spectrum has n / 2 + 1 complex points.
+	*/
+
+	fft_plan plan;
+	size_t k, half;
+	double phase;
+
+	if (n == 0)
+	{
+		fprintf(stderr, "rfft_create : n must be positive \n");
+		return NULL;
+	}
+
+	if ((plan = (fft_plan)calloc(1, sizeof(fft_plan_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	plan->n = n;
+	plan->real = 1;
+
+	half = (n % 2 == 0) ? n / 2 : n;
+	plan->sub = fft_create(half);
+	plan->work = (fa_complex*)fa_aligned_malloc(sizeof(fa_complex) * (half + 1));
+	if (n % 2 == 0) plan->rtwiddle = (fa_complex*)fa_aligned_malloc(sizeof(fa_complex) * (half / 2 + 1));
+
+	if (plan->sub == NULL || plan->work == NULL || (n % 2 == 0 && plan->rtwiddle == NULL))
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		fft_destroy(plan);
+		return NULL;
+	}
+
+	if (n % 2 == 0)
+	{
+		for (k = 1; k <= half / 2; k++)
+		{
+			phase = -FFT_PI * ((double)k / (double)half + 0.5);
+			plan->rtwiddle[k].re = (dtype)cos(phase);
+			plan->rtwiddle[k].im = (dtype)sin(phase);
+		}
+	}
+
+	return plan;
+}
+
+void fft_destroy(fft_plan plan)
+{
+	if (plan == NULL) return;
+	free(plan->perm);
+	free(plan->scratch);
+	fa_aligned_free(plan->twiddle);
+	fa_aligned_free(plan->itwiddle);
+	fa_aligned_free(plan->work);
+	fa_aligned_free(plan->rtwiddle);
+	fft_destroy(plan->sub);
+	free(plan);
+}
+
+size_t fft_length(const fft_plan plan)
+{
+	return plan->n;
+}
+
+static void fft_bfly2(fa_complex* F, const size_t fstride, const fa_complex* tw, const size_t m)
+{
+	fa_complex* F2 = F + m, t;
+	size_t k;
+
+	for (k = 0; k < m; k++)
+	{
+		t = cmul(F2[k], tw[k * fstride]);
+		F2[k].re = F[k].re - t.re; F2[k].im = F[k].im - t.im;
+		F[k].re += t.re; F[k].im += t.im;
+	}
+}
+
+static void fft_bfly4(fa_complex* F, const size_t fstride, const fa_complex* tw, const size_t m, const int inverse)
+{
+	fa_complex s0, s1, s2, s3, s4, s5;
+	size_t k;
+
+	for (k = 0; k < m; k++)
+	{
+		s0 = cmul(F[k + m], tw[k * fstride]);
+		s1 = cmul(F[k + 2 * m], tw[2 * k * fstride]);
+		s2 = cmul(F[k + 3 * m], tw[3 * k * fstride]);
+
+		s5.re = F[k].re - s1.re; s5.im = F[k].im - s1.im;
+		F[k].re += s1.re; F[k].im += s1.im;
+		s3.re = s0.re + s2.re; s3.im = s0.im + s2.im;
+		s4.re = s0.re - s2.re; s4.im = s0.im - s2.im;
+
+		F[k + 2 * m].re = F[k].re - s3.re; F[k + 2 * m].im = F[k].im - s3.im;
+		F[k].re += s3.re; F[k].im += s3.im;
+
+		if (inverse)
+		{
+			F[k + m].re = s5.re - s4.im; F[k + m].im = s5.im + s4.re;
+			F[k + 3 * m].re = s5.re + s4.im; F[k + 3 * m].im = s5.im - s4.re;
+		}
+		else
+		{
+			F[k + m].re = s5.re + s4.im; F[k + m].im = s5.im - s4.re;
+			F[k + 3 * m].re = s5.re - s4.im; F[k + 3 * m].im = s5.im + s4.re;
+		}
+	}
+}
+
+static void fft_bfly3(fa_complex* F, const size_t fstride, const fa_complex* tw, const size_t m)
+{
+	const dtype epi3 = tw[fstride * m].im; // sin(-+2 pi / 3)
+	fa_complex s0, s1, s2, s3;
+	size_t k;
+
+	for (k = 0; k < m; k++)
+	{
+		s1 = cmul(F[k + m], tw[k * fstride]);
+		s2 = cmul(F[k + 2 * m], tw[2 * k * fstride]);
+
+		s3.re = s1.re + s2.re; s3.im = s1.im + s2.im;
+		s0.re = (s1.re - s2.re) * epi3; s0.im = (s1.im - s2.im) * epi3;
+
+		F[k + m].re = F[k].re - s3.re * 0.5; F[k + m].im = F[k].im - s3.im * 0.5;
+		F[k].re += s3.re; F[k].im += s3.im;
+
+		F[k + 2 * m].re = F[k + m].re + s0.im; F[k + 2 * m].im = F[k + m].im - s0.re;
+		F[k + m].re -= s0.im; F[k + m].im += s0.re;
+	}
+}
+
+static void fft_bfly5(fa_complex* F, const size_t fstride, const fa_complex* tw, const size_t m)
+{
+	const fa_complex ya = tw[fstride * m], yb = tw[2 * fstride * m];
+	fa_complex* F0 = F, * F1 = F + m, * F2 = F + 2 * m, * F3 = F + 3 * m, * F4 = F + 4 * m;
+	fa_complex s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12;
+	size_t u;
+
+	for (u = 0; u < m; u++)
+	{
+		s0 = F0[u];
+		s1 = cmul(F1[u], tw[u * fstride]);
+		s2 = cmul(F2[u], tw[2 * u * fstride]);
+		s3 = cmul(F3[u], tw[3 * u * fstride]);
+		s4 = cmul(F4[u], tw[4 * u * fstride]);
+
+		s7.re = s1.re + s4.re; s7.im = s1.im + s4.im;
+		s10.re = s1.re - s4.re; s10.im = s1.im - s4.im;
+		s8.re = s2.re + s3.re; s8.im = s2.im + s3.im;
+		s9.re = s2.re - s3.re; s9.im = s2.im - s3.im;
+
+		F0[u].re = s0.re + s7.re + s8.re; F0[u].im = s0.im + s7.im + s8.im;
+
+		s5.re = s0.re + s7.re * ya.re + s8.re * yb.re;
+		s5.im = s0.im + s7.im * ya.re + s8.im * yb.re;
+		s6.re = s10.im * ya.im + s9.im * yb.im;
+		s6.im = -s10.re * ya.im - s9.re * yb.im;
+		F1[u].re = s5.re - s6.re; F1[u].im = s5.im - s6.im;
+		F4[u].re = s5.re + s6.re; F4[u].im = s5.im + s6.im;
+
+		s11.re = s0.re + s7.re * yb.re + s8.re * ya.re;
+		s11.im = s0.im + s7.im * yb.re + s8.im * ya.re;
+		s12.re = -s10.im * yb.im + s9.im * ya.im;
+		s12.im = s10.re * yb.im - s9.re * ya.im;
+		F2[u].re = s11.re + s12.re; F2[u].im = s11.im + s12.im;
+		F3[u].re = s11.re - s12.re; F3[u].im = s11.im - s12.im;
+	}
+}
+
+static void fft_bfly_generic(fa_complex* F, const size_t fstride, const fa_complex* tw, const size_t m,
+	const size_t p, const size_t n, fa_complex* scratch)
+{
+	fa_complex t;
+	size_t u, q1, q, k, twidx;
+
+	for (u = 0; u < m; u++)
+	{
+		for (q1 = 0, k = u; q1 < p; q1++, k += m) scratch[q1] = F[k];
+
+		for (q1 = 0, k = u; q1 < p; q1++, k += m)
+		{
+			twidx = 0;
+			F[k] = scratch[0];
+			for (q = 1; q < p; q++)
+			{
+				twidx += fstride * k;
+				if (twidx >= n) twidx -= n;
+				t = cmul(scratch[q], tw[twidx]);
+				F[k].re += t.re; F[k].im += t.im;
+			}
+		}
+	}
+}
+
+static void fft_execute(fft_plan plan, const fa_complex* in, fa_complex* out, const int inverse)
+{
+	/*
+	Description
+	-	Mixed radix decimation in time. The input is first gathered
+		in digit reversed order, then the stages run in place from the
+		shortest sub transforms to the full length.
+	*/
+
+	const fa_complex* tw = inverse ? plan->itwiddle : plan->twiddle;
+	fa_complex* dst = (in == out) ? plan->work : out;
+	size_t n = plan->n, i, b, p, m, fstride = n;
+	int s;
+
+	for (i = 0; i < n; i++) dst[i] = in[plan->perm[i]];
+
+	for (s = plan->n_factors - 1; s >= 0; s--)
+	{
+		p = plan->factors[s];
+		m = plan->remain[s];
+		fstride /= p; // product of the factors before stage s
+
+		for (b = 0; b < fstride; b++)
+		{
+			fa_complex* F = dst + b * p * m;
+			switch (p)
+			{
+			case 2: fft_bfly2(F, fstride, tw, m); break;
+			case 3: fft_bfly3(F, fstride, tw, m); break;
+			case 4: fft_bfly4(F, fstride, tw, m, inverse); break;
+			case 5: fft_bfly5(F, fstride, tw, m); break;
+			default: fft_bfly_generic(F, fstride, tw, m, p, n, plan->scratch); break;
+			}
+		}
+	}
+
+	if (dst != out) memcpy(out, dst, sizeof(fa_complex) * n);
+}
+
+void fft_forward(fft_plan plan, const dtype* in, dtype* out)
+{
+	/*
+	* Arguments
+	- plan : Complex plan of length n
+	- in : Interleaved complex input of n points
+	- out : Interleaved complex output of n points (may be equal to in)
+
+	Description
+	-	X(k) = sum x(n) * exp(-2 pi i k n / N), not normalized.
+	*/
+
+	PROF_BEGIN(PROF_FFT);
+
+	fft_execute(plan, (const fa_complex*)in, (fa_complex*)out, 0);
+	PROF_END(PROF_FFT, plan->n);
+}
+
+void fft_inverse(fft_plan plan, const dtype* in, dtype* out)
+{
+	/*
+	Description
+	-	x(n) = 1 / N * sum X(k) * exp(+2 pi i k n / N),
+		so fft_inverse(fft_forward(x)) returns x.
+	*/
+
+	const dtype scale = (dtype)(1.0 / (double)plan->n);
+	size_t i;
+	PROF_BEGIN(PROF_FFT);
+
+	fft_execute(plan, (const fa_complex*)in, (fa_complex*)out, 1);
+	for (i = 0; i < 2 * plan->n; i++) out[i] *= scale;
+	PROF_END(PROF_FFT, plan->n);
+}
+
+size_t fft_good_size(const size_t n)
+{
+	/*
+	Description
+	-	Smallest even length >= n of the form 2^a 3^b 5^c,
+		the lengths where the fixed radix butterflies are used for every stage.
+	*/
+
+	size_t m, t;
+
+	for (m = (n < 2) ? 2 : n; ; m++)
+	{
+		if (m % 2) continue;
+		t = m;
+		while (t % 2 == 0) t /= 2;
+		while (t % 3 == 0) t /= 3;
+		while (t % 5 == 0) t /= 5;
+		if (t == 1) return m;
+	}
+}
+
+void rfft_forward(fft_plan plan, const dtype* in, dtype* out)
+{
+	/*
+	* Arguments
+	- plan : Real plan of length n
+	- in : n real samples
+	- out : n / 2 + 1 interleaved complex points (2 * (n / 2 + 1) dtype)
+
+	Description
+	-	Even n : the real input is read as n / 2 complex points,
+		transformed, and split into the spectrum of the real signal with
+		X(k) = (Z(k) + Z*(N/2-k)) / 2 - i exp(-2 pi i k / N) (Z(k) - Z*(N/2-k)) / 2.
+	*/
+
+	fa_complex* Z = plan->work, * X = (fa_complex*)out;
+	fa_complex f1k, f2k, t, dc;
+	size_t n = plan->n, half = plan->sub->n, k;
+	PROF_BEGIN(PROF_FFT);
+
+	if (n % 2)
+	{
+		for (k = 0; k < n; k++) Z[k].re = in[k], Z[k].im = 0;
+		fft_execute(plan->sub, Z, Z, 0);
+		memcpy(X, Z, sizeof(fa_complex) * (n / 2 + 1));
+		PROF_END(PROF_FFT, n);
+		return;
+	}
+
+	fft_execute(plan->sub, (const fa_complex*)in, Z, 0);
+
+	dc = Z[0];
+	X[0].re = dc.re + dc.im; X[0].im = 0;
+	X[half].re = dc.re - dc.im; X[half].im = 0;
+
+	for (k = 1; k <= half / 2; k++)
+	{
+		f1k.re = Z[k].re + Z[half - k].re; f1k.im = Z[k].im - Z[half - k].im;
+		f2k.re = Z[k].re - Z[half - k].re; f2k.im = Z[k].im + Z[half - k].im;
+		t = cmul(f2k, plan->rtwiddle[k]);
+
+		X[k].re = 0.5 * (f1k.re + t.re); X[k].im = 0.5 * (f1k.im + t.im);
+		X[half - k].re = 0.5 * (f1k.re - t.re); X[half - k].im = 0.5 * (t.im - f1k.im);
+	}
+	PROF_END(PROF_FFT, n);
+}
+
+void rfft_inverse(fft_plan plan, const dtype* in, dtype* out)
+{
+	/*
+	* Arguments
+	- plan : Real plan of length n
+	- in : n / 2 + 1 interleaved complex points
+	- out : n real samples
+
+	Description
+	-	Inverse of rfft_forward, normalized so that rfft_inverse(rfft_forward(x)) returns x.
+	*/
+
+	const fa_complex* X = (const fa_complex*)in;
+	fa_complex* Z = plan->work, fek, fok, t, tw;
+	size_t n = plan->n, half = plan->sub->n, k;
+	PROF_BEGIN(PROF_FFT);
+
+	if (n % 2)
+	{
+		for (k = 0; k <= n / 2; k++) Z[k] = X[k];
+		for (k = n / 2 + 1; k < n; k++) Z[k].re = X[n - k].re, Z[k].im = -X[n - k].im; // hermitian symmetry
+		fft_execute(plan->sub, Z, Z, 1);
+		for (k = 0; k < n; k++) out[k] = Z[k].re / (dtype)n;
+		PROF_END(PROF_FFT, n);
+		return;
+	}
+
+	Z[0].re = X[0].re + X[half].re;
+	Z[0].im = X[0].re - X[half].re;
+
+	for (k = 1; k <= half / 2; k++)
+	{
+		fek.re = X[k].re + X[half - k].re; fek.im = X[k].im - X[half - k].im;
+		t.re = X[k].re - X[half - k].re; t.im = X[k].im + X[half - k].im;
+		tw.re = plan->rtwiddle[k].re; tw.im = -plan->rtwiddle[k].im;
+		fok = cmul(t, tw);
+
+		Z[k].re = fek.re + fok.re; Z[k].im = fek.im + fok.im;
+		Z[half - k].re = fek.re - fok.re; Z[half - k].im = fok.im - fek.im;
+	}
+
+	fft_execute(plan->sub, Z, (fa_complex*)out, 1);
+	for (k = 0; k < n; k++) out[k] *= (dtype)(1.0 / (double)n);
+	PROF_END(PROF_FFT, n);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          AUTOCORRELATION
+*******************************************************************************/
+#define AUTOCOR_FFT_MIN_LAG 256	// below this the direct sum always wins
+#define AUTOCOR_FFT_COST 48.0	// cost of one M log2 M unit of the fft path relative to one direct multiply-add
+
+int autocor_use_fft(const int autocor_len, const int lag)
+{
+	/*
+	Description
+	-	Returns 1 when the FFT path is expected to be faster.
+		The direct sum costs lag * len multiply-adds, the FFT path
+		two real forward and one real inverse transform of M = fft_good_size(len + lag).
+	*/
+
+	double M;
+
+	if (lag < AUTOCOR_FFT_MIN_LAG) return 0;
+	M = (double)fft_good_size((size_t)autocor_len + lag);
+	return (double)lag * autocor_len > AUTOCOR_FFT_COST * M * log2(M);
+}
+
+static void autocor_window(dtype* __restrict r, const dtype* __restrict w, const int autocor_len, const int lag)
+{
+	/* r(i) = w(0) * w(i) + ... + w(len - 1) * w(len - 1 + i), four lags per pass */
+
+	dtype r4[4];
+	int i = 0;
+
+	for (; i + 4 <= lag; i += 4)
+	{
+		simd_dot_shift4(w, w + i, autocor_len, r4);
+		r[i] = r4[0], r[i + 1] = r4[1], r[i + 2] = r4[2], r[i + 3] = r4[3];
+	}
+	for (; i < lag; i++) r[i] = simd_dot(w, w + i, autocor_len);
+}
+
+void autocor_direct(dtype* __restrict r, const dtype* __restrict x, const int autocor_len, const int lag)
+{
+	/*
+	Description
+	-	Direct O(lag * len) sum of autocor(), four lags per pass over x.
+	*/
+
+	dtype r4[4];
+	const dtype* h = x + lag;
+	int i = 0;
+	PROF_BEGIN(PROF_AUTOCOR);
+
+	for (; i + 4 <= lag; i += 4)
+	{
+		simd_dot_shift4(h, h - i - 3, autocor_len, r4); // lags i+3, i+2, i+1, i
+		r[i] = r4[3], r[i + 1] = r4[2], r[i + 2] = r4[1], r[i + 3] = r4[0];
+	}
+	for (; i < lag; i++) r[i] = simd_dot(h, h - i, autocor_len);
+	PROF_END(PROF_AUTOCOR, autocor_len + lag);
+}
+
+#ifdef _MSC_VER
+#define AUTOCOR_THREAD_LOCAL __declspec(thread)
+#else
+#define AUTOCOR_THREAD_LOCAL _Thread_local
+#endif
+
+typedef struct _autocor_fft_cache
+{
+	size_t M;			// transform length of the plan, 0 : empty
+	fft_plan plan;
+	dtype* a, * y;		// M + 2 work samples each
+} autocor_fft_cache_t;
+
+static AUTOCOR_THREAD_LOCAL autocor_fft_cache_t autocor_cache; // per thread : autocor stays reentrant
+
+void autocor_fft_release(void)
+{
+	/*
+	Description
+	-	Frees the plan and work buffers autocor_fft keeps for the calling thread.
+		Optional, for threads that are done with autocorrelation; the next
+		autocor_fft call on the thread plans again.
+	*/
+
+	fft_destroy(autocor_cache.plan);
+	fa_aligned_free(autocor_cache.a);
+	fa_aligned_free(autocor_cache.y);
+	memset(&autocor_cache, 0, sizeof(autocor_cache));
+}
+
+static int autocor_fft_prepare(const size_t M)
+{
+	/* plan and buffers of length M, reused while the length stays the same */
+
+	if (autocor_cache.M == M) return 0;
+
+	autocor_fft_release();
+	autocor_cache.plan = rfft_create(M);
+	autocor_cache.a = (dtype*)fa_aligned_malloc(sizeof(dtype) * (M + 2));
+	autocor_cache.y = (dtype*)fa_aligned_malloc(sizeof(dtype) * (M + 2));
+	if (autocor_cache.plan == NULL || autocor_cache.a == NULL || autocor_cache.y == NULL)
+	{
+		autocor_fft_release();
+		return -1;
+	}
+	autocor_cache.M = M;
+	return 0;
+}
+
+void autocor_fft(dtype* __restrict r, const dtype* __restrict x, const int autocor_len, const int lag)
+{
+	/*
+	Description
+	-	Wiener-Khinchin path of autocor().
+		a = x with the first lag samples cleared, y = x, both zero padded to M.
+		r(i) = sum a(k) * y(k - i) = IFFT(A * conj(Y))(i).
+		k - i >= 1 for every term, so the circular product never wraps and M >= len + lag is enough.
+		The rfft plan and the work buffers are kept per thread and reused while M
+		does not change, so repeated calls of one size pay the planning once.
+	*/
+
+	const size_t N = (size_t)autocor_len + lag, M = fft_good_size(N);
+	dtype* a, * y, re, im;
+	size_t k;
+	PROF_BEGIN(PROF_AUTOCOR);
+
+	if (autocor_fft_prepare(M) < 0)
+	{
+		fprintf(stderr, "autocor_fft : Memory Allocation Error! use direct sum \n");
+		autocor_direct(r, x, autocor_len, lag); // records itself
+		return;
+	}
+	a = autocor_cache.a, y = autocor_cache.y;
+
+	memset(a, 0, sizeof(dtype) * lag);
+	memcpy(a + lag, x + lag, sizeof(dtype) * autocor_len);
+	memset(a + N, 0, sizeof(dtype) * (M + 2 - N));
+	memcpy(y, x, sizeof(dtype) * N);
+	memset(y + N, 0, sizeof(dtype) * (M + 2 - N));
+
+	rfft_forward(autocor_cache.plan, a, a);
+	rfft_forward(autocor_cache.plan, y, y);
+
+	for (k = 0; k <= M / 2; k++)
+	{
+		re = a[2 * k] * y[2 * k] + a[2 * k + 1] * y[2 * k + 1];
+		im = a[2 * k + 1] * y[2 * k] - a[2 * k] * y[2 * k + 1];
+		a[2 * k] = re, a[2 * k + 1] = im;
+	}
+
+	rfft_inverse(autocor_cache.plan, a, a);
+	memcpy(r, a, sizeof(dtype) * lag);
+	PROF_END(PROF_AUTOCOR, N);
+}
+
+autocor_handle autocor_stream_create(const int autocor_len, const int lag, const size_t refresh)
+{
+	/*
+	* Arguments
+	- autocor_len : Number of products per lag (sliding window length)
+	- lag : Length of lag
+	- refresh : Pushes between exact recomputations, 0 selects 8 * autocor_len
+
+	Description
+	-	Streaming autocorrelation of the latest autocor_len samples,
+		r(i) = x(n) * x(n - i) + ... + x(n - len + 1) * x(n - len + 1 - i).
+		Each push adds the entering product and removes the leaving one, O(lag).
+		The running sums are recomputed exactly every refresh pushes
+		so the rounding error does not accumulate.
+	*/
+
+	autocor_handle ac;
+
+	if (autocor_len <= 0 || lag <= 0)
+	{
+		fprintf(stderr, "autocor_stream_create : autocor_len and lag must be positive \n");
+		return NULL;
+	}
+
+	if ((ac = (autocor_handle)calloc(1, sizeof(autocor_stream_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	ac->len = autocor_len;
+	ac->lag = lag;
+	ac->refresh = refresh ? refresh : 8 * (size_t)autocor_len;
+	ac->history = fa_create((size_t)autocor_len + lag);
+	ac->r = (dtype*)fa_aligned_malloc(sizeof(dtype) * lag);
+
+	if (ac->history == NULL || ac->r == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		autocor_stream_destroy(ac);
+		return NULL;
+	}
+	zeros(ac->r, lag);
+
+	return ac;
+}
+
+void autocor_stream_destroy(autocor_handle ac)
+{
+	if (ac == NULL) return;
+	fa_destroy(ac->history);
+	fa_aligned_free(ac->r);
+	free(ac);
+}
+
+void autocor_stream_reset(autocor_handle ac)
+{
+	zeros_fa(ac->history);
+	zeros(ac->r, ac->lag);
+	ac->count = 0;
+}
+
+void autocor_stream_push(autocor_handle ac, const dtype sample)
+{
+	dtype* __restrict r = ac->r;
+	const dtype* w, * w_old;
+	dtype x_new, x_old;
+	int i;
+
+	fa_handle_push(ac->history, sample);
+	w = fa_window(ac->history);
+	w_old = w + ac->len;
+	x_new = w[0];
+	x_old = w_old[0];
+
+	for (i = 0; i < ac->lag; i++) r[i] += x_new * w[i] - x_old * w_old[i];
+
+	if (++ac->count >= ac->refresh) autocor_stream_refresh(ac);
+}
+
+void autocor_stream_push_block(autocor_handle ac, const dtype* block, const size_t n)
+{
+	size_t i;
+	PROF_BEGIN(PROF_AUTOCOR_STREAM);
+
+	for (i = 0; i < n; i++) autocor_stream_push(ac, block[i]);
+	PROF_END(PROF_AUTOCOR_STREAM, n);
+}
+
+void autocor_stream_refresh(autocor_handle ac)
+{
+	autocor_window(ac->r, fa_window(ac->history), ac->len, ac->lag);
+	ac->count = 0;
+}
+
+const dtype* autocor_stream_result(const autocor_handle ac)
+{
+	return ac->r;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          SLIDING CORRELATION
+*******************************************************************************/
+sdft_handle sdft_create(const size_t length, const size_t* bins, const size_t n_bins, const size_t refresh)
+{
+	/*
+	* Arguments
+	- length : Window length N
+	- bins : Bin indices to track, each in 0 .. N / 2
+	- n_bins : Number of bins
+	- refresh : Pushes between exact recomputations, 0 selects 8 * length
+
+	Description
+	-	Sliding DFT of the latest length samples and their energy.
+		Each push rotates the tracked bins, O(n_bins), instead of a full transform.
+		The bins and the energy are recomputed exactly every refresh pushes
+		so the rounding error of the rotation does not accumulate.
+	*/
+
+	sdft_handle sdft;
+	size_t i, j;
+	double phase;
+
+	if (length == 0 || bins == NULL || n_bins == 0)
+	{
+		fprintf(stderr, "sdft_create : length and n_bins must be positive \n");
+		return NULL;
+	}
+	for (i = 0; i < n_bins; i++)
+	{
+		if (bins[i] > length / 2)
+		{
+			fprintf(stderr, "sdft_create : bin %zu is above length / 2 \n", bins[i]);
+			return NULL;
+		}
+	}
+
+	if ((sdft = (sdft_handle)calloc(1, sizeof(sliding_dft_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	sdft->length = length;
+	sdft->n_bins = n_bins;
+	sdft->refresh = refresh ? refresh : 8 * length;
+	sdft->bins = (size_t*)malloc(sizeof(size_t) * n_bins);
+	sdft->x_re = (dtype*)fa_aligned_malloc(sizeof(dtype) * n_bins);
+	sdft->x_im = (dtype*)fa_aligned_malloc(sizeof(dtype) * n_bins);
+	sdft->w_re = (dtype*)fa_aligned_malloc(sizeof(dtype) * n_bins);
+	sdft->w_im = (dtype*)fa_aligned_malloc(sizeof(dtype) * n_bins);
+	sdft->table = (fa_complex*)malloc(sizeof(fa_complex) * length);
+	sdft->history = fa_create(length + 1);
+
+	if (sdft->bins == NULL || sdft->x_re == NULL || sdft->x_im == NULL || sdft->w_re == NULL
+		|| sdft->w_im == NULL || sdft->table == NULL || sdft->history == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		sdft_destroy(sdft);
+		return NULL;
+	}
+
+	for (j = 0; j < length; j++)
+	{
+		phase = -2 * FFT_PI * (double)j / (double)length;
+		sdft->table[j].re = (dtype)cos(phase);
+		sdft->table[j].im = (dtype)sin(phase);
+	}
+	for (i = 0; i < n_bins; i++)
+	{
+		sdft->bins[i] = bins[i];
+		j = (length - bins[i]) % length; // e^(+2 pi i k / N) = e^(-2 pi i (N - k) / N)
+		sdft->w_re[i] = sdft->table[j].re;
+		sdft->w_im[i] = sdft->table[j].im;
+	}
+	sdft_reset(sdft);
+
+	return sdft;
+}
+
+void sdft_destroy(sdft_handle sdft)
+{
+	if (sdft == NULL) return;
+	fa_destroy(sdft->history);
+	free(sdft->bins);
+	free(sdft->table);
+	fa_aligned_free(sdft->x_re);
+	fa_aligned_free(sdft->x_im);
+	fa_aligned_free(sdft->w_re);
+	fa_aligned_free(sdft->w_im);
+	fa_aligned_free(sdft->h_re);
+	fa_aligned_free(sdft->h_im);
+	free(sdft);
+}
+
+void sdft_reset(sdft_handle sdft)
+{
+	zeros_fa(sdft->history);
+	zeros(sdft->x_re, sdft->n_bins);
+	zeros(sdft->x_im, sdft->n_bins);
+	sdft->energy = 0;
+	sdft->count = 0;
+}
+
+static void sdft_bins(const sdft_handle sdft, const dtype* x, const int reverse, dtype* re, dtype* im)
+{
+	/*
+	Description
+	-	Exact bins of x[0 .. N - 1] in time order, or of x[N - 1 .. 0] when reverse.
+		The twiddle index k * m is kept modulo N so every term reads the table.
+	*/
+
+	const size_t N = sdft->length;
+	const fa_complex* table = sdft->table;
+	size_t i, m, j;
+	dtype sr, si, v;
+
+	for (i = 0; i < sdft->n_bins; i++)
+	{
+		sr = 0, si = 0;
+		for (m = 0, j = 0; m < N; m++)
+		{
+			v = reverse ? x[N - 1 - m] : x[m];
+			sr += v * table[j].re;
+			si += v * table[j].im;
+			if ((j += sdft->bins[i]) >= N) j -= N;
+		}
+		re[i] = sr, im[i] = si;
+	}
+}
+
+void sdft_set_reference(sdft_handle sdft, const dtype* ref)
+{
+	/*
+	* Arguments
+	- ref : length samples in time order, ref[0] matches the oldest sample of the window
+
+	Description
+	-	Stores the bins of the reference weighted for sdft_correlation,
+		h(k) = c(k) conj(R(k)) / N with c(k) = 1 at k = 0 and N / 2 and 2 between,
+		so sum Re(X(k) h(k)) is the Parseval sum of the real spectrum.
+	*/
+
+	const size_t N = sdft->length;
+	dtype c;
+	size_t i;
+
+	if (sdft->h_re == NULL) sdft->h_re = (dtype*)fa_aligned_malloc(sizeof(dtype) * sdft->n_bins);
+	if (sdft->h_im == NULL) sdft->h_im = (dtype*)fa_aligned_malloc(sizeof(dtype) * sdft->n_bins);
+	if (sdft->h_re == NULL || sdft->h_im == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		fa_aligned_free(sdft->h_re), sdft->h_re = NULL;
+		fa_aligned_free(sdft->h_im), sdft->h_im = NULL;
+		return;
+	}
+
+	sdft_bins(sdft, ref, 0, sdft->h_re, sdft->h_im);
+	for (i = 0; i < sdft->n_bins; i++)
+	{
+		c = (sdft->bins[i] == 0 || 2 * sdft->bins[i] == N) ? (dtype)1 : (dtype)2;
+		sdft->h_re[i] *= c / (dtype)N;
+		sdft->h_im[i] *= -c / (dtype)N;
+	}
+	sdft->ref_energy = simd_dot(ref, ref, N);
+}
+
+void sdft_push(sdft_handle sdft, const dtype sample)
+{
+	dtype* __restrict x_re = sdft->x_re, * __restrict x_im = sdft->x_im;
+	const dtype* __restrict w_re = sdft->w_re, * __restrict w_im = sdft->w_im;
+	dtype x_old, d, re;
+	size_t i;
+
+	fa_handle_push(sdft->history, sample);
+	x_old = fa_window(sdft->history)[sdft->length];
+	d = sample - x_old;
+
+	for (i = 0; i < sdft->n_bins; i++)
+	{
+		re = x_re[i] + d;
+		x_re[i] = re * w_re[i] - x_im[i] * w_im[i];
+		x_im[i] = re * w_im[i] + x_im[i] * w_re[i];
+	}
+	sdft->energy += sample * sample - x_old * x_old;
+
+	if (++sdft->count >= sdft->refresh) sdft_refresh(sdft);
+}
+
+void sdft_push_block(sdft_handle sdft, const dtype* block, const size_t n)
+{
+	size_t i;
+	PROF_BEGIN(PROF_XCORR);
+
+	for (i = 0; i < n; i++) sdft_push(sdft, block[i]);
+	PROF_END(PROF_XCORR, n);
+}
+
+void sdft_refresh(sdft_handle sdft)
+{
+	/*
+	Description
+	-	Recomputes the bins and the energy from the history window.
+		The window is newest first, w[N - 1] is the oldest of the latest N samples.
+	*/
+
+	const dtype* w = fa_window(sdft->history);
+	const size_t N = sdft->length;
+
+	sdft_bins(sdft, w, 1, sdft->x_re, sdft->x_im);
+	sdft->energy = simd_dot(w, w, N);
+	sdft->count = 0;
+}
+
+fa_complex sdft_bin(const sdft_handle sdft, const size_t i)
+{
+	fa_complex X;
+	X.re = sdft->x_re[i];
+	X.im = sdft->x_im[i];
+	return X;
+}
+
+dtype sdft_energy(const sdft_handle sdft)
+{
+	return sdft->energy > 0 ? sdft->energy : 0;
+}
+
+dtype sdft_correlation(const sdft_handle sdft)
+{
+	/*
+	Description
+	-	ref[0] x(n - N + 1) + ... + ref[N - 1] x(n) taken from the tracked bins,
+		0 when no reference is set.
+	*/
+
+	dtype c = 0;
+	size_t i;
+
+	if (sdft->h_re == NULL) return 0;
+	for (i = 0; i < sdft->n_bins; i++) c += sdft->x_re[i] * sdft->h_re[i] - sdft->x_im[i] * sdft->h_im[i];
+	return c;
+}
+
+dtype sdft_coefficient(const sdft_handle sdft)
+{
+	/*
+	Description
+	-	Normalized correlation, correlation / sqrt(energy * reference energy),
+		in -1 .. 1 when the bins cover the reference. 0 on a silent window.
+	*/
+
+	const dtype e = sdft_energy(sdft) * sdft->ref_energy;
+	return e > 0 ? sdft_correlation(sdft) / (dtype)sqrt(e) : 0;
+}
+
+xcorr_handle xcorr_create(const dtype* ref, const size_t length, const size_t block)
+{
+	/*
+	* Arguments
+	- ref : Reference of length samples in time order
+	- length : Reference length N
+	- block : Frame and partition length, rounded up to an fft size, 0 selects N
+
+	Description
+	-	Matched filter of ref over a sample stream.
+		Partition p of the reversed reference, h[j] = ref[N - 1 - j] for j = p B .. p B + B - 1,
+		is kept as its spectrum at 2 B points. Pushes that are multiples of block
+		and aligned to it take the FFT path only.
+	*/
+
+	xcorr_handle xc;
+	size_t p, j, F;
+
+	if (ref == NULL || length == 0)
+	{
+		fprintf(stderr, "xcorr_create : length must be positive \n");
+		return NULL;
+	}
+
+	if ((xc = (xcorr_handle)calloc(1, sizeof(xcorr_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+
+	F = fft_good_size(2 * (block ? block : length));
+	xc->length = length;
+	xc->fft_len = F;
+	xc->block = F / 2;
+	xc->n_parts = (length + xc->block - 1) / xc->block;
+	xc->delay = length - 1 > xc->block ? length - 1 : xc->block;
+	xc->ref = (dtype*)fa_aligned_malloc(sizeof(dtype) * length);
+	xc->spectra = (dtype*)fa_aligned_malloc(sizeof(dtype) * (F + 2) * xc->n_parts);
+	xc->fdl = (dtype*)fa_aligned_malloc(sizeof(dtype) * (F + 2) * xc->n_parts);
+	xc->acc = (dtype*)fa_aligned_malloc(sizeof(dtype) * (F + 2));
+	xc->line = (dtype*)fa_aligned_malloc(sizeof(dtype) * (xc->delay + xc->block));
+	xc->plan = rfft_create(F);
+
+	if (xc->ref == NULL || xc->spectra == NULL || xc->fdl == NULL || xc->acc == NULL || xc->line == NULL || xc->plan == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		xcorr_destroy(xc);
+		return NULL;
+	}
+
+	memcpy(xc->ref, ref, sizeof(dtype) * length);
+	for (p = 0; p < xc->n_parts; p++)
+	{
+		zeros(xc->acc, F + 2);
+		for (j = 0; j < xc->block && p * xc->block + j < length; j++) xc->acc[j] = ref[length - 1 - p * xc->block - j];
+		rfft_forward(xc->plan, xc->acc, xc->spectra + p * (F + 2));
+	}
+	xcorr_reset(xc);
+
+	return xc;
+}
+
+void xcorr_destroy(xcorr_handle xc)
+{
+	if (xc == NULL) return;
+	fft_destroy(xc->plan);
+	fa_aligned_free(xc->ref);
+	fa_aligned_free(xc->spectra);
+	fa_aligned_free(xc->fdl);
+	fa_aligned_free(xc->acc);
+	fa_aligned_free(xc->line);
+	free(xc);
+}
+
+void xcorr_reset(xcorr_handle xc)
+{
+	zeros(xc->line, xc->delay + xc->block);
+	zeros(xc->fdl, (xc->fft_len + 2) * xc->n_parts);
+	xc->fill = 0;
+	xc->slot = 0;
+}
+
+static void xcorr_frame(xcorr_handle xc)
+{
+	/*
+	Description
+	-	Transforms the previous and the current frame, 2 B samples, into the fdl slot
+		and sums partition p times the spectrum of the frame p frames back.
+		Samples B .. 2 B - 1 of the inverse are free of circular wrap.
+	*/
+
+	const size_t F = xc->fft_len, P = xc->n_parts, K = F + 2;
+	dtype* __restrict acc = xc->acc;
+	const dtype* h, * x;
+	size_t p, k;
+
+	rfft_forward(xc->plan, xc->line + xc->delay - xc->block, xc->fdl + xc->slot * K);
+
+	zeros(acc, K);
+	for (p = 0; p < P; p++)
+	{
+		h = xc->spectra + p * K;
+		x = xc->fdl + ((xc->slot + P - p) % P) * K;
+		for (k = 0; k < K; k += 2)
+		{
+			acc[k] += h[k] * x[k] - h[k + 1] * x[k + 1];
+			acc[k + 1] += h[k] * x[k + 1] + h[k + 1] * x[k];
+		}
+	}
+	rfft_inverse(xc->plan, acc, acc);
+
+	if (++xc->slot == P) xc->slot = 0;
+}
+
+void xcorr_process(xcorr_handle xc, const dtype* in, dtype* out, const size_t n)
+{
+	/*
+	* Arguments
+	- in : n input samples
+	- out : n correlations, out[i] is the match of the reference ending at in[i]
+
+	Description
+	-	Input is appended to the current frame. When the frame completes,
+		its outputs not given yet are taken from the FFT path and the history shifts by B;
+		samples left in an incomplete frame are correlated directly, O(N) each.
+	*/
+
+	const size_t N = xc->length, B = xc->block, D = xc->delay;
+	dtype* line = xc->line;
+	size_t done, L, j;
+	PROF_BEGIN(PROF_XCORR);
+
+	for (done = 0; done < n; done += L)
+	{
+		L = n - done < B - xc->fill ? n - done : B - xc->fill;
+		memcpy(line + D + xc->fill, in + done, sizeof(dtype) * L);
+
+		if (xc->fill + L == B)
+		{
+			xcorr_frame(xc);
+			memcpy(out + done, xc->acc + B + xc->fill, sizeof(dtype) * L);
+			memmove(line, line + B, sizeof(dtype) * D);
+			xc->fill = 0;
+		}
+		else
+		{
+			for (j = 0; j < L; j++) out[done + j] = simd_dot(xc->ref, line + D + xc->fill + j + 1 - N, N);
+			xc->fill += L;
+		}
+	}
+	PROF_END(PROF_XCORR, n);
+}
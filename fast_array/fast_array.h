@@ -1,106 +1,831 @@
-#pragma once
-
-#ifndef __FAST_ARRAY_H__
-#define __FAST_ARRAY_H__
-
-#include "common.h"
-
-
-/******************************************************************************
-**                          FUNCTION DEFINITIONS
-**                          COMMON
-*******************************************************************************/
-void zeros(dtype* arr, const size_t size);
-void zeros_pidx(dtype* arr, const size_t size, pIdx idx);
-void ones(dtype* arr, const size_t size);
-void ones_pidx(dtype* arr, const size_t size, pIdx idx);
-void rands(dtype* arr, const size_t size, float average, float stdev);
-void rands_pidx(dtype* arr, const size_t size, float average, float stdev, pIdx idx);
-void sin_(dtype* arr, const size_t size, float f0, float fs, float phase);
-void sin_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx);
-void cos_(dtype* arr, const size_t size, float f0, float fs, float phase);
-void cos_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx);
-void scaling(dtype* arr, const size_t size, dtype scailing_factor);
-void scaling_pidx(dtype* arr, const size_t size, dtype scailing_factor, pIdx idx);
-
-/******************************************************************************
-**                          FUNCTION DEFINITIONS
-**                          PUSH
-*******************************************************************************/
-#define push_using_for(vector, length, target) \
-for (int j = length - 1; j > 0; j--) vector[j] = vector[j - 1]; vector[0] = target;
-
-#define push_using_memmove(vector, length, target) memmove(vector + 1, vector, sizeof(dtype) * (length-1)); vector[0] = target;
-
-#define push_using_pidx(ptr, size, ptr_idx, target) \
-if(--ptr_idx < 0) ptr_idx = size - 1; ptr[ptr_idx] = target; ptr[ptr_idx + size] = target
-	//fast insert
-
-#define push_using_pidx_no_shift(ptr, size, ptr_idx, target) \
-if(ptr_idx < 0) ptr_idx = size - 1; ptr[ptr_idx] = target; ptr[ptr_idx + size] = target
-	// not use pointer index decrese
-
-/* wrapper function : push */
-#define fa_push_ push_using_for
-#define fa_push push_using_memmove
-#define fa_fast_push_shift push_using_pidx
-#define fa_fast_push push_using_pidx_no_shift
-
-/******************************************************************************
-**                          FUNCTION DEFINITIONS
-**                          CDOT
-*******************************************************************************/
-dtype dot_product(dtype * a, dtype * b, pIdx size);
-dtype dot_product_pidx(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx);
-dtype dot_product_pidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx);
-dtype dot_product_dpidx(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2);
-dtype dot_product_dpidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2);
-dtype dot_product4(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2);
-
-/* wrapper function : cdot */
-#define fa_cdot dot_product
-#define fa_fast_cdot dot_product_dpidx
-
-/******************************************************************************
-**                          FUNCTION IMPLEMENTAION
-**                          FAST SIGNAL GENERATION
-*******************************************************************************/
-void fast_sin(dtype * arr, const size_t size, float f0, float fs);
-void fast_cos(dtype * arr, const size_t size, float f0, float fs);
-void fast_sin_pidx(dtype * arr, const size_t size, float f0, float fs, pIdx idx);
-void fast_cos_pidx(dtype * arr, const size_t size, float f0, float fs, pIdx idx);
-
-/******************************************************************************
-**                          FUNCTION DEFINITIONS
-**                          ADAPTIVE ALGORITHM
-*******************************************************************************/
-dtype least_mean_square(dtype * x, dtype * h, dtype * desired, dtype * y, dtype adapt_rate, dtype error,
-	int n_coeffecients, int n_output_samples);
-dtype fast_least_mean_square(dtype * x, dtype * h, dtype * desired, dtype * y, dtype adapt_rate, dtype error,
-	const int n_coeffecients, const int n_output_samples, pIdx x_idx, pIdx h_idx, pIdx d_idx, pIdx y_idx);
-
-/* wrapper function : lms */
-#define fa_lms least_mean_square
-#define fa_fast_lms fast_least_mean_sqaure
-
-/******************************************************************************
-**                          FUNCTION DEFINITIONS
-**                          OPERATION
-*******************************************************************************/
-void autocor(dtype * __restrict r, const dtype * __restrict x, int autocor_len, int lag);
-void fast_autocor(dtype * __restrict r, const dtype * __restrict x, int autocor_len, int lag, pIdx r_idx, pIdx x_idx);
-dtype fir_filtering(dtype * x1, dtype * x2, const  size_t size);
-dtype fast_fir_filtering(dtype * x1, dtype * x2, const  size_t size, pIdx idx);
-dtype fast_fir_filtering_dpidx(dtype * x1, dtype * x2, const  size_t size, pIdx idx1, pIdx idx2);
-
-/* wrapper function : cor */
-#define fa_autocor autocor
-#define fa_fast_autocor fast_autocor
-
-/******************************************************************************
-**                          FUNCTION DEFINITIONS
-**                          PRINT ARRAY
-*******************************************************************************/
-void print_arr1d(dtype * arr, const size_t size, type_t data_type);
-void print_arr1d_pidx(dtype * arr, const size_t size, type_t data_type, pIdx ptr_idx);
+#pragma once
+
+#ifndef __FAST_ARRAY_H__
+#define __FAST_ARRAY_H__
+
+#include "common.h"
+#include "simd.h"
+#include "thread.h"
+#include "noise.h"
+#include "prof.h"
+#include "trace.h"
+
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          COMMON
+*******************************************************************************/
+void zeros(dtype* arr, const size_t size);
+void zeros_pidx(dtype* arr, const size_t size, pIdx idx);
+void ones(dtype* arr, const size_t size);
+void ones_pidx(dtype* arr, const size_t size, pIdx idx);
+void rands(dtype* arr, const size_t size, float average, float stdev);
+void rands_pidx(dtype* arr, const size_t size, float average, float stdev, pIdx idx);
+void sin_(dtype* arr, const size_t size, float f0, float fs, float phase);
+void sin_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx);
+void cos_(dtype* arr, const size_t size, float f0, float fs, float phase);
+void cos_pidx(dtype* arr, const size_t size, float f0, float fs, float phase, pIdx idx);
+void scaling(dtype* arr, const size_t size, dtype scailing_factor);
+void scaling_pidx(dtype* arr, const size_t size, dtype scailing_factor, pIdx idx);
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          PUSH
+*******************************************************************************/
+#define push_using_for(vector, length, target) \
+for (int j = length - 1; j > 0; j--) vector[j] = vector[j - 1]; vector[0] = target;
+
+#define push_using_memmove(vector, length, target) memmove(vector + 1, vector, sizeof(*(vector)) * (length-1)); vector[0] = target;
+
+#define push_using_pidx(ptr, size, ptr_idx, target) \
+if(--ptr_idx < 0) ptr_idx = size - 1; ptr[ptr_idx] = target; ptr[ptr_idx + size] = target
+	//fast insert
+
+#define push_using_pidx_no_shift(ptr, size, ptr_idx, target) \
+if(ptr_idx < 0) ptr_idx = size - 1; ptr[ptr_idx] = target; ptr[ptr_idx + size] = target
+	// not use pointer index decrese
+
+void push_block_pidx(dtype* ptr, const size_t size, pIdx* ptr_idx, const dtype* block, const size_t n);
+	// fast insert of n samples, block[n - 1] becomes the newest sample
+
+/* wrapper function : push */
+#define fa_push_ push_using_for
+#define fa_push push_using_memmove
+#define fa_fast_push_shift push_using_pidx
+#define fa_fast_push push_using_pidx_no_shift
+#define fa_fast_push_block push_block_pidx
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          FAST ARRAY HANDLE
+*******************************************************************************/
+/*
+* A fast array handle owns a mirrored buffer of 2 * size elements
+* (FA_ALIGNMENT aligned). size is a power of two so the pointer index wraps
+* with a mask, and the latest length samples are always readable as
+* one contiguous window starting at ptr + idx.
+* The fields are read by the push macros; use the functions below to modify them.
+*
+* FA_MIRROR_MAPPED maps the same pages twice back to back (memfd + two mmap,
+* linux only), so one store shows up in both halves and the ring takes half
+* the memory and cache. The capacity is then at least one page. Where the
+* mapping is not available the handle silently falls back to FA_MIRROR_COPY,
+* which stores every sample twice.
+*/
+#define FA_MIRROR_COPY 0	// two copies, every sample is stored twice
+#define FA_MIRROR_MAPPED 1	// one copy mapped twice
+
+typedef struct _fast_array
+{
+	dtype* ptr;		// mirrored storage, ptr[i] == ptr[i + size]
+	size_t length;	// window length requested at creation
+	size_t size;	// capacity, power of two >= length
+	size_t mask;	// size - 1
+	pIdx idx;		// pointer index of the newest sample
+	size_t mirror;	// offset of the second store : size, or 0 when double mapped
+} fast_array_t;
+
+typedef fast_array_t* fa_handle;
+
+fa_handle fa_create(const size_t length);
+fa_handle fa_create_mode(const size_t length, const int mode);
+int fa_mirror_mode(const fa_handle fa);
+void fa_destroy(fa_handle fa);
+size_t fa_capacity(const fa_handle fa);
+size_t fa_length(const fa_handle fa);
+pIdx fa_index(const fa_handle fa);
+dtype* fa_window(const fa_handle fa);
+void fa_sync_mirror(fa_handle fa);
+
+void* fa_aligned_malloc(const size_t bytes);
+void fa_aligned_free(void* ptr);
+
+#define push_using_handle(fa, target) \
+do { (fa)->idx = ((fa)->idx - 1) & (pIdx)(fa)->mask; \
+(fa)->ptr[(fa)->idx] = (target); (fa)->ptr[(fa)->idx + (fa)->mirror] = (target); } while (0)
+	// fast insert without branch, a double mapped handle stores twice to the same address
+
+void push_block_fa(fa_handle fa, const dtype* block, const size_t n);
+
+/* wrapper function : handle push */
+#define fa_handle_push push_using_handle
+#define fa_handle_push_block push_block_fa
+
+/* handle kernels : operate on the current window of the handle */
+void zeros_fa(fa_handle fa);
+void ones_fa(fa_handle fa);
+void rands_fa(fa_handle fa, float average, float stdev);
+void sin_fa(fa_handle fa, float f0, float fs, float phase);
+void cos_fa(fa_handle fa, float f0, float fs, float phase);
+void scaling_fa(fa_handle fa, dtype scailing_factor);
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          SLIDING WINDOW STATISTICS
+*******************************************************************************/
+/*
+* Running statistics of the last length samples, updated per push instead of
+* rescanning the window. Push the same samples as into the fast array; like a
+* fast array the window starts full of zeros.
+* - STATS_MOMENTS : mean, variance, rms by a sliding Welford update, O(1).
+*   The sums are recomputed from the window once every length pushes, so the
+*   rounding drift stays bounded (amortized O(1)).
+* - STATS_MINMAX : monotonic deques of (time, value), amortized O(1).
+* - STATS_MEDIAN : the window split into a max-heap (lower half) and a
+*   min-heap (upper half) that track every slot; a push replaces the value
+*   of the oldest slot and sifts it, O(log length).
+*/
+#define STATS_MOMENTS 1
+#define STATS_MINMAX 2
+#define STATS_MEDIAN 4
+#define STATS_ALL (STATS_MOMENTS | STATS_MINMAX | STATS_MEDIAN)
+
+typedef struct _stats_deque
+{
+	size_t* time;
+	dtype* value;
+	size_t head, tail;	// front at head, back at tail - 1, masked by mask
+} stats_deque_t;
+
+typedef struct _fa_stats
+{
+	int flags;
+	size_t length;
+	size_t count;			// time of the next sample, the zeros of the reset are times 0 .. length - 1
+	size_t slot;			// count % length, ring slot of the oldest sample
+	dtype* ring;			// window, sample of time t at ring[t % length]
+	double mean, m2;		// STATS_MOMENTS : running mean, sum of squared deviations
+	size_t mask;			// STATS_MINMAX : deque capacity - 1
+	stats_deque_t min, max;
+	size_t* lo, * hi;		// STATS_MEDIAN : slots of the max-heap (lower) and min-heap (upper)
+	size_t n_lo, n_hi;		// (length + 1) / 2, length / 2
+	size_t* where;			// heap position of every slot, hi positions offset by n_lo
+} fa_stats_t;
+
+typedef fa_stats_t* stats_handle;
+
+stats_handle stats_create(const size_t length, const int flags);
+void stats_destroy(stats_handle stats);
+void stats_reset(stats_handle stats);
+void stats_push(stats_handle stats, const dtype x);
+void stats_push_block(stats_handle stats, const dtype* block, const size_t n);
+dtype stats_mean(const stats_handle stats);
+dtype stats_variance(const stats_handle stats);
+dtype stats_rms(const stats_handle stats);
+dtype stats_min(const stats_handle stats);
+dtype stats_max(const stats_handle stats);
+dtype stats_median(const stats_handle stats);
+
+/* wrapper function : stats */
+#define fa_stats_push stats_push
+#define fa_stats_push_block stats_push_block
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          SPSC FAST ARRAY
+*******************************************************************************/
+/*
+* A mirrored ring shared by one producer thread (spsc_push) and one consumer
+* thread (spsc_acquire / spsc_release), without locks.
+* head counts the pushed samples and is published with a release store after
+* the samples are written. tail is the oldest sample the consumer still needs;
+* the producer never writes a slot at or after tail, so a borrowed window is
+* never overwritten while it is read. When the ring is full, spsc_push accepts
+* fewer samples and counts the rest as dropped, so the producer never waits.
+* Counters wrap around and are only compared by difference.
+* The fields of each side sit on their own cache line.
+*/
+#define FA_CACHE_LINE FA_ALIGNMENT
+
+typedef struct _fa_spsc
+{
+	// read only after creation
+	dtype* ptr;				// mirrored storage, newest sample at ptr[-head & mask]
+	size_t length;			// window length
+	size_t size, mask;		// capacity, power of two >= length + slack
+	char pad0[FA_CACHE_LINE - sizeof(dtype*) - 3 * sizeof(size_t)];
+	// producer
+	volatile size_t head;	// samples pushed
+	size_t tail_cache;		// last tail seen by the producer
+	size_t dropped;			// samples refused because the ring was full
+	char pad1[FA_CACHE_LINE - 3 * sizeof(size_t)];
+	// consumer
+	volatile size_t tail;	// oldest sample the consumer holds
+	size_t acquired;		// head of the borrowed window
+	char pad2[FA_CACHE_LINE - 2 * sizeof(size_t)];
+} fa_spsc_t;
+
+typedef fa_spsc_t* spsc_handle;
+
+spsc_handle spsc_create(const size_t length, const size_t slack);
+void spsc_destroy(spsc_handle spsc);
+size_t spsc_push(spsc_handle spsc, const dtype* block, const size_t n);
+size_t spsc_push_sample(spsc_handle spsc, const dtype x);
+const dtype* spsc_acquire(spsc_handle spsc);
+void spsc_release(spsc_handle spsc);
+size_t spsc_dropped(const spsc_handle spsc);
+
+/* wrapper function : spsc */
+#define fa_spsc_push spsc_push
+#define fa_spsc_acquire spsc_acquire
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          CDOT
+*******************************************************************************/
+dtype dot_product(dtype * a, dtype * b, pIdx size);
+dtype dot_product_pidx(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx);
+dtype dot_product_pidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx);
+dtype dot_product_dpidx(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2);
+dtype dot_product_dpidx_debug(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2);
+dtype dot_product4(dtype* arr1, dtype* arr2, const size_t size, pIdx ptr_idx1, pIdx ptr_idx2);
+
+/* wrapper function : cdot */
+#define fa_cdot dot_product
+#define fa_fast_cdot dot_product_dpidx
+
+dtype dot_product_fa(const fa_handle fa, dtype* arr);
+dtype dot_product_dfa(const fa_handle fa1, const fa_handle fa2);
+
+/* wrapper function : handle cdot */
+#define fa_handle_cdot dot_product_fa
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          PARALLEL BULK KERNELS
+*******************************************************************************/
+/*
+* Multithreaded zeros / ones / scaling / rands / sin_ / cos_ / dot_product for
+* arrays of millions of elements, run on an internal pool created at the first
+* call (bulk_set_threads sets its size, 1 keeps everything serial). Calls below
+* BULK_PARALLEL_MIN elements take the serial kernels.
+* The array is cut into BULK_CHUNK element chunks and worker w always owns the
+* same contiguous run of chunks, on a pinned thread. Initializing a fresh
+* allocation with one of these kernels is its first touch, so every page lands
+* on the NUMA node of the worker that reads it in the later passes.
+* Results do not depend on the worker count : dot_product_mt adds the chunk
+* sums in chunk order, and rands_mt draws chunk c from noise stream c of seed.
+* A call made while another thread is running a bulk kernel runs serially.
+*/
+#define BULK_PARALLEL_MIN (1 << 18)	// elements, smaller calls stay serial
+#define BULK_CHUNK (1 << 16)		// elements per chunk : unit of work split and of reduction
+
+int bulk_set_threads(int n_threads);	// <= 0 : cpu_count(), -1 returned while a kernel runs
+int bulk_get_threads(void);
+
+void zeros_mt(dtype* arr, const size_t size);
+void ones_mt(dtype* arr, const size_t size);
+void scaling_mt(dtype* arr, const size_t size, dtype scailing_factor);
+void rands_mt(dtype* arr, const size_t size, float average, float stdev, const uint64_t seed);
+void sin_mt(dtype* arr, const size_t size, float f0, float fs, float phase);
+void cos_mt(dtype* arr, const size_t size, float f0, float fs, float phase);
+dtype dot_product_mt(const dtype* a, const dtype* b, const size_t size);
+
+/* wrapper function : parallel cdot */
+#define fa_cdot_mt dot_product_mt
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          EXPRESSION PIPELINE
+*******************************************************************************/
+/*
+* A recorded chain of element-wise operations and a final reduction, run in one
+* pass : the input is taken EXPR_BLOCK elements at a time into an L1 sized block,
+* every operation runs over the block with the simd element-wise kernel, then the
+* block is reduced and / or stored.
+* scaling, rands, a window product and dot_product over an array larger than L2
+* read the data once instead of four times and need no temporary array.
+* Operand arrays are indexed like the input (element i pairs with input i), so a
+* fast array takes part through fa_window().
+*/
+#define EXPR_MAX_OPS 16
+#define EXPR_BLOCK 1024		// elements per block, 8 KB
+
+#define EXPR_SCALE SIMD_EW_SCALE		// x *= a
+#define EXPR_OFFSET SIMD_EW_OFFSET		// x += a
+#define EXPR_ADD SIMD_EW_ADD			// x += arr[i]
+#define EXPR_MUL SIMD_EW_MUL			// x *= arr[i]
+#define EXPR_CLAMP SIMD_EW_CLAMP		// x = min(max(x, a), b)
+#define EXPR_NOISE 16					// x += gaussian(average a, stdev b)
+
+#define EXPR_REDUCE_NONE 0
+#define EXPR_REDUCE_SUM 1
+#define EXPR_REDUCE_SUMSQ 2
+#define EXPR_REDUCE_DOT 3	// sum x * arr[i]
+
+typedef struct _expr_op
+{
+	int type;
+	dtype a, b;				// constants of the operation
+	const dtype* arr;		// operand array of EXPR_ADD / EXPR_MUL
+	noise_handle noise;		// generator of EXPR_NOISE, NULL : the calling thread's (as rands)
+} expr_op_t;
+
+typedef struct _fa_expr
+{
+	expr_op_t ops[EXPR_MAX_OPS];
+	int n_ops;
+	int reduce;				// EXPR_REDUCE_*
+	const dtype* reduce_arr;	// operand of EXPR_REDUCE_DOT
+	dtype* block;			// EXPR_BLOCK elements in flight
+	dtype* scratch;			// EXPR_BLOCK noise samples
+} fa_expr_t;
+
+typedef fa_expr_t* expr_handle;
+
+expr_handle expr_create(void);
+void expr_destroy(expr_handle expr);
+void expr_reset(expr_handle expr);
+int expr_scale(expr_handle expr, const dtype factor);
+int expr_offset(expr_handle expr, const dtype offset);
+int expr_add(expr_handle expr, const dtype* arr);
+int expr_mul(expr_handle expr, const dtype* arr);
+int expr_noise(expr_handle expr, const dtype average, const dtype stdev, noise_handle noise);
+int expr_clamp(expr_handle expr, const dtype lo, const dtype hi);
+void expr_reduce(expr_handle expr, const int reduce, const dtype* arr);
+dtype expr_run(expr_handle expr, const dtype* in, dtype* out, const size_t n);
+dtype expr_run_fa(expr_handle expr, const fa_handle fa, dtype* out);
+
+/* wrapper function : expression pipeline */
+#define fa_expr_run expr_run
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          FAST SIGNAL GENERATION
+*******************************************************************************/
+void fast_sin(dtype * arr, const size_t size, float f0, float fs);
+void fast_cos(dtype * arr, const size_t size, float f0, float fs);
+void fast_sin_pidx(dtype * arr, const size_t size, float f0, float fs, pIdx idx);
+void fast_cos_pidx(dtype * arr, const size_t size, float f0, float fs, pIdx idx);
+void fast_sin_fa(fa_handle fa, float f0, float fs);
+void fast_cos_fa(fa_handle fa, float f0, float fs);
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          OSCILLATOR
+*******************************************************************************/
+/*
+* An oscillator advances OSC_LANES phasors z[l] = A e^(j(phase + (n + l) w)) together :
+* one complex multiply by e^(j OSC_LANES w) gives the next OSC_LANES samples, so the
+* recurrence vectorizes instead of waiting on the previous two samples.
+* The phasors are pulled back to unit length every OSC_RENORM steps,
+* so the amplitude does not drift over long runs. The output is A sin(phase + n w).
+*/
+#define OSC_LANES SIMD_LANES
+#define OSC_RENORM 64 // steps of OSC_LANES samples between renormalizations
+#define OSC_BLOCK 256 // frames per pass of osc_bank_process, renormalized after every pass
+#define OSC_BANK_FRAMES 16 // frames per kernel call of osc_bank_process
+
+typedef struct _oscillator
+{
+	dtype re[OSC_LANES], im[OSC_LANES];				// unit phasors of the next OSC_LANES samples
+	dtype step_re[OSC_LANES], step_im[OSC_LANES];	// e^(j OSC_LANES w) in every lane
+	dtype pow_re[OSC_LANES], pow_im[OSC_LANES];		// e^(j l w), l = 0..OSC_LANES - 1, w = 2 pi f0 / fs
+	dtype amp[OSC_LANES];							// amplitude in every lane
+} oscillator_t;
+
+typedef oscillator_t* osc_handle;
+
+osc_handle osc_create(float f0, float fs, dtype amplitude, float phase);
+void osc_destroy(osc_handle osc);
+void osc_reset(osc_handle osc, float phase);
+void osc_process(osc_handle osc, dtype* out, const size_t n);
+
+/* wrapper function : oscillator */
+#define fa_osc_process osc_process
+
+/*
+* An oscillator bank runs n_tones oscillators with their own frequency, amplitude and phase.
+* osc_bank_process writes every tone as a channel, interleaved like the channel bank
+* (out[n * n_tones + t]) and vectorized across tones.
+* osc_bank_mix writes the sum of the tones, vectorized along time.
+*/
+typedef struct _osc_bank
+{
+	size_t n_tones;
+	size_t stride;				// n_tones rounded up to OSC_LANES
+	dtype* re, * im;			// unit phasor of the next sample of every tone
+	dtype* step_re, * step_im;	// e^(j w) of every tone
+	dtype* amp;					// padded tones have zero amplitude
+	dtype* frames;				// OSC_BLOCK frames of stride samples, used when stride != n_tones
+} osc_bank_t;
+
+typedef osc_bank_t* osc_bank_handle;
+
+osc_bank_handle osc_bank_create(const size_t n_tones);
+void osc_bank_destroy(osc_bank_handle bank);
+void osc_bank_set_tone(osc_bank_handle bank, const size_t tone, float f0, float fs, dtype amplitude, float phase);
+void osc_bank_process(osc_bank_handle bank, dtype* out, const size_t n);
+void osc_bank_mix(osc_bank_handle bank, dtype* out, const size_t n);
+
+/* wrapper function : oscillator bank */
+#define fa_osc_bank_process osc_bank_process
+#define fa_osc_bank_mix osc_bank_mix
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          ADAPTIVE ALGORITHM
+*******************************************************************************/
+dtype least_mean_square(dtype * x, dtype * h, dtype * desired, dtype * y, dtype adapt_rate, dtype error,
+	int n_coeffecients, int n_output_samples);
+dtype fast_least_mean_square(dtype * x, dtype * h, dtype * desired, dtype * y, dtype adapt_rate, dtype error,
+	const int n_coeffecients, const int n_output_samples, pIdx x_idx, pIdx h_idx, pIdx d_idx, pIdx y_idx);
+
+/* wrapper function : lms */
+#define fa_lms least_mean_square
+#define fa_fast_lms fast_least_mean_square
+
+dtype least_mean_square_fa(const fa_handle x, dtype * h, dtype desired, dtype * y, dtype adapt_rate);
+
+/* wrapper function : handle lms */
+#define fa_handle_lms least_mean_square_fa
+
+/* adaptive filter engine */
+#define LMS_STANDARD 0
+#define LMS_NORMALIZED 1
+#define LMS_LEAKY 2
+
+#define LMS_DEFAULT_LEAKAGE 1e-4
+#define LMS_DEFAULT_REGULARIZATION 1e-6
+
+typedef struct _lms_filter
+{
+	int type;				// LMS_STANDARD, LMS_NORMALIZED, LMS_LEAKY
+	dtype* taps;			// aligned coefficients, taps[0] weights the newest sample
+	size_t n_taps;
+	dtype adapt_rate;		// mu
+	dtype leakage;			// leaky lms
+	dtype regularization;	// nlms epsilon
+	fa_handle history;		// n_taps + 1 input samples
+	dtype error;			// last error
+	dtype beta, gain;		// deferred update of the last sample
+	dtype energy;			// nlms : running |x(n)|^2
+	size_t count;			// nlms : pushes since the last exact energy
+} lms_filter_t;
+
+typedef lms_filter_t* lms_handle;
+
+lms_handle lms_create(const int type, const size_t n_taps, const dtype adapt_rate);
+void lms_destroy(lms_handle lms);
+void lms_reset(lms_handle lms);
+void lms_set_leakage(lms_handle lms, const dtype leakage);
+void lms_set_regularization(lms_handle lms, const dtype regularization);
+const dtype* lms_taps(lms_handle lms);
+dtype lms_process_sample(lms_handle lms, const dtype x, const dtype desired, dtype * y);
+dtype lms_process(lms_handle lms, const dtype * x, const dtype * desired, dtype * y, dtype * error, const size_t n);
+
+/* wrapper function : lms engine */
+#define fa_lms_process lms_process
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          CHANNEL BANK (MULTI-CHANNEL FIR / LMS)
+*******************************************************************************/
+/*
+* A bank runs n_channels independent FIR or LMS filters with the same tap count.
+* Samples are interleaved (channel-minor) : block[n * n_channels + c].
+* Taps and history are stored the same way, padded to BANK_LANES channels,
+* so the inner loops run over BANK_LANES adjacent channels and vectorize across channels.
+*/
+#define BANK_LANES SIMD_LANES
+
+#define BANK_FIR 0
+#define BANK_LMS 1
+
+typedef struct _fa_bank
+{
+	int kind;				// BANK_FIR, BANK_LMS
+	int lms_type;			// LMS_STANDARD, LMS_NORMALIZED, LMS_LEAKY
+	size_t n_channels;
+	size_t stride;			// n_channels rounded up to BANK_LANES
+	size_t n_taps;
+	size_t block;			// frames per pass
+	dtype* taps;			// taps[k * stride + c]
+	dtype* ring;			// mirrored ring of frames, 2 * size * stride
+	size_t size, mask;		// ring capacity in frames, power of two
+	pIdx idx;				// frame index of the newest frame
+	dtype adapt_rate, leakage, regularization;
+	dtype* beta, * gain;	// lms : deferred update per channel
+	dtype* energy;			// nlms : running input energy per channel
+	size_t count;			// nlms : frames since the last exact energy
+	fa_pool pool;			// NULL : single threaded
+	// arguments of the current pass, read by the workers
+	const dtype* in, * desired;
+	dtype* out, * error;
+	size_t n_frames, offset;
+} fa_bank_t;
+
+typedef fa_bank_t* bank_handle;
+
+bank_handle bank_fir_create(const size_t n_channels, const size_t n_taps, const size_t block);
+bank_handle bank_lms_create(const int lms_type, const size_t n_channels, const size_t n_taps, const dtype adapt_rate, const size_t block);
+void bank_destroy(bank_handle bank);
+void bank_reset(bank_handle bank);
+int bank_set_threads(bank_handle bank, int n_threads);
+void bank_set_taps(bank_handle bank, const size_t channel, const dtype* taps);
+void bank_get_taps(bank_handle bank, const size_t channel, dtype* taps);
+void bank_process(bank_handle bank, const dtype* in, const dtype* desired, dtype* out, dtype* error, const size_t n);
+
+/* wrapper function : channel bank */
+#define fa_bank_process bank_process
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          OPERATION
+*******************************************************************************/
+void autocor(dtype * __restrict r, const dtype * __restrict x, int autocor_len, int lag);
+void fast_autocor(dtype * __restrict r, const dtype * __restrict x, int autocor_len, int lag, pIdx r_idx, pIdx x_idx);
+dtype fir_filtering(dtype * x1, dtype * x2, const  size_t size);
+dtype fast_fir_filtering(dtype * x1, dtype * x2, const  size_t size, pIdx idx);
+dtype fast_fir_filtering_dpidx(dtype * x1, dtype * x2, const  size_t size, pIdx idx1, pIdx idx2);
+void autocor_fa(dtype * __restrict r, const fa_handle x, int lag);
+dtype fir_filtering_fa(const fa_handle x, dtype * h);
+
+/* wrapper function : cor */
+#define fa_autocor autocor
+#define fa_fast_autocor fast_autocor
+#define fa_handle_autocor autocor_fa
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          FIR FILTER ENGINE
+*******************************************************************************/
+#define FIR_DEFAULT_BLOCK 256 // samples per internal pass
+
+typedef struct _fir_filter
+{
+	dtype* taps;		// aligned copy of the coefficients, taps[0] weights the newest sample
+	size_t n_taps;
+	size_t block;		// samples per internal pass
+	fa_handle history;	// input history, length n_taps + block - 1
+} fir_filter_t;
+
+typedef fir_filter_t* fir_handle;
+
+fir_handle fir_create(const dtype* taps, const size_t n_taps, const size_t block);
+void fir_destroy(fir_handle fir);
+void fir_reset(fir_handle fir);
+void fir_set_taps(fir_handle fir, const dtype* taps);
+void fir_process(fir_handle fir, const dtype* in, dtype* out, const size_t n);
+dtype fir_process_sample(fir_handle fir, const dtype in);
+
+/* wrapper function : fir */
+#define fa_fir fir_process
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          POLYPHASE RESAMPLER
+*******************************************************************************/
+/*
+* Rational L/M resampler: the input is upsampled by up, filtered by the
+* prototype taps (designed at up * input rate) and downsampled by down,
+* but only the kept outputs are computed.
+* The taps are split into up phases of phase_taps coefficients, and every
+* output is one phase_taps long dot product over the input history.
+* up == 1 is a decimator, down == 1 an interpolator. An interpolator needs
+* taps with a passband gain of up to keep the signal level.
+*/
+typedef struct _resampler
+{
+	dtype* phases;		// phases[p * phase_taps + k] = taps[p + k * up], zero padded
+	size_t n_taps;
+	size_t phase_taps;	// ceil(n_taps / up)
+	size_t up, down;	// reduced by their gcd
+	size_t block;		// input samples per internal pass
+	size_t next;		// upsampled time of the next output, relative to the next input
+	fa_handle history;	// input history, length phase_taps + block - 1
+} resampler_t;
+
+typedef resampler_t* resampler_handle;
+
+resampler_handle resampler_create(const dtype* taps, const size_t n_taps, const size_t up, const size_t down, const size_t block);
+void resampler_destroy(resampler_handle rs);
+void resampler_reset(resampler_handle rs);
+size_t resampler_max_output(const resampler_handle rs, const size_t n);
+size_t resampler_process(resampler_handle rs, const dtype* in, const size_t n, dtype* out);
+
+#define decimator_create(taps, n_taps, factor, block) resampler_create(taps, n_taps, 1, factor, block)
+#define interpolator_create(taps, n_taps, factor, block) resampler_create(taps, n_taps, factor, 1, block)
+
+/* wrapper function : resampler */
+#define fa_resample resampler_process
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          IIR BIQUAD CASCADE
+*******************************************************************************/
+/*
+* n_sections second order sections per channel in transposed direct form II,
+* H(z) = prod (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+* Samples are interleaved like the channel bank, coefficients and state are
+* padded to BIQUAD_LANES channels, so one kernel call advances one section of
+* BIQUAD_LANES channels over a whole block. A mono cascade runs the sections
+* sample by sample instead, so the recurrences of the sections overlap.
+*/
+#define BIQUAD_LANES SIMD_LANES
+#define BIQUAD_DEFAULT_BLOCK 256 // frames per pass
+
+#define BIQUAD_LOWPASS 0
+#define BIQUAD_HIGHPASS 1
+#define BIQUAD_BANDPASS 2	// 0 dB peak gain
+#define BIQUAD_NOTCH 3
+#define BIQUAD_PEAK 4
+#define BIQUAD_LOWSHELF 5
+#define BIQUAD_HIGHSHELF 6
+
+typedef struct _biquad
+{
+	size_t n_sections;
+	size_t n_channels;
+	size_t stride;		// n_channels rounded up to BIQUAD_LANES
+	size_t block;		// frames per pass
+	dtype* coef;		// group g, section s : coef[((g * n_sections + s) * 5 + j) * BIQUAD_LANES + l]
+	dtype* state;		// group g, section s : state[((g * n_sections + s) * 2 + j) * BIQUAD_LANES + l]
+	dtype* work;		// block frames of stride channels, NULL when stride == n_channels
+} biquad_t;
+
+typedef biquad_t* biquad_handle;
+
+biquad_handle biquad_create(const size_t n_sections, const size_t n_channels, const size_t block);
+void biquad_destroy(biquad_handle bq);
+void biquad_reset(biquad_handle bq);
+void biquad_set_section(biquad_handle bq, const size_t channel, const size_t section, const dtype coef[5]);
+int biquad_design(const int type, const double f0, const double fs, const double q, const double gain_db, dtype coef[5]);
+void biquad_process(biquad_handle bq, const dtype* in, dtype* out, const size_t n);
+
+/* wrapper function : biquad */
+#define fa_biquad biquad_process
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          FFT(FAST FOURIER TRANSFORM)
+*******************************************************************************/
+/*
+* Complex data is stored as interleaved dtype pairs (re, im),
+* so a complex buffer of n points is a dtype array of length 2 * n.
+* A plan owns scratch memory : one plan must not run on two threads at once.
+*/
+#define FFT_MAX_FACTORS 64
+
+typedef struct _fa_complex
+{
+	dtype re, im;
+} fa_complex;
+
+typedef struct _fft_plan
+{
+	size_t n;							// transform length
+	int real;							// 1 : real input plan
+	int n_factors;
+	size_t factors[FFT_MAX_FACTORS];	// radix of each stage
+	size_t remain[FFT_MAX_FACTORS];		// sub transform length after each stage
+	size_t* perm;						// digit reversal table (bit reversal for powers of two)
+	fa_complex* twiddle;				// exp(-2 pi i k / n)
+	fa_complex* itwiddle;				// exp(+2 pi i k / n)
+	fa_complex* scratch;				// generic radix butterflies
+	fa_complex* work;					// n points of scratch
+	fa_complex* rtwiddle;				// real plan : split twiddles
+	struct _fft_plan* sub;				// real plan : complex plan of n / 2 (or n for odd n)
+} fft_plan_t;
+
+typedef fft_plan_t* fft_plan;
+
+fft_plan fft_create(const size_t n);
+fft_plan rfft_create(const size_t n);
+void fft_destroy(fft_plan plan);
+size_t fft_length(const fft_plan plan);
+
+void fft_forward(fft_plan plan, const dtype* in, dtype* out);
+void fft_inverse(fft_plan plan, const dtype* in, dtype* out);
+void rfft_forward(fft_plan plan, const dtype* in, dtype* out);
+void rfft_inverse(fft_plan plan, const dtype* in, dtype* out);
+
+size_t fft_good_size(const size_t n);
+
+/* wrapper function : fft */
+#define fa_fft fft_forward
+#define fa_ifft fft_inverse
+#define fa_rfft rfft_forward
+#define fa_irfft rfft_inverse
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          AUTOCORRELATION
+*******************************************************************************/
+int autocor_use_fft(const int autocor_len, const int lag);
+void autocor_direct(dtype * __restrict r, const dtype * __restrict x, const int autocor_len, const int lag);
+void autocor_fft(dtype * __restrict r, const dtype * __restrict x, const int autocor_len, const int lag);
+void autocor_fft_release(void); // frees the plan autocor_fft caches for the calling thread
+
+/* streaming autocorrelation over the latest autocor_len samples */
+typedef struct _autocor_stream
+{
+	int len;			// autocorrelation length
+	int lag;
+	fa_handle history;	// len + lag input samples
+	dtype* r;			// running lag vector
+	size_t count;		// pushes since the last exact refresh
+	size_t refresh;		// pushes between exact refreshes
+} autocor_stream_t;
+
+typedef autocor_stream_t* autocor_handle;
+
+autocor_handle autocor_stream_create(const int autocor_len, const int lag, const size_t refresh);
+void autocor_stream_destroy(autocor_handle ac);
+void autocor_stream_reset(autocor_handle ac);
+void autocor_stream_push(autocor_handle ac, const dtype sample);
+void autocor_stream_push_block(autocor_handle ac, const dtype* block, const size_t n);
+void autocor_stream_refresh(autocor_handle ac);
+const dtype* autocor_stream_result(const autocor_handle ac);
+
+/* wrapper function : streaming autocor */
+#define fa_stream_autocor autocor_stream_push
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          SLIDING CORRELATION
+*******************************************************************************/
+/*
+* Sliding DFT : selected bins of the DFT of the latest length samples,
+* X(k) = x(n - N + 1) + x(n - N + 2) e^(-2 pi i k / N) + ... (oldest sample first),
+* and the window energy, updated per push in O(n_bins) :
+* X(k) <- (X(k) - x(n - N) + x(n)) e^(+2 pi i k / N).
+* With a reference set, the correlation sum ref[m] x(n - N + 1 + m) is
+* taken from the bins by Parseval, exact when the bins cover 0 .. N / 2 and
+* the projection of the reference on the bins otherwise (narrowband references).
+* Bins and energy are recomputed exactly every refresh pushes.
+*/
+typedef struct _sliding_dft
+{
+	size_t length;			// window length N
+	size_t n_bins;
+	size_t* bins;			// bin indices, 0 .. N / 2
+	dtype* x_re, * x_im;	// bins of the window
+	dtype* w_re, * w_im;	// e^(+2 pi i k / N)
+	fa_complex* table;		// e^(-2 pi i j / N), j = 0 .. N - 1, for the exact refresh
+	dtype* h_re, * h_im;	// weighted conjugate bins of the reference, NULL : no reference
+	dtype energy;			// running sum of squares of the window
+	dtype ref_energy;		// sum of squares of the reference
+	fa_handle history;		// length + 1 samples, the leaving sample is the oldest
+	size_t count;			// pushes since the last exact refresh
+	size_t refresh;			// pushes between exact refreshes
+} sliding_dft_t;
+
+typedef sliding_dft_t* sdft_handle;
+
+sdft_handle sdft_create(const size_t length, const size_t* bins, const size_t n_bins, const size_t refresh);
+void sdft_destroy(sdft_handle sdft);
+void sdft_reset(sdft_handle sdft);
+void sdft_set_reference(sdft_handle sdft, const dtype* ref);
+void sdft_push(sdft_handle sdft, const dtype sample);
+void sdft_push_block(sdft_handle sdft, const dtype* block, const size_t n);
+void sdft_refresh(sdft_handle sdft);
+fa_complex sdft_bin(const sdft_handle sdft, const size_t i);
+dtype sdft_energy(const sdft_handle sdft);
+dtype sdft_correlation(const sdft_handle sdft);
+dtype sdft_coefficient(const sdft_handle sdft);
+
+/*
+* Block correlator : c(n) = ref[0] x(n - N + 1) + ... + ref[N - 1] x(n) for every
+* input sample, the match of the whole reference ending at n. Uniformly partitioned
+* overlap-save : the reversed reference is cut into n_parts partitions of block taps,
+* every completed frame of block samples costs one real FFT pair of 2 block points
+* and n_parts spectral products, so long references run at block latency.
+* Samples of a frame not yet completed are correlated directly from the history.
+*/
+typedef struct _xcorr
+{
+	size_t length;			// reference length N
+	size_t block;			// partition and frame length B
+	size_t n_parts;			// ceil(N / B)
+	size_t fft_len;			// 2 B
+	size_t delay;			// history kept ahead of the frame, max(N - 1, B)
+	dtype* ref;				// reference in time order, for the direct path
+	dtype* spectra;			// n_parts spectra of the reversed reference, fft_len + 2 each
+	dtype* fdl;				// n_parts input spectra, frequency domain delay line
+	dtype* acc;				// fft_len + 2, sum of the spectral products
+	dtype* line;			// delay + B input samples in time order, the current frame last
+	size_t fill;			// samples of the current frame
+	size_t slot;			// fdl slot of the current frame
+	fft_plan plan;
+} xcorr_t;
+
+typedef xcorr_t* xcorr_handle;
+
+xcorr_handle xcorr_create(const dtype* ref, const size_t length, const size_t block);
+void xcorr_destroy(xcorr_handle xc);
+void xcorr_reset(xcorr_handle xc);
+void xcorr_process(xcorr_handle xc, const dtype* in, dtype* out, const size_t n);
+
+/* wrapper function : sliding correlation */
+#define fa_sdft_push sdft_push
+#define fa_xcorr xcorr_process
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          PRINT ARRAY
+*******************************************************************************/
+void print_arr1d(dtype * arr, const size_t size, type_t data_type);
+void print_arr1d_pidx(dtype * arr, const size_t size, type_t data_type, pIdx ptr_idx);
+void print_arr1d_fa(const fa_handle fa, type_t data_type);
 #endif
\ No newline at end of file
@@ -1,168 +1,218 @@
-/**
-* @ author : junyeong heo
-*
-* /@brief fast array algorithms demo
-*/
-
-#define _CRT_SECURE_NO_WARNINGS
-
-#include "fast_array.h"
-#include "util.h"
-
-#define LENGTH 1000
-#define LENGTH2 ((2) * (LENGTH))
-
-#define ITERATION 1000000
-
-#define ORDER 10
-
-#define __DEBUG5__
-
-#ifdef __DEBUG2__
-
-int main(void)
-{
-	/* local variables for push routine */
-	dtype push_a[LENGTH] = { 0, }; // normal array
-	dtype push_b[LENGTH] = { 0, };
-	dtype push_c[LENGTH2] = { 0, }; // fast array needs twice as much memory
-
-	clock_t start[3], end[3];
-	pIdx ptr_idx = 0;
-
-	const int n_samples = LENGTH / 100;
-
-	/* local variables for lms routine */
-	dtype lms_x[LENGTH];	// input signal
-	dtype lms_h[ORDER];	// filter weight
-	dtype lms_y[LENGTH]; // filter output
-	dtype lms_d[LENGTH]; // desired input
-	dtype lms_e = 0; // error signal
-
-	/* variables for iteration */
-	int i, j, k;
-	/******************************************************************************
-	**                          FAST ARRAY DEMO 1
-	**                          PUSH ROUTINE
-	*******************************************************************************/
-
-	printf("I'm Alive!! :)\n");
-	start[0] = clock();
-	for (i = 0; i < ITERATION; i++)
-	{
-		fa_push_(push_a, LENGTH, (dtype)(i * 0.01));
-	}
-	end[0] = clock();
-
-	printf("I'm Alive!! :)\n");
-	start[1] = clock();
-	for (i = 0; i < ITERATION; i++)
-	{
-		fa_push(push_b, LENGTH, (dtype)(i * 0.01));
-	}
-	end[1] = clock();
-
-	printf("I'm Alive!! :)\n");
-	start[2] = clock();
-	for (i = 0; i < ITERATION; i++)
-	{
-		fa_fast_push_shift(push_c, LENGTH, ptr_idx, (dtype)(i * 0.01));
-	}
-	end[2] = clock();
-
-	printf("I'm Alive!! :)\n");
-	printf("comparsion of push algorithm time\n1. using for %d ms\n2. using memmove : %d ms\n3. using pIdx : %d ms\n",
-		end[0] - start[0], end[1] - start[1], end[2] - start[2]);
-
-	printf("Result test sample 1 : "); print_arrf(push_a, n_samples);
-	printf("Result test sample 2 : "); print_arrf(push_b, n_samples);
-	printf("Result test sample 3 : "); print_arrf_vect(push_c, n_samples, ptr_idx);
-
-	/******************************************************************************
-	**                          FAST ARRAY DEMO 2
-	**                          ADF ROUTINE
-	*******************************************************************************/
-
-	float f0 = 880, fs = 8000, phase = 0;
-	i = 2;
-
-	cos_(lms_d, LENGTH, 880, 8000, 0);
-	sin_(lms_x, LENGTH, 880, 8000, 0);
-	zeros(lms_y, LENGTH);
-	zeros(lms_h, ORDER);
-
-	fa_lms(lms_x, lms_h, lms_d, lms_y, 0.01, lms_e, ORDER, LENGTH);
-
-}
-#endif
-
-#ifdef __DEBUG3__
-
-#define L 1024 // filter length
-#define L2 512 // ((L)/(2))
-
-int main(void)
-{	
-	/* local variables for lms routine */
-	dtype lms_x[LENGTH];	// input signal
-	dtype lms_h[ORDER];	// filter weight
-	dtype lms_y[LENGTH]; // filter output
-	dtype lms_d[LENGTH]; // desired input
-	dtype lms_e = 0; // error signal
-
-	float f0 = 880, fs = 8000, phase = 0;
-	int i = 2;
-
-	cos_(lms_d, LENGTH, 880, 8000, 0);
-	sin_(lms_x, LENGTH, 880, 8000, 0);
-	zeros(lms_y, LENGTH);
-	zeros(lms_h, ORDER);
-
-	scaling(lms_d, LENGTH, 30);
-
-	while (i < 10)
-	{
-		printf("final error : %f \n", fa_lms(lms_x, lms_h, lms_d, lms_y, 0.01, lms_e, ORDER, 20));
-		i++;
-	}
-	print_arr1d(lms_h, ORDER, "float");
-}
-#endif
-
-#ifdef __DEBUG4__
-
-int main(void)
-{
-	int arr[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0 };
-	int brr[10] = { 0, };
-	//write_data_file(arr, 10, "ss", '\t', "int22");
-	read_data_file(brr, 10, "test", '\t', "int32");
-
-	print_arr1d(brr, 10, "int");
-	printf("%s", concat("a", "b"));
-
-	printf("Multi-channel LMS Test");
-
-
-}
-#endif
-
-#ifdef __DEBUG5__
-
-int main(void)
-{
-#define ONE_PERIOD 40000
-	/* local variables for lms routine */
-	dtype lms_x[ONE_PERIOD];	// input signal
-	dtype lms_h[ONE_PERIOD];	// filter weight
-
-	fast_cos(lms_x, ONE_PERIOD, 10, 4000);
-	fast_sin(lms_h, ONE_PERIOD, 10, 4000);
-
-	print_arr1d(lms_x, ONE_PERIOD, "float");
-	print_arr1d(lms_h, ONE_PERIOD, "float");
-
-	printf("cdot = %f \n", fir_filtering(lms_x, lms_h, ONE_PERIOD));
-}
-
+/**
+* @ author : junyeong heo
+*
+* /@brief fast array algorithms demo
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "fast_array.h"
+#include "util.h"
+#include "bench.h"
+
+#define LENGTH 1000
+#define LENGTH2 ((2) * (LENGTH))
+
+#define ORDER 10
+
+/*
+* __BENCH__ : benchmark harness (bench.c), the push / kernel timing lives there
+* __DEBUG3__ : lms demo
+* __DEBUG4__ : file io demo
+* __DEBUG5__ : fast sin / cos demo
+* __DEBUG6__ : binary trace demo, "fast_array file" decodes a trace file
+* __DEBUG7__ : edge case checks, exits with the number of failures
+*/
+#define __BENCH__
+
+#ifdef __BENCH__
+
+int main(int argc, char** argv)
+{
+	return bench_main(argc, argv);
+}
+#endif
+
+#ifdef __DEBUG3__
+
+#define L 1024 // filter length
+#define L2 512 // ((L)/(2))
+
+int main(void)
+{	
+	/* local variables for lms routine */
+	dtype lms_x[LENGTH];	// input signal
+	dtype lms_h[ORDER];	// filter weight
+	dtype lms_y[LENGTH]; // filter output
+	dtype lms_d[LENGTH]; // desired input
+	dtype lms_e = 0; // error signal
+
+	float f0 = 880, fs = 8000, phase = 0;
+	int i = 2;
+
+	cos_(lms_d, LENGTH, 880, 8000, 0);
+	sin_(lms_x, LENGTH, 880, 8000, 0);
+	zeros(lms_y, LENGTH);
+	zeros(lms_h, ORDER);
+
+	scaling(lms_d, LENGTH, 30);
+
+	while (i < 10)
+	{
+		printf("final error : %f \n", fa_lms(lms_x, lms_h, lms_d, lms_y, 0.01, lms_e, ORDER, 20));
+		i++;
+	}
+	print_arr1d(lms_h, ORDER, "float");
+}
+#endif
+
+#ifdef __DEBUG4__
+
+int main(void)
+{
+	int arr[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0 };
+	int brr[10] = { 0, };
+	//write_data_file(arr, 10, "ss", '\t', "int22");
+	read_data_file(brr, 10, "test", '\t', "int32");
+
+	print_arr1d(brr, 10, "int");
+	printf("%s", concat("a", "b"));
+
+	printf("Multi-channel LMS Test");
+
+
+}
+#endif
+
+#ifdef __DEBUG5__
+
+int main(void)
+{
+#define ONE_PERIOD 40000
+	/* local variables for lms routine */
+	dtype lms_x[ONE_PERIOD];	// input signal
+	dtype lms_h[ONE_PERIOD];	// filter weight
+
+	fast_cos(lms_x, ONE_PERIOD, 10, 4000);
+	fast_sin(lms_h, ONE_PERIOD, 10, 4000);
+
+	print_arr1d(lms_x, ONE_PERIOD, "float");
+	print_arr1d(lms_h, ONE_PERIOD, "float");
+
+	printf("cdot = %f \n", fir_filtering(lms_x, lms_h, ONE_PERIOD));
+}
+
+#endif
+
+#ifdef __DEBUG6__
+
+int main(int argc, char** argv)
+{
+	dtype x[LENGTH], h[ORDER], y[LENGTH], d[LENGTH];
+
+	if (argc > 1) return trace_decode(argv[1], stdout) < 0;
+
+	sin_(x, LENGTH, 880, 8000, 0);
+	cos_(d, LENGTH, 880, 8000, 0);
+	zeros(h, ORDER);
+
+	trace_start("trace.bin");
+	dot_product_pidx_debug(x, d, ORDER, 0);
+	fa_lms(x, h, d, y, 0.01, 0, ORDER, 20);
+	trace_stop();
+
+	return trace_decode("trace.bin", stdout) < 0;
+}
+
+#endif
+
+#ifdef __DEBUG7__
+
+static int check_fft(const size_t n)
+{
+	/* fft_forward against the direct dft, then the round trip, for lengths with several generic factors */
+
+	fft_plan plan = fft_create(n);
+	dtype* x = (dtype*)malloc(sizeof(dtype) * 2 * n), * X = (dtype*)malloc(sizeof(dtype) * 2 * n);
+	double re, im, err = 0;
+	size_t k, j;
+
+	for (k = 0; k < 2 * n; k++) x[k] = sin(0.37 * k) + cos(1.1 * k);
+	fft_forward(plan, x, X);
+	for (k = 0; k < n; k++)
+	{
+		for (re = im = 0, j = 0; j < n; j++)
+		{
+			re += x[2 * j] * cos(-2 * 3.14159265358979323846 * j * k / n) - x[2 * j + 1] * sin(-2 * 3.14159265358979323846 * j * k / n);
+			im += x[2 * j] * sin(-2 * 3.14159265358979323846 * j * k / n) + x[2 * j + 1] * cos(-2 * 3.14159265358979323846 * j * k / n);
+		}
+		err = fmax(err, fmax(fabs(re - X[2 * k]), fabs(im - X[2 * k + 1])));
+	}
+	fft_inverse(plan, X, X);
+	for (k = 0; k < 2 * n; k++) err = fmax(err, fabs(X[k] - x[k]));
+
+	printf("fft %zu : max error %g \n", n, err);
+	fft_destroy(plan);
+	free(x), free(X);
+	return err > 1e-12 * n;
+}
+
+static int check_rfft(const size_t n)
+{
+	/* rfft round trip, the half length complex plan has the generic factors */
+
+	fft_plan plan = rfft_create(n);
+	dtype* x = (dtype*)malloc(sizeof(dtype) * (n + 2)), * X = (dtype*)malloc(sizeof(dtype) * (n + 2));
+	double err = 0;
+	size_t k;
+
+	for (k = 0; k < n; k++) x[k] = sin(0.37 * k) + cos(1.1 * k);
+	rfft_forward(plan, x, X);
+	rfft_inverse(plan, X, X);
+	for (k = 0; k < n; k++) err = fmax(err, fabs(X[k] - x[k]));
+
+	printf("rfft %zu : max error %g \n", n, err);
+	fft_destroy(plan);
+	free(x), free(X);
+	return err > 1e-12 * n;
+}
+
+static int check_autocor_fa(const size_t length, const int lag)
+{
+	/* autocor_fa against autocor_direct on the window, a lag of length or more clears r */
+
+	fa_handle x = fa_create(length);
+	dtype* w = (dtype*)malloc(sizeof(dtype) * length), * r = (dtype*)malloc(sizeof(dtype) * lag), * ref = (dtype*)calloc(lag, sizeof(dtype));
+	double err = 0;
+	int i;
+
+	for (i = 0; i < (int)length; i++) w[i] = sin(0.37 * i) + cos(1.1 * i);
+	push_block_fa(x, w, length);
+	for (i = 0; i < lag; i++) r[i] = 1;
+	autocor_fa(r, x, lag);
+	if ((size_t)lag < length) autocor_direct(ref, fa_window(x), (int)length - lag, lag);
+	for (i = 0; i < lag; i++) err = fmax(err, fabs(r[i] - ref[i]));
+
+	printf("autocor_fa %zu lag %d : max error %g \n", length, lag, err);
+	fa_destroy(x);
+	free(w), free(r), free(ref);
+	return err > 1e-9 * length;
+}
+
+int main(void)
+{
+	int failed = 0;
+
+	failed += check_fft(77);	// 7 * 11
+	failed += check_fft(143);	// 11 * 13
+	failed += check_fft(1001);	// 7 * 11 * 13
+	failed += check_rfft(154);	// 2 * 7 * 11
+	failed += check_autocor_fa(64, 63);
+	failed += check_autocor_fa(64, 64);	// nothing left to correlate
+	failed += check_autocor_fa(64, 100);
+
+	printf("%d failed \n", failed);
+	return failed;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,506 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Seedable noise : xoshiro256++ streams advanced by the simd kernels,
+** uniform and normal (ziggurat) variates filled a block at a time.
+** Every thread gets its own default stream for rands / gaussian_random.
+*/
+
+#include "noise.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define NOISE_THREAD_LOCAL __declspec(thread)
+#else
+#define NOISE_THREAD_LOCAL _Thread_local
+#endif
+
+#define NOISE_UNIT (1.0 / 9007199254740992.0) // 2^-53
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          ZIGGURAT TABLES
+*******************************************************************************/
+/*
+* Marsaglia & Tsang setup for 256 layers and a 52 bit magnitude :
+* sample u -> layer u & 0xFF, sign bit 8, magnitude u >> 12,
+* accepted at once when magnitude < zig_k[layer], x = magnitude * zig_w[layer].
+* zig_f[layer] = exp(-x^2 / 2) at the layer edges.
+*/
+static const uint64_t zig_k[NOISE_ZIG_LAYERS] = {
+	0xef33d8025bc39ULL, 0x0000000000000ULL, 0xc08be98f2acaaULL, 0xda354faba4236ULL,
+	0xe51f67ec049b5ULL, 0xeb255e9d2fa41ULL, 0xeef4b817e221cULL, 0xf19470af9cc80ULL,
+	0xf37ed61ff712fULL, 0xf4f469560df95ULL, 0xf61a5e41b6be3ULL, 0xf707a75536926ULL,
+	0xf7cb2ec281ec3ULL, 0xf86f10c6337d8ULL, 0xf8fa657830a7dULL, 0xf9724c74db926ULL,
+	0xf9da907dbe051ULL, 0xfa360f581e82eULL, 0xfa86fde5b3bbfULL, 0xfacf160d34659ULL,
+	0xfb0fb6718ac00ULL, 0xfb49f8d5368f8ULL, 0xfb7ec2366f3bdULL, 0xfbaece9a1db42ULL,
+	0xfbdab9d0402f5ULL, 0xfc03060ff6415ULL, 0xfc28210379aaaULL, 0xfc4a67ae254c2ULL,
+	0xfc6a2977ae7a3ULL, 0xfc87aa928908bULL, 0xfca325e4bd8d4ULL, 0xfcbcce9021dc6ULL,
+	0xfcd4d12f834c6ULL, 0xfceb54d8fe7e7ULL, 0xfd007bf1dc4c6ULL, 0xfd1464dd6c0baULL,
+	0xfd272a8e2f060ULL, 0xfd38e4ff0c565ULL, 0xfd49a9990b0f2ULL, 0xfd598b8920bf9ULL,
+	0xfd689c08e96bdULL, 0xfd76ea9c8e52aULL, 0xfd848547b0606ULL, 0xfd9178bad29cbULL,
+	0xfd9dd07a7ab31ULL, 0xfda9970105c08ULL, 0xfdb4d5dc02bb8ULL, 0xfdbf95c5bfa83ULL,
+	0xfdc9debb99848ULL, 0xfdd3b8118707fULL, 0xfddd288342d86ULL, 0xfde6364369d6fULL,
+	0xfdeee708d4f6dULL, 0xfdf7401a6b25eULL, 0xfdff46599eb80ULL, 0xfe06fe4bc2343ULL,
+	0xfe0e6c225a0b8ULL, 0xfe1593c28b6baULL, 0xfe1c78cbc3e15ULL, 0xfe231e9db1b32ULL,
+	0xfe29885da1a27ULL, 0xfe2fb8fb54027ULL, 0xfe35b33558bf6ULL, 0xfe3b799cffee1ULL,
+	0xfe410e99eac3fULL, 0xfe46746d475ffULL, 0xfe4bad34c082fULL, 0xfe50baed29401ULL,
+	0xfe559f74ebb5cULL, 0xfe5a5c8e410ffULL, 0xfe5ef3e13857dULL, 0xfe6366fd90f74ULL,
+	0xfe67b75c6d47cULL, 0xfe6be661e10b4ULL, 0xfe6ff55e5f402ULL, 0xfe73e5900a617ULL,
+	0xfe77b823e9d56ULL, 0xfe7b6e3706fc3ULL, 0xfe7f08d77416bULL, 0xfe8289053efb9ULL,
+	0xfe85efb35166dULL, 0xfe893dc84079bULL, 0xfe8c741f0cdf7ULL, 0xfe8f9387d4e36ULL,
+	0xfe929cc879a62ULL, 0xfe95909d38833ULL, 0xfe986fb9399eeULL, 0xfe9b3ac7147b7ULL,
+	0xfe9df2694b62aULL, 0xfea0973abe5d4ULL, 0xfea329cf16600ULL, 0xfea5aab32948cULL,
+	0xfea81a6d5737cULL, 0xfeaa797de1c56ULL, 0xfeacc85f3d889ULL, 0xfeaf07865e5a9ULL,
+	0xfeb13762feb82ULL, 0xfeb3585fe29bdULL, 0xfeb56ae316229ULL, 0xfeb76f4e28470ULL,
+	0xfeb965fe61f8dULL, 0xfebb4f4cf9cf9ULL, 0xfebd2b8f4494fULL, 0xfebefb16e2dbfULL,
+	0xfec0be31ebd6cULL, 0xfec2752b1599aULL, 0xfec42049daf5bULL, 0xfec5bfd29f121ULL,
+	0xfec75406cee81ULL, 0xfec8dd2500c42ULL, 0xfeca5b6911ea1ULL, 0xfecbcf0c42790ULL,
+	0xfecd38454faa9ULL, 0xfece97488c84aULL, 0xfecfec47f914fULL, 0xfed13773584c1ULL,
+	0xfed278f84489eULL, 0xfed3b10242ee8ULL, 0xfed4dfbad580bULL, 0xfed605498c37cULL,
+	0xfed721d414f89ULL, 0xfed8357e4a924ULL, 0xfed9406a42c6dULL, 0xfeda42b85b6a9ULL,
+	0xfedb3c8746a5aULL, 0xfedc2df4165faULL, 0xfedd171a46dfcULL, 0xfeddf813c8a7dULL,
+	0xfeded0f90992cULL, 0xfedfa1e0fd3c1ULL, 0xfee06ae124b73ULL, 0xfee12c0d959b5ULL,
+	0xfee1e57900690ULL, 0xfee29734b64d6ULL, 0xfee34150ae46fULL, 0xfee3e3db89af0ULL,
+	0xfee47ee2982a8ULL, 0xfee51271db03cULL, 0xfee59e9407ef7ULL, 0xfee623528b3e5ULL,
+	0xfee6a0b5897a9ULL, 0xfee716c3e0733ULL, 0xfee7858327b3bULL, 0xfee7ecf7b0674ULL,
+	0xfee84d2484a6eULL, 0xfee8a60b662ffULL, 0xfee8f7accc80fULL, 0xfee94207e2598ULL,
+	0xfee9851a829aaULL, 0xfee9c0e13481aULL, 0xfee9f557273b4ULL, 0xfeea22762cc70ULL,
+	0xfeea4836b426dULL, 0xfeea668fc2d34ULL, 0xfeea7d76ed6bdULL, 0xfeea8ce04f9ceULL,
+	0xfeea94be83300ULL, 0xfeea9502963d4ULL, 0xfeea8d9c00723ULL, 0xfeea7e789761aULL,
+	0xfeea678481cecULL, 0xfeea48aa29e4aULL, 0xfeea21d22e4a2ULL, 0xfee9f2e351fedULL,
+	0xfee9bbc26aef8ULL, 0xfee97c524f2adULL, 0xfee93473c0a03ULL, 0xfee8e405574e0ULL,
+	0xfee88ae369c44ULL, 0xfee828e7f3dc9ULL, 0xfee7bdea7b854ULL, 0xfee749bff37cbULL,
+	0xfee6cc3a9bd2cULL, 0xfee64529e004dULL, 0xfee5b45a32857ULL, 0xfee51994e5785ULL,
+	0xfee474a00069eULL, 0xfee3c53e12c1eULL, 0xfee30b2e02aa7ULL, 0xfee2462ad81d4ULL,
+	0xfee175eb83c2aULL, 0xfee09a22a1417ULL, 0xfedfb27e3499cULL, 0xfedebea76213eULL,
+	0xfeddbe422044fULL, 0xfedcb0ece39a5ULL, 0xfedb964042cc6ULL, 0xfeda6dce9389cULL,
+	0xfed937237e95fULL, 0xfed7f1c38a80aULL, 0xfed69d2b9bffeULL, 0xfed538d06add3ULL,
+	0xfed3c41dea3f7ULL, 0xfed23e76a2facULL, 0xfed0a732fe617ULL, 0xfecefda07fe08ULL,
+	0xfecd4100eb78cULL, 0xfecb708956e89ULL, 0xfec98b6123096ULL, 0xfec790a0da94eULL,
+	0xfec57f50f31d4ULL, 0xfec356686c938ULL, 0xfec114cb4b30bULL, 0xfebeb948e6fa7ULL,
+	0xfebc429a0b668ULL, 0xfeb9af5ee0cb3ULL, 0xfeb6fe1c98519ULL, 0xfeb42d3ad1f75ULL,
+	0xfeb13b00b2d23ULL, 0xfeae2591a02c0ULL, 0xfeaaeae99222dULL, 0xfea788d8ee2feULL,
+	0xfea3fcffd73bcULL, 0xfea044c8dd9ceULL, 0xfe9c5d62f5612ULL, 0xfe9843ba9477aULL,
+	0xfe93f471d4700ULL, 0xfe8f6bd76c5adULL, 0xfe8aa5dc4e8bdULL, 0xfe859e07ab1c1ULL,
+	0xfe804f690a917ULL, 0xfe7ab48823396ULL, 0xfe74c751f6a7cULL, 0xfe6e8102aa1d9ULL,
+	0xfe67da0b6abafULL, 0xfe60c9f383055ULL, 0xfe5947338f718ULL, 0xfe51470977256ULL,
+	0xfe48bd436f42dULL, 0xfe3f9bffd1e0dULL, 0xfe35d35eeb171ULL, 0xfe2b5122fe4d2ULL,
+	0xfe2000399552bULL, 0xfe13c827882e8ULL, 0xfe068c4ee6783ULL, 0xfdf82b02b717dULL,
+	0xfde87c57efe7cULL, 0xfdd7509c63bceULL, 0xfdc46e529bee3ULL, 0xfdaf8f82e0252ULL,
+	0xfd985e1b2ba43ULL, 0xfd7e6ef48ced0ULL, 0xfd613adbd64d6ULL, 0xfd40149e2efdaULL,
+	0xfd1a1a7b4c772ULL, 0xfcee204761f61ULL, 0xfcba8d85e1171ULL, 0xfc7d26ecd2cdeULL,
+	0xfc32b2f1e22a1ULL, 0xfbd6581c0b7e7ULL, 0xfb606c40053d6ULL, 0xfac40582a2805ULL,
+	0xf9e971e014510ULL, 0xf89fa48a41d49ULL, 0xf66c5f7f02f1aULL, 0xf1a5a4b331a0aULL
+};
+static const double zig_w[NOISE_ZIG_LAYERS] = {
+	8.683627060828347e-16, 4.7793301741377593e-17, 6.354352416410258e-17, 7.454870480493524e-17,
+	8.329366815173283e-17, 9.068060404526806e-17, 9.714860076096846e-17, 1.0294750313816509e-16,
+	1.0823430288059529e-16, 1.131147019575026e-16, 1.1766359456688471e-16, 1.2193617278400444e-16,
+	1.259743991434077e-16, 1.2981099885983e-16, 1.3347203736556521e-16, 1.3697864842315511e-16,
+	1.4034823000997335e-16, 1.4359529451821483e-16, 1.4673208742137644e-16, 1.4976904668172175e-16,
+	1.5271515003384589e-16, 1.555781816925582e-16, 1.58364940090921e-16, 1.6108140175081854e-16,
+	1.6373285203782087e-16, 1.6632399058238027e-16, 1.6885901708498422e-16, 1.713417017638584e-16,
+	1.7377544365695136e-16, 1.7616331922835133e-16, 1.785081231681451e-16, 1.8081240285640384e-16,
+	1.8307848764671256e-16, 1.8530851388465636e-16, 1.8750444639224454e-16, 1.8966809700628152e-16,
+	1.9180114064694707e-16, 1.9390512930483762e-16, 1.9598150426489938e-16, 1.9803160682991647e-16,
+	2.0005668776139063e-16, 2.0205791561939557e-16, 2.04036384153502e-16, 2.0599311887275701e-16,
+	2.0792908290287945e-16, 2.0984518222246143e-16, 2.117422703563793e-16, 2.136211525932919e-16,
+	2.1548258978462456e-16, 2.1732730177446985e-16, 2.1915597050311459e-16, 2.2096924282121024e-16,
+	2.227677330467673e-16, 2.2455202529302963e-16, 2.263226755917567e-16, 2.280802138334151e-16,
+	2.298251455431733e-16, 2.3155795350934717e-16, 2.3327909927899507e-16, 2.349890245336731e-16,
+	2.3668815235689126e-16, 2.3837688840352904e-16, 2.4005562198034833e-16, 2.417247270457588e-16,
+	2.4338456313612944e-16, 2.45035476225179e-16, 2.4667779952231006e-16, 2.483118542151581e-16,
+	2.499379501611042e-16, 2.5155638653203404e-16, 2.5316745241621325e-16, 2.547714273807808e-16,
+	2.5636858199803476e-16, 2.579591783383904e-16, 2.595434704326291e-16, 2.6112170470582226e-16,
+	2.626941203851009e-16, 2.6426094988325525e-16, 2.658224191599747e-16, 2.6737874806238796e-16,
+	2.689301506464206e-16, 2.7047683548036584e-16, 2.7201900593194673e-16, 2.735568604400485e-16,
+	2.7509059277220414e-16, 2.7662039226883326e-16, 2.781464440751553e-16, 2.796689293616304e-16,
+	2.811880255337159e-16, 2.8270390643166804e-16, 2.8421674252106693e-16, 2.8572670107469254e-16,
+	2.872339463463364e-16, 2.887386397370925e-16, 2.9024093995463437e-16, 2.917410031659504e-16,
+	2.932389831439797e-16, 2.9473503140856054e-16, 2.9622929736207917e-16, 2.977219284201809e-16,
+	2.9921307013788463e-16, 3.0070286633142165e-16, 3.0219145919609987e-16, 3.03678989420479e-16,
+	3.051655962971257e-16, 3.066514178302042e-16, 3.0813659084014336e-16, 3.0962125106561073e-16,
+	3.111055332630125e-16, 3.125895713037278e-16, 3.1407349826927714e-16, 3.1555744654461717e-16,
+	3.1704154790974445e-16, 3.1852593362978663e-16, 3.200107345437515e-16, 3.214960811520994e-16,
+	3.2298210370330056e-16, 3.2446893227953307e-16, 3.2595669688167537e-16, 3.2744552751374234e-16,
+	3.2893555426691273e-16, 3.304269074032927e-16, 3.3191971743955903e-16, 3.3341411523062504e-16,
+	3.349102320534696e-16, 3.364081996912721e-16, 3.379081505179944e-16, 3.394102175835522e-16,
+	3.409145346997196e-16, 3.424212365269125e-16, 3.4393045866199745e-16, 3.4544233772727637e-16,
+	3.4695701146079997e-16, 3.4847461880816654e-16, 3.4999530001596677e-16, 3.5151919672703956e-16,
+	3.530464520777096e-16, 3.545772107971826e-16, 3.5611161930928127e-16, 3.5764982583671083e-16,
+	3.5919198050805217e-16, 3.6073823546768767e-16, 3.62288744988875e-16, 3.638436655901936e-16,
+	3.6540315615559934e-16, 3.669673780583357e-16, 3.6853649528896015e-16, 3.7011067458776174e-16,
+	3.716900855818573e-16, 3.732749009272725e-16, 3.748652964563301e-16, 3.764614513306871e-16,
+	3.7806354820038333e-16, 3.796717733692847e-16, 3.81286316967331e-16, 3.829073731300205e-16,
+	3.8453514018559503e-16, 3.8616982085041696e-16, 3.8781162243306366e-16, 3.8946075704770047e-16,
+	3.9111744183733125e-16, 3.9278189920756777e-16, 3.9445435707160414e-16, 3.961350491071328e-16,
+	3.978242150259903e-16, 3.995221008573813e-16, 4.0122895924559053e-16, 4.0294504976316317e-16,
+	4.0467063924060814e-16, 4.064060021137609e-16, 4.0815142079003244e-16, 4.099071860348679e-16,
+	4.1167359737984646e-16, 4.134509635539701e-16, 4.1523960293981795e-16, 4.170398440563833e-16,
+	4.1885202607056557e-16, 4.206764993394585e-16, 4.2251362598576456e-16, 4.243637805088701e-16,
+	4.2622735043434475e-16, 4.281047370048792e-16, 4.299963559159534e-16, 4.3190263809983563e-16,
+	4.338240305618544e-16, 4.3576099727326276e-16, 4.3771402012543917e-16, 4.396835999506351e-16,
+	4.4167025761500585e-16, 4.4367453519024474e-16, 4.456969972107949e-16, 4.477382320243465e-16,
+	4.497988532441506e-16, 4.51879501312604e-16, 4.53980845186604e-16, 4.561035841563454e-16,
+	4.582484498105624e-16, 4.604162081627236e-16, 4.626076619543955e-16, 4.648236531539341e-16,
+	4.67065065670879e-16, 4.693328283089513e-16, 4.716279179834561e-16, 4.739513632322101e-16,
+	4.763042480529397e-16, 4.786877161045007e-16, 4.811029753143727e-16, 4.83551302940786e-16,
+	4.860340511447171e-16, 4.885526531349988e-16, 4.911086299591681e-16, 4.937035980236772e-16,
+	4.96339277440045e-16, 4.990175013088311e-16, 5.017402260714605e-16, 5.045095430815269e-16,
+	5.07327691573011e-16, 5.101970732338156e-16, 5.131202686303404e-16, 5.161000557739877e-16,
+	5.191394311754375e-16, 5.222416337996938e-16, 5.254101724174328e-16, 5.286488569501704e-16,
+	5.319618345335188e-16, 5.353536311813313e-16, 5.388292001330899e-16, 5.423939782198587e-16,
+	5.460539519071686e-16, 5.49815735088975e-16, 5.536866612464843e-16, 5.576748932923575e-16,
+	5.617895553552448e-16, 5.660408920079487e-16, 5.704404621288487e-16, 5.750013768917029e-16,
+	5.797385945721764e-16, 5.846692893452686e-16, 5.898133176475145e-16, 5.951938149638729e-16,
+	6.008379696269235e-16, 6.067780409330819e-16, 6.130527208722697e-16, 6.19708989457909e-16,
+	6.268046963298801e-16, 6.34412240712508e-16, 6.426239659545692e-16, 6.515603317342698e-16,
+	6.613827885095446e-16, 6.723150462503459e-16, 6.846803417562237e-16, 6.989718336385731e-16,
+	7.159994934828948e-16, 7.372424301797334e-16, 7.658936370804535e-16, 8.113849337656484e-16
+};
+static const double zig_f[NOISE_ZIG_LAYERS] = {
+	1.0, 0.9771017012827313, 0.9598790918124159, 0.945198953453078,
+	0.9320600759689902, 0.9199915050483602, 0.9087264400605629, 0.898095921906304,
+	0.8879846607633999, 0.8783096558161468, 0.8690086880437932, 0.8600336212030086,
+	0.8513462584651237, 0.8429156531184411, 0.8347162929929304, 0.8267268339520942,
+	0.8189291916094148, 0.8113078743182199, 0.8038494831763895, 0.7965423304282546,
+	0.7893761435711986, 0.7823418326598619, 0.7754313049861383, 0.7686373158033348,
+	0.7619533468415465, 0.7553735065117545, 0.7488924472237267, 0.7425052963446362,
+	0.7362075981312667, 0.7299952645658024, 0.7238645334728816, 0.7178119326349014,
+	0.7118342488823585, 0.7059285013367974, 0.7000919181404901, 0.6943219161300326,
+	0.6886160830085271, 0.6829721616487914, 0.6773880362225131, 0.6718617199007664,
+	0.6663913439123806, 0.6609751477802414, 0.6556114705832247, 0.6502987431142946,
+	0.6450354808242519, 0.639820277456439, 0.63465179929096, 0.6295287799281283,
+	0.6244500155502742, 0.6194143606090392, 0.6144207238920768, 0.6094680649288954,
+	0.6045553907005495, 0.5996817526221677, 0.5948462437709913, 0.590047996335792,
+	0.5852861792663003, 0.5805599961036835, 0.5758686829752105, 0.571211506738075,
+	0.5665877632589518, 0.5619967758172779, 0.5574378936214863, 0.5529104904285199,
+	0.5484139632579211, 0.5439477311926499, 0.5395112342595446, 0.5351039323830196,
+	0.5307253044061939, 0.5263748471741867, 0.5220520746747949, 0.5177565172322006,
+	0.513487720749743, 0.5092452459981361, 0.5050286679458288, 0.5008375751284821,
+	0.4966715690547963, 0.49253026364614866, 0.48841328470771206, 0.4843202694289116,
+	0.4802508659112497, 0.4762047327216838, 0.47218153846988326, 0.46818096140782217,
+	0.46420268905027884, 0.4602464178149235, 0.45631185268077357, 0.4523987068638825,
+	0.44850670150921407, 0.44463556539772775, 0.4407850346677699, 0.4369548525499293,
+	0.43314476911457406, 0.4293545410313415, 0.4255839313399006, 0.4218327092313533,
+	0.4181006498396846, 0.4143875340427068, 0.4106931482719832, 0.40701728433124795,
+	0.4033597392228689, 0.39972031498193167, 0.3960988185175471, 0.39249506146101076,
+	0.3889088600204646, 0.38534003484173396, 0.38178841087503135, 0.3782538172472381,
+	0.3747360871394914, 0.37123505766982134, 0.3677505697805962, 0.3642824681305496,
+	0.36083060099117575, 0.3573948201472905, 0.35397498080156925, 0.3505709414828812,
+	0.3471825639582515, 0.34380971314829134, 0.34045225704594545, 0.3371100666384128,
+	0.3337830158321085, 0.3304709813805371, 0.3271738428149586, 0.323891482377732,
+	0.32062378495823013, 0.3173706380312224, 0.31413193159763014, 0.3109075581275637,
+	0.30769741250555377, 0.3045013919778963, 0.3013193961020341, 0.29815132669790134,
+	0.29499708780116257, 0.291856585618281, 0.28872972848335393, 0.2856164268166581,
+	0.2825165930848494, 0.2794301417627653, 0.27635698929678126, 0.2732970540696758,
+	0.27025025636696, 0.26721651834463184, 0.26419576399831757, 0.2611879191337637,
+	0.258192911338648, 0.25521066995567715, 0.25224112605694377, 0.2492842124195167,
+	0.24633986350223877, 0.243408015423712, 0.2404886059414491, 0.23758157443217368,
+	0.2346868618732527, 0.23180441082524852, 0.22893416541557748, 0.22607607132326488,
+	0.2232300757647896, 0.2203961274810116, 0.21757417672517837, 0.2147641752520085,
+	0.21196607630785294, 0.20917983462193565, 0.20640540639867933, 0.2036427493111215,
+	0.20089182249543133, 0.1981525865465381, 0.1954250035148856, 0.1927090369043288,
+	0.19000465167119307, 0.18731181422451693, 0.18463049242750454, 0.1819606556002165,
+	0.1793022745235304, 0.17665532144440665, 0.17401977008249936, 0.17139559563815562,
+	0.16878277480185033, 0.16618128576511007, 0.16359110823298295, 0.16101222343811766,
+	0.15844461415652022, 0.15588826472506456, 0.15334316106083767, 0.15080929068241017,
+	0.14828664273312872, 0.14577520800653793, 0.14327497897404712, 0.1407859498149683,
+	0.13830811644906432, 0.13584147657175735, 0.13338602969216284, 0.13094177717412817,
+	0.12850872228047364, 0.12608687022065035, 0.1236762282020514, 0.12127680548523544,
+	0.1188886134433457, 0.11651166562603701, 0.11414597782825521, 0.11179156816424558,
+	0.10944845714721002, 0.10711666777507288, 0.10479622562286706, 0.10248715894230627,
+	0.10018949876917202, 0.09790327903921563, 0.09562853671335333, 0.09336531191302662,
+	0.09111364806670073, 0.08887359206859423, 0.08664519445086778, 0.08442850957065466,
+	0.08222359581349568, 0.08003051581494751, 0.07784933670237221, 0.07568013035919496,
+	0.07352297371424099, 0.07137794905914197, 0.06924514439725027, 0.06712465382802399,
+	0.06501657797147044, 0.06292102443797785, 0.060838108349751806, 0.058767952921137984,
+	0.05671069010639947, 0.054666461325077916, 0.05263541827697365, 0.05061772386112179,
+	0.048613553216035145, 0.046623094902089664, 0.044646552251446536, 0.04268414491661938,
+	0.04073611065607875, 0.03880270740465692, 0.03688421568869115, 0.03498094146183307,
+	0.0330932194586887, 0.03122141719202369, 0.02936593975823011, 0.027527235669693315,
+	0.025705804008632656, 0.023902203305873237, 0.022117062707379922, 0.020351096230109354,
+	0.01860512127578335, 0.01688008315259584, 0.015177088307982072, 0.013497450601780807,
+	0.011842757857943104, 0.0102149714397311, 0.008616582769422917, 0.00705087547139211,
+	0.005522403299264754, 0.0040379725933718715, 0.002609072746106363, 0.001260285930498598
+};
+
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          SEEDING
+*******************************************************************************/
+static uint64_t splitmix64(uint64_t* x)
+{
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static uint64_t xoshiro_next(uint64_t s[4])
+{
+	const uint64_t r = s[0] + s[3], t = s[1] << 17;
+	const uint64_t out = ((r << 23) | (r >> 41)) + s[0];
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return out;
+}
+
+static void xoshiro_jump(uint64_t s[4], const uint64_t poly[4])
+{
+	/* s advanced by the jump polynomial : 2^128 (jump) or 2^192 (long jump) outputs */
+	uint64_t j[4] = { 0, 0, 0, 0 };
+	int i, b, k;
+
+	for (i = 0; i < 4; i++)
+	{
+		for (b = 0; b < 64; b++)
+		{
+			if (poly[i] & ((uint64_t)1 << b))
+				for (k = 0; k < 4; k++) j[k] ^= s[k];
+			xoshiro_next(s);
+		}
+	}
+	for (k = 0; k < 4; k++) s[k] = j[k];
+}
+
+static const uint64_t xoshiro_jump128[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+static const uint64_t xoshiro_jump192[4] = { 0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL };
+
+void noise_seed(noise_handle noise, const uint64_t seed, const uint64_t stream)
+{
+	/*
+	* Arguments
+	- seed : Any value, expanded with splitmix64
+	- stream : Substream of the seed, one long jump (2^192) each
+
+	Description
+	-	Lane l of the stream starts l jumps (2^128) after the stream start.
+	*/
+
+	uint64_t s[4], x = seed, i;
+	int k, l;
+
+	for (k = 0; k < 4; k++) s[k] = splitmix64(&x);
+	for (i = 0; i < stream; i++) xoshiro_jump(s, xoshiro_jump192);
+
+	for (l = 0; l < NOISE_LANES; l++)
+	{
+		for (k = 0; k < 4; k++) noise->state[k * NOISE_LANES + l] = s[k];
+		xoshiro_jump(s, xoshiro_jump128);
+	}
+	noise->pos = NOISE_BLOCK;
+}
+
+void noise_jump(noise_handle noise)
+{
+	/*
+	Description
+	-	Jumps every lane 2^192 outputs, from the start of stream s to the start of stream s + 1
+		(as noise_seed(seed, s + 1) would), one jump per lane instead of s + 1.
+		Buffered words are dropped.
+	*/
+
+	uint64_t s[4];
+	int k, l;
+
+	for (l = 0; l < NOISE_LANES; l++)
+	{
+		for (k = 0; k < 4; k++) s[k] = noise->state[k * NOISE_LANES + l];
+		xoshiro_jump(s, xoshiro_jump192);
+		for (k = 0; k < 4; k++) noise->state[k * NOISE_LANES + l] = s[k];
+	}
+	noise->pos = NOISE_BLOCK;
+}
+
+noise_handle noise_create(const uint64_t seed, const uint64_t stream)
+{
+	/*
+	Description
+	-	Returns NULL on failure.
+	*/
+
+	noise_handle noise;
+
+	if ((noise = (noise_handle)malloc(sizeof(noise_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	noise_seed(noise, seed, stream);
+	return noise;
+}
+
+void noise_destroy(noise_handle noise)
+{
+	free(noise);
+}
+
+static long noise_next_stream(void)
+{
+	/* streams of the per-thread generators, in order of first use */
+#ifdef _MSC_VER
+	static volatile long counter = 0;
+	return _InterlockedIncrement(&counter) - 1;
+#else
+	static long counter = 0;
+	return __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static NOISE_THREAD_LOCAL noise_t thread_noise;
+static NOISE_THREAD_LOCAL int thread_noise_ready;
+
+noise_handle noise_thread(void)
+{
+	/*
+	Description
+	-	The generator of the calling thread : NOISE_DEFAULT_SEED, stream n for
+		the n-th thread that asks (the first one gets stream 0).
+	*/
+
+	if (!thread_noise_ready)
+	{
+		noise_seed(&thread_noise, NOISE_DEFAULT_SEED, (uint64_t)noise_next_stream());
+		thread_noise_ready = 1;
+	}
+	return &thread_noise;
+}
+
+void rands_seed(const uint64_t seed)
+{
+	/* reseeds the generator of the calling thread (stream 0 of seed), for reproducible rands */
+	noise_seed(&thread_noise, seed, 0);
+	thread_noise_ready = 1;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          VARIATES
+*******************************************************************************/
+static void noise_refill(noise_handle noise)
+{
+	simd_rng_lanes(noise->state, noise->words, NOISE_BLOCK / NOISE_LANES);
+	noise->pos = 0;
+}
+
+uint64_t noise_next(noise_handle noise)
+{
+	if (noise->pos == NOISE_BLOCK) noise_refill(noise);
+	return noise->words[noise->pos++];
+}
+
+static dtype zig_slow(noise_handle noise, uint64_t u)
+{
+	/* the candidate u missed the rectangle of its layer : wedge or tail test, then new candidates */
+
+	const int sign = (int)(u & 0x100);
+	double x, y;
+	int layer;
+
+	for (;;)
+	{
+		layer = (int)(u & 0xFF);
+		x = (double)(int64_t)(u >> 12) * zig_w[layer];
+		if ((u >> 12) < zig_k[layer]) break;
+
+		if (layer == 0) // tail beyond NOISE_ZIG_R (Marsaglia)
+		{
+			do
+			{
+				x = -log(((noise_next(noise) >> 11) + 0.5) * NOISE_UNIT) / NOISE_ZIG_R;
+				y = -log(((noise_next(noise) >> 11) + 0.5) * NOISE_UNIT);
+			} while (y + y < x * x);
+			x += NOISE_ZIG_R;
+			break;
+		}
+		if (zig_f[layer] + (noise_next(noise) >> 11) * NOISE_UNIT * (zig_f[layer - 1] - zig_f[layer]) < exp(-0.5 * x * x)) break;
+
+		u = noise_next(noise);
+	}
+	return (dtype)(sign ? -x : x);
+}
+
+dtype noise_gaussian1(noise_handle noise)
+{
+	/* one standard normal variate */
+
+	const uint64_t u = noise_next(noise);
+	const int layer = (int)(u & 0xFF);
+
+	if ((u >> 12) < zig_k[layer])
+	{
+		const double x = (double)(int64_t)(u >> 12) * zig_w[layer];
+		return (dtype)((u & 0x100) ? -x : x);
+	}
+	return zig_slow(noise, u);
+}
+
+void noise_uniform(noise_handle noise, dtype* out, const size_t n)
+{
+	/*
+	Description
+	-	Uniform on [0, 1) with 53 random bits.
+	*/
+
+	size_t i = 0, c, k;
+
+	while (i < n)
+	{
+		if (noise->pos == NOISE_BLOCK) noise_refill(noise);
+		c = (n - i < NOISE_BLOCK - noise->pos) ? n - i : NOISE_BLOCK - noise->pos;
+		for (k = 0; k < c; k++) out[i + k] = (dtype)((int64_t)(noise->words[noise->pos + k] >> 11) * NOISE_UNIT);
+		noise->pos += c;
+		i += c;
+	}
+}
+
+void noise_gaussian(noise_handle noise, dtype* out, const size_t n, const dtype average, const dtype stdev)
+{
+	/*
+	* Arguments
+	- out : n samples of N(average, stdev^2)
+
+	Description
+	-	One word per sample out of the current block; the rare misses
+		call zig_slow, which draws its extra words from the same stream.
+	*/
+
+	const uint64_t* words = noise->words;
+	uint64_t u, m;
+	double x;
+	int layer;
+	size_t i = 0, pos, end;
+
+	while (i < n)
+	{
+		if (noise->pos == NOISE_BLOCK) noise_refill(noise);
+		pos = noise->pos; // local copy : out may alias the handle as far as the compiler knows
+		end = (n - i < NOISE_BLOCK - pos) ? pos + n - i : NOISE_BLOCK;
+		while (pos < end)
+		{
+			u = words[pos++];
+			layer = (int)(u & 0xFF);
+			m = u >> 12;
+			// m < 2^52, so the signed conversion is one instruction; the sign multiply avoids a random branch
+			x = (double)(int64_t)m * zig_w[layer] * (1.0 - (double)(int64_t)((u >> 7) & 2));
+			if (m >= zig_k[layer])
+			{
+				noise->pos = pos;
+				x = zig_slow(noise, u); // may refill the block
+				pos = noise->pos;
+				end = (n - i - 1 < NOISE_BLOCK - pos) ? pos + n - i - 1 : NOISE_BLOCK;
+			}
+			out[i++] = average + stdev * x;
+		}
+		noise->pos = pos;
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef __NOISE_H__
+#define __NOISE_H__
+
+#include "common.h"
+#include "simd.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          NOISE GENERATOR
+*******************************************************************************/
+/*
+* A noise generator holds NOISE_LANES xoshiro256++ streams, 2^128 outputs apart,
+* which the simd kernel advances together into a block of random words.
+* Normal variates come from a 256 layer ziggurat : about 99% of the samples
+* take one word, one table lookup and one compare.
+* The output only depends on (seed, stream), not on the simd level or on how
+* the calls are split. Streams of one seed are 2^192 outputs apart, so one
+* stream per thread gives independent noise without any locking.
+*/
+#define NOISE_LANES SIMD_LANES
+#define NOISE_BLOCK 256 // random words per refill, multiple of NOISE_LANES
+#define NOISE_ZIG_LAYERS 256
+#define NOISE_ZIG_R 3.6541528853610088 // start of the tail
+#define NOISE_DEFAULT_SEED 0x2545F4914F6CDD1DULL // seed of the per-thread streams of rands
+
+typedef struct _noise
+{
+	uint64_t state[4 * NOISE_LANES];	// word k of lane l at state[k * NOISE_LANES + l]
+	uint64_t words[NOISE_BLOCK];		// current block of random words
+	size_t pos;							// next unused word
+} noise_t;
+
+typedef noise_t* noise_handle;
+
+noise_handle noise_create(const uint64_t seed, const uint64_t stream);
+void noise_destroy(noise_handle noise);
+void noise_seed(noise_handle noise, const uint64_t seed, const uint64_t stream);
+void noise_jump(noise_handle noise);
+uint64_t noise_next(noise_handle noise);
+dtype noise_gaussian1(noise_handle noise);
+void noise_uniform(noise_handle noise, dtype* out, const size_t n);
+void noise_gaussian(noise_handle noise, dtype* out, const size_t n, const dtype average, const dtype stdev);
+
+noise_handle noise_thread(void);
+void rands_seed(const uint64_t seed);
+
+/* wrapper function : noise */
+#define fa_noise_uniform noise_uniform
+#define fa_noise_gaussian noise_gaussian
+
+#endif
@@ -0,0 +1,272 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Per kernel profiling counters and their text / csv report.
+** The kernels only record when built with FA_PROFILE (prof.h).
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "prof.h"
+#include "thread.h"
+#include "util.h"
+
+#define PROF_CALIBRATE_NS 10000000ULL	// tsc rate measured over 10 ms
+
+typedef struct _prof_slot
+{
+	volatile uint64_t calls, elements, cycles, max_cycles;
+	uint64_t pad[4];	// one cache line per kernel, threads recording different kernels do not share lines
+} prof_slot_t;
+
+static prof_slot_t prof_table[PROF_N_KERNELS];
+
+static const char* prof_names[PROF_N_KERNELS] = {
+	"push_block", "spsc_push", "dot", "dot_mt", "fir", "lms", "bank", "autocor", "autocor_stream",
+	"fft", "resample", "biquad", "stats", "xcorr", "expr", "file_read", "file_write", "parse", "format"
+};
+
+static volatile long prof_armed = 0;	// FA_PROFILE_REPORT looked up
+static char* prof_exit_file = NULL;		// NULL : stderr
+static int prof_exit_format = PROF_TEXT;
+static int prof_exit_registered = 0;
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          KERNEL PROFILER
+*******************************************************************************/
+#ifndef __SIMD_X86__
+uint64_t prof_ticks(void)
+{
+	return time_now_ns();
+}
+#endif
+
+static inline void prof_add(volatile uint64_t* p, const uint64_t v)
+{
+#ifdef _MSC_VER
+	_InterlockedExchangeAdd64((volatile __int64*)p, (__int64)v);
+#else
+	__atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void prof_max(volatile uint64_t* p, const uint64_t v)
+{
+	uint64_t cur = *p;
+
+	while (v > cur)
+	{
+#ifdef _MSC_VER
+		const uint64_t seen = (uint64_t)_InterlockedCompareExchange64((volatile __int64*)p, (__int64)v, (__int64)cur);
+		if (seen == cur) return;
+		cur = seen;
+#else
+		if (__atomic_compare_exchange_n(p, &cur, v, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return;
+#endif
+	}
+}
+
+static inline uint64_t prof_load(const volatile uint64_t* p)
+{
+#ifdef _MSC_VER
+	return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)p, 0, 0); // atomic on 32 bit targets too
+#else
+	return __atomic_load_n(p, __ATOMIC_RELAXED);
+#endif
+}
+
+static void prof_exit_report(void)
+{
+	if (prof_exit_file == NULL) prof_report(stderr, prof_exit_format);
+	else prof_report_file(prof_exit_file, prof_exit_format);
+}
+
+static void prof_arm(void)
+{
+	/* first record : FA_PROFILE_REPORT asks for the report at exit */
+
+	const char* env = getenv("FA_PROFILE_REPORT");
+	size_t len;
+
+	if (env == NULL || env[0] == '\0') return;
+	len = strlen(env);
+	if (strcmp(env, "-") == 0) prof_report_at_exit(NULL, PROF_TEXT);
+	else prof_report_at_exit(env, len > 4 && strcmp(env + len - 4, ".csv") == 0 ? PROF_CSV : PROF_TEXT);
+}
+
+int prof_enabled(void)
+{
+#ifdef FA_PROFILE
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+const char* prof_name(const prof_kernel_t kernel)
+{
+	return (unsigned)kernel < PROF_N_KERNELS ? prof_names[kernel] : "unknown";
+}
+
+void prof_record(const prof_kernel_t kernel, const uint64_t elements, const uint64_t cycles)
+{
+	/*
+	* Arguments
+	- kernel : Counter to update
+	- elements : Work done by the call
+	- cycles : prof_ticks() spent in the call
+
+	Description
+	-	Called by PROF_END, safe from any thread : relaxed atomic adds on the
+		counters of the kernel, a compare and swap loop for the max.
+	*/
+
+	prof_slot_t* slot;
+
+	if ((unsigned)kernel >= PROF_N_KERNELS) return;
+	if (prof_armed == 0 && fa_try_lock(&prof_armed)) prof_arm(); // the flag stays set
+
+	slot = &prof_table[kernel];
+	prof_add(&slot->calls, 1);
+	prof_add(&slot->elements, elements);
+	prof_add(&slot->cycles, cycles);
+	prof_max(&slot->max_cycles, cycles);
+}
+
+void prof_get(const prof_kernel_t kernel, prof_counter_t* counter)
+{
+	memset(counter, 0, sizeof(prof_counter_t));
+	if ((unsigned)kernel >= PROF_N_KERNELS) return;
+
+	counter->calls = prof_load(&prof_table[kernel].calls);
+	counter->elements = prof_load(&prof_table[kernel].elements);
+	counter->cycles = prof_load(&prof_table[kernel].cycles);
+	counter->max_cycles = prof_load(&prof_table[kernel].max_cycles);
+}
+
+void prof_reset(void)
+{
+	/* not atomic with the kernels : call it while no instrumented kernel runs */
+
+	int k;
+
+	for (k = 0; k < PROF_N_KERNELS; k++)
+	{
+		prof_table[k].calls = 0;
+		prof_table[k].elements = 0;
+		prof_table[k].cycles = 0;
+		prof_table[k].max_cycles = 0;
+	}
+}
+
+double prof_tick_ns(void)
+{
+	/* measured once, the invariant tsc of current x86 cpus ticks at a fixed rate */
+
+	static double ns_per_tick = 0.0;
+#ifdef __SIMD_X86__
+	uint64_t t0, t1, c0, c1;
+
+	if (ns_per_tick > 0.0) return ns_per_tick;
+	t0 = time_now_ns();
+	c0 = prof_ticks();
+	do { t1 = time_now_ns(); } while (t1 - t0 < PROF_CALIBRATE_NS);
+	c1 = prof_ticks();
+	ns_per_tick = c1 > c0 ? (double)(t1 - t0) / (double)(c1 - c0) : 1.0;
+#else
+	ns_per_tick = 1.0; // prof_ticks is time_now_ns
+#endif
+	return ns_per_tick;
+}
+
+void prof_report(FILE* out, const int format)
+{
+	/*
+	* Arguments
+	- out : Report stream
+	- format : PROF_TEXT or PROF_CSV
+
+	Description
+	-	One line per kernel called at least once : calls, elements, total / mean / max
+		time and ns per element. Ticks are converted to ns with a rate measured the
+		first time (10 ms). Without FA_PROFILE the text report says the profiler is
+		compiled out and the csv report has the header only.
+	*/
+
+	prof_counter_t c;
+	double scale, total, mean, max, per;
+	int k;
+
+	if (format == PROF_CSV) fprintf(out, "kernel,calls,elements,total_ns,mean_ns,max_ns,ns_per_element\n");
+	if (!prof_enabled())
+	{
+		if (format != PROF_CSV) fprintf(out, "kernel profile : compiled out, build with FA_PROFILE\n");
+		return;
+	}
+
+	scale = prof_tick_ns();
+	if (format != PROF_CSV)
+	{
+		fprintf(out, "kernel profile : %.3f ticks/ns\n", 1.0 / scale);
+		fprintf(out, "%-15s %12s %14s %12s %12s %12s %10s\n",
+			"kernel", "calls", "elements", "total_ms", "mean_ns", "max_ns", "ns/elem");
+	}
+
+	for (k = 0; k < PROF_N_KERNELS; k++)
+	{
+		prof_get((prof_kernel_t)k, &c);
+		if (c.calls == 0) continue;
+
+		total = (double)c.cycles * scale;
+		mean = total / (double)c.calls;
+		max = (double)c.max_cycles * scale;
+		per = c.elements ? total / (double)c.elements : 0.0;
+
+		if (format == PROF_CSV)
+			fprintf(out, "%s,%llu,%llu,%.6g,%.6g,%.6g,%.6g\n", prof_names[k],
+				(unsigned long long)c.calls, (unsigned long long)c.elements, total, mean, max, per);
+		else
+			fprintf(out, "%-15s %12llu %14llu %12.3f %12.1f %12.1f %10.4f\n", prof_names[k],
+				(unsigned long long)c.calls, (unsigned long long)c.elements, total * 1e-6, mean, max, per);
+	}
+	fflush(out);
+}
+
+int prof_report_file(const char* file_name, const int format)
+{
+	/* returns 0, -1 when the file cannot be opened */
+
+	FILE* fp;
+
+	if ((fp = fopen(file_name, "w")) == NULL)
+	{
+		fprintf(stderr, "File Open Error!\n");
+		return -1;
+	}
+	prof_report(fp, format);
+	fclose(fp);
+	return 0;
+}
+
+void prof_report_at_exit(const char* file_name, const int format)
+{
+	/*
+	* Arguments
+	- file_name : Report file, NULL : stderr
+	- format : PROF_TEXT or PROF_CSV
+
+	Description
+	-	Writes the report when the program exits. The handler is registered once,
+		a later call only changes the destination.
+	*/
+
+	free(prof_exit_file);
+	prof_exit_file = NULL;
+	if (file_name != NULL && (prof_exit_file = (char*)malloc(strlen(file_name) + 1)) != NULL)
+		strcpy(prof_exit_file, file_name);
+	prof_exit_format = format;
+
+	if (!prof_exit_registered && atexit(prof_exit_report) == 0) prof_exit_registered = 1;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#ifndef __PROF_H__
+#define __PROF_H__
+
+#include "common.h"
+#include "simd.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          KERNEL PROFILER
+*******************************************************************************/
+/*
+* Per kernel counters : calls, elements, total and max cycles of every
+* instrumented entry point, kept in one global table with atomic updates.
+* Compiled out unless FA_PROFILE is defined (common.h or the compiler flags) :
+* PROF_BEGIN / PROF_END expand to nothing, the table stays empty and the
+* report says so.
+* Cycles are TSC ticks on x86 (ns elsewhere), converted to ns in the report
+* with a rate measured against time_now_ns. Times are inclusive : fir_process
+* also counts the push_block_fa it calls, read_data_chunk the parse_text.
+* The per sample entry points (push macros, single sample *_push and
+* *_process_sample) are not instrumented, the two counter reads would cost
+* more than the kernel. least_mean_square_fa is, its window long dot and
+* update outweigh them. Calls that return early without work are not counted.
+* With FA_PROFILE, setting the FA_PROFILE_REPORT environment variable prints
+* the report at exit : "-" for stderr, a file name otherwise (CSV when it ends
+* with ".csv").
+*/
+typedef enum _prof_kernel_t
+{
+	PROF_PUSH_BLOCK = 0,	// push_block_pidx, push_block_fa : samples
+	PROF_SPSC_PUSH,			// spsc_push : samples pushed
+	PROF_DOT,				// dot_product, *_pidx, *_dpidx, dot_product4 : products
+	PROF_DOT_MT,			// dot_product_mt : products
+	PROF_FIR,				// fir_filtering* : taps, fir_process : taps * samples
+	PROF_LMS,				// lms_process, least_mean_square, fast_least_mean_square, least_mean_square_fa : samples
+	PROF_BANK,				// bank_process : frames * channels
+	PROF_AUTOCOR,			// autocor_direct, autocor_fft (autocor, fast_autocor) : len + lag
+	PROF_AUTOCOR_STREAM,	// autocor_stream_push_block : samples
+	PROF_FFT,				// fft_forward / inverse, rfft_forward / inverse : points
+	PROF_RESAMPLE,			// resampler_process : input samples
+	PROF_BIQUAD,			// biquad_process : frames * channels
+	PROF_STATS,				// stats_push_block : samples
+	PROF_XCORR,				// xcorr_process, sdft_push_block : samples
+	PROF_EXPR,				// expr_run : elements
+	PROF_FILE_READ,			// read_data_chunk, read_data_file*, read_signal_file : values
+	PROF_FILE_WRITE,		// write_data_file*, write_signal_file : values
+	PROF_PARSE,				// parse_text, per segment in parse_text_parallel : bytes
+	PROF_FORMAT,			// format_text : values
+	PROF_N_KERNELS
+} prof_kernel_t;
+
+#define PROF_TEXT 0
+#define PROF_CSV 1
+
+typedef struct _prof_counter
+{
+	uint64_t calls;
+	uint64_t elements;		// work unit of the kernel, see prof_kernel_t
+	uint64_t cycles;		// total
+	uint64_t max_cycles;	// longest single call
+} prof_counter_t;
+
+#if defined(__SIMD_X86__) && defined(_MSC_VER)
+#include <intrin.h>
+static inline uint64_t prof_ticks(void) { return __rdtsc(); }
+#elif defined(__SIMD_X86__)
+#include <x86intrin.h>
+static inline uint64_t prof_ticks(void) { return __rdtsc(); }
+#else
+uint64_t prof_ticks(void); // time_now_ns
+#endif
+
+int prof_enabled(void);		// 1 when built with FA_PROFILE
+double prof_tick_ns(void);	// ns per prof_ticks() tick, calibrated at the first call
+const char* prof_name(const prof_kernel_t kernel);
+void prof_record(const prof_kernel_t kernel, const uint64_t elements, const uint64_t cycles);
+void prof_get(const prof_kernel_t kernel, prof_counter_t* counter);
+void prof_reset(void);
+void prof_report(FILE* out, const int format);
+int prof_report_file(const char* file_name, const int format);
+void prof_report_at_exit(const char* file_name, const int format);	// NULL : stderr
+
+#ifdef FA_PROFILE
+#define PROF_BEGIN(id) const uint64_t prof_begin_##id = prof_ticks()
+#define PROF_END(id, elements) prof_record(id, (uint64_t)(elements), prof_ticks() - prof_begin_##id)
+#else
+#define PROF_BEGIN(id)
+#define PROF_END(id, elements)
+#endif
+
+#endif
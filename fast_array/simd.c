@@ -0,0 +1,1525 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** SIMD kernels of the fast array API.
+** The instruction set is detected once with cpuid and the widest
+** supported kernel is used behind a function pointer.
+** All kernels use several independent accumulators so that the
+** additions do not form a single serial dependency chain.
+*/
+
+#include "simd.h"
+
+#ifdef __SIMD_X86__
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+static int cpu_level = -1;	// detected level, -1 : not detected yet
+static int used_level = -1;	// level of the installed kernels
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          CPU DETECTION
+*******************************************************************************/
+#ifdef __SIMD_X86__
+static void cpuid(int info[4], int leaf, int subleaf)
+{
+#ifdef _MSC_VER
+	__cpuidex(info, leaf, subleaf);
+#else
+	unsigned int a, b, c, d;
+	__cpuid_count(leaf, subleaf, a, b, c, d);
+	info[0] = (int)a, info[1] = (int)b, info[2] = (int)c, info[3] = (int)d;
+#endif
+}
+
+static unsigned long long xgetbv0(void)
+{
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+#endif
+
+static int detect_level(void)
+{
+	int level = SIMD_SCALAR;
+#ifdef __SIMD_X86__
+	int info[4];
+	unsigned long long xcr0;
+
+	cpuid(info, 0, 0);
+	if (info[0] < 1) return level;
+
+	cpuid(info, 1, 0);
+	if (info[3] & (1 << 26)) level = SIMD_SSE2;
+
+	// osxsave, avx, fma
+	if ((info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (info[2] & (1 << 12)))
+	{
+		xcr0 = xgetbv0();
+		if ((xcr0 & 0x6) == 0x6) // xmm, ymm state enabled by the os
+		{
+			cpuid(info, 7, 0);
+			if (info[1] & (1 << 5)) level = SIMD_AVX2;
+			if (level == SIMD_AVX2 && (info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6) // opmask, zmm state
+				level = SIMD_AVX512;
+		}
+	}
+#endif
+	return level;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          DOT PRODUCT KERNELS
+*******************************************************************************/
+dtype dot_scalar(const dtype* a, const dtype* b, const size_t size)
+{
+	dtype s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+
+	for (; i + 4 <= size; i += 4)
+	{
+		s0 += a[i] * b[i];
+		s1 += a[i + 1] * b[i + 1];
+		s2 += a[i + 2] * b[i + 2];
+		s3 += a[i + 3] * b[i + 3];
+	}
+	for (; i < size; i++) s0 += a[i] * b[i];
+
+	return (s0 + s1) + (s2 + s3);
+}
+
+void dot_stride4_scalar(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4])
+{
+	const dtype* x0 = x, * x1 = x + stride, * x2 = x + 2 * stride, * x3 = x + 3 * stride;
+	dtype s0 = 0, s1 = 0, s2 = 0, s3 = 0, hk;
+	size_t k;
+
+	for (k = 0; k < size; k++)
+	{
+		hk = h[k];
+		s0 += hk * x0[k];
+		s1 += hk * x1[k];
+		s2 += hk * x2[k];
+		s3 += hk * x3[k];
+	}
+	out[0] = s0, out[1] = s1, out[2] = s2, out[3] = s3;
+}
+
+void dot_shift4_scalar(const dtype* h, const dtype* x, const size_t size, dtype out[4])
+{
+	dot_stride4_scalar(h, x, size, 1, out);
+}
+
+dtype lms_update_dot_scalar(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g)
+{
+	dtype s0 = 0, s1 = 0, h0, h1;
+	size_t k = 0;
+
+	for (; k + 2 <= size; k += 2)
+	{
+		h0 = beta * h[k] + g * prev[k];
+		h1 = beta * h[k + 1] + g * prev[k + 1];
+		h[k] = h0, h[k + 1] = h1;
+		s0 += h0 * cur[k];
+		s1 += h1 * cur[k + 1];
+	}
+	if (k < size)
+	{
+		h[k] = beta * h[k] + g * prev[k];
+		s0 += h[k] * cur[k];
+	}
+	return s0 + s1;
+}
+
+void lanes_fir_scalar(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES])
+{
+	size_t k, l;
+
+	for (l = 0; l < SIMD_LANES; l++) acc[l] = 0;
+	for (k = 0; k < size; k++, h += stride, x += stride)
+		for (l = 0; l < SIMD_LANES; l++) acc[l] += h[l] * x[l];
+}
+
+void lanes_lms_scalar(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES])
+{
+	const dtype* prev = cur + stride;
+	size_t k, l;
+
+	for (l = 0; l < SIMD_LANES; l++) acc[l] = 0;
+	for (k = 0; k < size; k++, h += stride, cur += stride, prev += stride)
+	{
+		for (l = 0; l < SIMD_LANES; l++)
+		{
+			h[l] = beta[l] * h[l] + gain[l] * prev[l];
+			acc[l] += h[l] * cur[l];
+		}
+	}
+}
+
+#ifdef __SIMD_X86__
+SIMD_TARGET("sse2")
+dtype dot_sse2(const dtype* a, const dtype* b, const size_t size)
+{
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+	dtype sum;
+	size_t i = 0;
+
+	for (; i + 8 <= size; i += 8)
+	{
+		s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+		s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+		s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+		s3 = _mm_add_pd(s3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+	}
+	for (; i + 2 <= size; i += 2)
+		s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+
+	s0 = _mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3));
+	s0 = _mm_add_sd(s0, _mm_unpackhi_pd(s0, s0));
+	sum = _mm_cvtsd_f64(s0);
+
+	for (; i < size; i++) sum += a[i] * b[i];
+	return sum;
+}
+
+SIMD_TARGET("sse2")
+void dot_stride4_sse2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4])
+{
+	const dtype* x0 = x, * x1 = x + stride, * x2 = x + 2 * stride, * x3 = x + 3 * stride;
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd(), hv;
+	size_t k = 0;
+
+	for (; k + 2 <= size; k += 2)
+	{
+		hv = _mm_loadu_pd(h + k);
+		s0 = _mm_add_pd(s0, _mm_mul_pd(hv, _mm_loadu_pd(x0 + k)));
+		s1 = _mm_add_pd(s1, _mm_mul_pd(hv, _mm_loadu_pd(x1 + k)));
+		s2 = _mm_add_pd(s2, _mm_mul_pd(hv, _mm_loadu_pd(x2 + k)));
+		s3 = _mm_add_pd(s3, _mm_mul_pd(hv, _mm_loadu_pd(x3 + k)));
+	}
+	out[0] = _mm_cvtsd_f64(_mm_add_sd(s0, _mm_unpackhi_pd(s0, s0)));
+	out[1] = _mm_cvtsd_f64(_mm_add_sd(s1, _mm_unpackhi_pd(s1, s1)));
+	out[2] = _mm_cvtsd_f64(_mm_add_sd(s2, _mm_unpackhi_pd(s2, s2)));
+	out[3] = _mm_cvtsd_f64(_mm_add_sd(s3, _mm_unpackhi_pd(s3, s3)));
+
+	for (; k < size; k++)
+	{
+		out[0] += h[k] * x0[k];
+		out[1] += h[k] * x1[k];
+		out[2] += h[k] * x2[k];
+		out[3] += h[k] * x3[k];
+	}
+}
+
+SIMD_TARGET("sse2")
+void dot_shift4_sse2(const dtype* h, const dtype* x, const size_t size, dtype out[4])
+{
+	dot_stride4_sse2(h, x, size, 1, out);
+}
+
+SIMD_TARGET("sse2")
+dtype lms_update_dot_sse2(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g)
+{
+	const __m128d bv = _mm_set1_pd(beta), gv = _mm_set1_pd(g);
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), h0, h1;
+	dtype sum;
+	size_t k = 0;
+
+	for (; k + 4 <= size; k += 4)
+	{
+		h0 = _mm_add_pd(_mm_mul_pd(bv, _mm_loadu_pd(h + k)), _mm_mul_pd(gv, _mm_loadu_pd(prev + k)));
+		h1 = _mm_add_pd(_mm_mul_pd(bv, _mm_loadu_pd(h + k + 2)), _mm_mul_pd(gv, _mm_loadu_pd(prev + k + 2)));
+		_mm_storeu_pd(h + k, h0);
+		_mm_storeu_pd(h + k + 2, h1);
+		s0 = _mm_add_pd(s0, _mm_mul_pd(h0, _mm_loadu_pd(cur + k)));
+		s1 = _mm_add_pd(s1, _mm_mul_pd(h1, _mm_loadu_pd(cur + k + 2)));
+	}
+	s0 = _mm_add_pd(s0, s1);
+	s0 = _mm_add_sd(s0, _mm_unpackhi_pd(s0, s0));
+	sum = _mm_cvtsd_f64(s0);
+
+	for (; k < size; k++)
+	{
+		h[k] = beta * h[k] + g * prev[k];
+		sum += h[k] * cur[k];
+	}
+	return sum;
+}
+
+SIMD_TARGET("sse2")
+void lanes_fir_sse2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES])
+{
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+	size_t k;
+
+	for (k = 0; k < size; k++, h += stride, x += stride)
+	{
+		s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(h), _mm_loadu_pd(x)));
+		s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(h + 2), _mm_loadu_pd(x + 2)));
+		s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(h + 4), _mm_loadu_pd(x + 4)));
+		s3 = _mm_add_pd(s3, _mm_mul_pd(_mm_loadu_pd(h + 6), _mm_loadu_pd(x + 6)));
+	}
+	_mm_storeu_pd(acc, s0), _mm_storeu_pd(acc + 2, s1), _mm_storeu_pd(acc + 4, s2), _mm_storeu_pd(acc + 6, s3);
+}
+
+SIMD_TARGET("sse2")
+void lanes_lms_sse2(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES])
+{
+	__m128d b[4], g[4], s[4], hv;
+	const dtype* prev = cur + stride;
+	size_t k;
+	int l;
+
+	for (l = 0; l < 4; l++)
+	{
+		b[l] = _mm_loadu_pd(beta + 2 * l), g[l] = _mm_loadu_pd(gain + 2 * l), s[l] = _mm_setzero_pd();
+	}
+	for (k = 0; k < size; k++, h += stride, cur += stride, prev += stride)
+	{
+		for (l = 0; l < 4; l++)
+		{
+			hv = _mm_add_pd(_mm_mul_pd(b[l], _mm_loadu_pd(h + 2 * l)), _mm_mul_pd(g[l], _mm_loadu_pd(prev + 2 * l)));
+			_mm_storeu_pd(h + 2 * l, hv);
+			s[l] = _mm_add_pd(s[l], _mm_mul_pd(hv, _mm_loadu_pd(cur + 2 * l)));
+		}
+	}
+	for (l = 0; l < 4; l++) _mm_storeu_pd(acc + 2 * l, s[l]);
+}
+
+SIMD_TARGET("avx2,fma")
+static dtype hsum_avx2(__m256d v)
+{
+	__m128d r = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+	r = _mm_add_sd(r, _mm_unpackhi_pd(r, r));
+	return _mm_cvtsd_f64(r);
+}
+
+SIMD_TARGET("avx2,fma")
+dtype dot_avx2(const dtype* a, const dtype* b, const size_t size)
+{
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+	dtype sum;
+	size_t i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+		s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+		s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), s2);
+		s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
+	}
+	for (; i + 4 <= size; i += 4)
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+
+	sum = hsum_avx2(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+
+	for (; i < size; i++) sum += a[i] * b[i];
+	return sum;
+}
+
+SIMD_TARGET("avx2,fma")
+void dot_stride4_avx2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4])
+{
+	/*
+	* one load of h serves the four outputs, for a small stride the
+	* shifted loads of x mostly hit the same cache lines
+	*/
+
+	const dtype* x0 = x, * x1 = x + stride, * x2 = x + 2 * stride, * x3 = x + 3 * stride;
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd(), hv;
+	size_t k = 0;
+
+	for (; k + 4 <= size; k += 4)
+	{
+		hv = _mm256_loadu_pd(h + k);
+		s0 = _mm256_fmadd_pd(hv, _mm256_loadu_pd(x0 + k), s0);
+		s1 = _mm256_fmadd_pd(hv, _mm256_loadu_pd(x1 + k), s1);
+		s2 = _mm256_fmadd_pd(hv, _mm256_loadu_pd(x2 + k), s2);
+		s3 = _mm256_fmadd_pd(hv, _mm256_loadu_pd(x3 + k), s3);
+	}
+	out[0] = hsum_avx2(s0), out[1] = hsum_avx2(s1), out[2] = hsum_avx2(s2), out[3] = hsum_avx2(s3);
+
+	for (; k < size; k++)
+	{
+		out[0] += h[k] * x0[k];
+		out[1] += h[k] * x1[k];
+		out[2] += h[k] * x2[k];
+		out[3] += h[k] * x3[k];
+	}
+}
+
+SIMD_TARGET("avx2,fma")
+void dot_shift4_avx2(const dtype* h, const dtype* x, const size_t size, dtype out[4])
+{
+	dot_stride4_avx2(h, x, size, 1, out);
+}
+
+SIMD_TARGET("avx2,fma")
+dtype lms_update_dot_avx2(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g)
+{
+	/* one pass over the taps : coefficient update and output dot product */
+
+	const __m256d bv = _mm256_set1_pd(beta), gv = _mm256_set1_pd(g);
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), h0, h1;
+	dtype sum;
+	size_t k = 0;
+
+	for (; k + 8 <= size; k += 8)
+	{
+		h0 = _mm256_fmadd_pd(gv, _mm256_loadu_pd(prev + k), _mm256_mul_pd(bv, _mm256_loadu_pd(h + k)));
+		h1 = _mm256_fmadd_pd(gv, _mm256_loadu_pd(prev + k + 4), _mm256_mul_pd(bv, _mm256_loadu_pd(h + k + 4)));
+		_mm256_storeu_pd(h + k, h0);
+		_mm256_storeu_pd(h + k + 4, h1);
+		s0 = _mm256_fmadd_pd(h0, _mm256_loadu_pd(cur + k), s0);
+		s1 = _mm256_fmadd_pd(h1, _mm256_loadu_pd(cur + k + 4), s1);
+	}
+	sum = hsum_avx2(_mm256_add_pd(s0, s1));
+
+	for (; k < size; k++)
+	{
+		h[k] = beta * h[k] + g * prev[k];
+		sum += h[k] * cur[k];
+	}
+	return sum;
+}
+
+SIMD_TARGET("avx2,fma")
+void lanes_fir_avx2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES])
+{
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+	size_t k = 0;
+
+	for (; k + 2 <= size; k += 2, h += 2 * stride, x += 2 * stride) // two taps per step to break the fma chain
+	{
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(h), _mm256_loadu_pd(x), s0);
+		s1 = _mm256_fmadd_pd(_mm256_loadu_pd(h + 4), _mm256_loadu_pd(x + 4), s1);
+		s2 = _mm256_fmadd_pd(_mm256_loadu_pd(h + stride), _mm256_loadu_pd(x + stride), s2);
+		s3 = _mm256_fmadd_pd(_mm256_loadu_pd(h + stride + 4), _mm256_loadu_pd(x + stride + 4), s3);
+	}
+	if (k < size)
+	{
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(h), _mm256_loadu_pd(x), s0);
+		s1 = _mm256_fmadd_pd(_mm256_loadu_pd(h + 4), _mm256_loadu_pd(x + 4), s1);
+	}
+	_mm256_storeu_pd(acc, _mm256_add_pd(s0, s2));
+	_mm256_storeu_pd(acc + 4, _mm256_add_pd(s1, s3));
+}
+
+SIMD_TARGET("avx2,fma")
+void lanes_lms_avx2(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES])
+{
+	const __m256d b0 = _mm256_loadu_pd(beta), b1 = _mm256_loadu_pd(beta + 4);
+	const __m256d g0 = _mm256_loadu_pd(gain), g1 = _mm256_loadu_pd(gain + 4);
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), h0, h1;
+	const dtype* prev = cur + stride;
+	size_t k;
+
+	for (k = 0; k < size; k++, h += stride, cur += stride, prev += stride)
+	{
+		h0 = _mm256_fmadd_pd(g0, _mm256_loadu_pd(prev), _mm256_mul_pd(b0, _mm256_loadu_pd(h)));
+		h1 = _mm256_fmadd_pd(g1, _mm256_loadu_pd(prev + 4), _mm256_mul_pd(b1, _mm256_loadu_pd(h + 4)));
+		_mm256_storeu_pd(h, h0);
+		_mm256_storeu_pd(h + 4, h1);
+		s0 = _mm256_fmadd_pd(h0, _mm256_loadu_pd(cur), s0);
+		s1 = _mm256_fmadd_pd(h1, _mm256_loadu_pd(cur + 4), s1);
+	}
+	_mm256_storeu_pd(acc, s0);
+	_mm256_storeu_pd(acc + 4, s1);
+}
+
+SIMD_TARGET("avx512f")
+dtype dot_avx512(const dtype* a, const dtype* b, const size_t size)
+{
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+	__mmask8 m;
+	size_t i = 0;
+
+	for (; i + 32 <= size; i += 32)
+	{
+		s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+		s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), s1);
+		s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), s2);
+		s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), s3);
+	}
+	for (; i + 8 <= size; i += 8)
+		s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+	if (i < size) // masked tail
+	{
+		m = (__mmask8)((1u << (size - i)) - 1);
+		s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i), s1);
+	}
+
+	s0 = _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3));
+	return _mm512_reduce_add_pd(s0);
+}
+
+SIMD_TARGET("avx512f")
+void dot_stride4_avx512(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4])
+{
+	const dtype* x0 = x, * x1 = x + stride, * x2 = x + 2 * stride, * x3 = x + 3 * stride;
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd(), hv;
+	__mmask8 m;
+	size_t k = 0;
+
+	for (; k + 8 <= size; k += 8)
+	{
+		hv = _mm512_loadu_pd(h + k);
+		s0 = _mm512_fmadd_pd(hv, _mm512_loadu_pd(x0 + k), s0);
+		s1 = _mm512_fmadd_pd(hv, _mm512_loadu_pd(x1 + k), s1);
+		s2 = _mm512_fmadd_pd(hv, _mm512_loadu_pd(x2 + k), s2);
+		s3 = _mm512_fmadd_pd(hv, _mm512_loadu_pd(x3 + k), s3);
+	}
+	if (k < size) // masked tail, h is zero outside the mask
+	{
+		m = (__mmask8)((1u << (size - k)) - 1);
+		hv = _mm512_maskz_loadu_pd(m, h + k);
+		s0 = _mm512_fmadd_pd(hv, _mm512_maskz_loadu_pd(m, x0 + k), s0);
+		s1 = _mm512_fmadd_pd(hv, _mm512_maskz_loadu_pd(m, x1 + k), s1);
+		s2 = _mm512_fmadd_pd(hv, _mm512_maskz_loadu_pd(m, x2 + k), s2);
+		s3 = _mm512_fmadd_pd(hv, _mm512_maskz_loadu_pd(m, x3 + k), s3);
+	}
+	out[0] = _mm512_reduce_add_pd(s0), out[1] = _mm512_reduce_add_pd(s1);
+	out[2] = _mm512_reduce_add_pd(s2), out[3] = _mm512_reduce_add_pd(s3);
+}
+
+SIMD_TARGET("avx512f")
+void dot_shift4_avx512(const dtype* h, const dtype* x, const size_t size, dtype out[4])
+{
+	dot_stride4_avx512(h, x, size, 1, out);
+}
+
+SIMD_TARGET("avx512f")
+dtype lms_update_dot_avx512(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g)
+{
+	const __m512d bv = _mm512_set1_pd(beta), gv = _mm512_set1_pd(g);
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), h0, h1;
+	__mmask8 m;
+	size_t k = 0;
+
+	for (; k + 16 <= size; k += 16)
+	{
+		h0 = _mm512_fmadd_pd(gv, _mm512_loadu_pd(prev + k), _mm512_mul_pd(bv, _mm512_loadu_pd(h + k)));
+		h1 = _mm512_fmadd_pd(gv, _mm512_loadu_pd(prev + k + 8), _mm512_mul_pd(bv, _mm512_loadu_pd(h + k + 8)));
+		_mm512_storeu_pd(h + k, h0);
+		_mm512_storeu_pd(h + k + 8, h1);
+		s0 = _mm512_fmadd_pd(h0, _mm512_loadu_pd(cur + k), s0);
+		s1 = _mm512_fmadd_pd(h1, _mm512_loadu_pd(cur + k + 8), s1);
+	}
+	for (; k < size; k += 8) // masked tail
+	{
+		m = (size - k >= 8) ? (__mmask8)0xff : (__mmask8)((1u << (size - k)) - 1);
+		h0 = _mm512_fmadd_pd(gv, _mm512_maskz_loadu_pd(m, prev + k), _mm512_mul_pd(bv, _mm512_maskz_loadu_pd(m, h + k)));
+		_mm512_mask_storeu_pd(h + k, m, h0);
+		s0 = _mm512_fmadd_pd(h0, _mm512_maskz_loadu_pd(m, cur + k), s0);
+	}
+	return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+}
+
+SIMD_TARGET("avx512f")
+void lanes_fir_avx512(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES])
+{
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+	size_t k = 0;
+
+	for (; k + 4 <= size; k += 4, h += 4 * stride, x += 4 * stride)
+	{
+		s0 = _mm512_fmadd_pd(_mm512_loadu_pd(h), _mm512_loadu_pd(x), s0);
+		s1 = _mm512_fmadd_pd(_mm512_loadu_pd(h + stride), _mm512_loadu_pd(x + stride), s1);
+		s2 = _mm512_fmadd_pd(_mm512_loadu_pd(h + 2 * stride), _mm512_loadu_pd(x + 2 * stride), s2);
+		s3 = _mm512_fmadd_pd(_mm512_loadu_pd(h + 3 * stride), _mm512_loadu_pd(x + 3 * stride), s3);
+	}
+	for (; k < size; k++, h += stride, x += stride)
+		s0 = _mm512_fmadd_pd(_mm512_loadu_pd(h), _mm512_loadu_pd(x), s0);
+	_mm512_storeu_pd(acc, _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+SIMD_TARGET("avx512f")
+void lanes_lms_avx512(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES])
+{
+	const __m512d bv = _mm512_loadu_pd(beta), gv = _mm512_loadu_pd(gain);
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), h0, h1;
+	const dtype* prev = cur + stride;
+	size_t k = 0;
+
+	for (; k + 2 <= size; k += 2, h += 2 * stride, cur += 2 * stride, prev += 2 * stride)
+	{
+		h0 = _mm512_fmadd_pd(gv, _mm512_loadu_pd(prev), _mm512_mul_pd(bv, _mm512_loadu_pd(h)));
+		h1 = _mm512_fmadd_pd(gv, _mm512_loadu_pd(prev + stride), _mm512_mul_pd(bv, _mm512_loadu_pd(h + stride)));
+		_mm512_storeu_pd(h, h0);
+		_mm512_storeu_pd(h + stride, h1);
+		s0 = _mm512_fmadd_pd(h0, _mm512_loadu_pd(cur), s0);
+		s1 = _mm512_fmadd_pd(h1, _mm512_loadu_pd(cur + stride), s1);
+	}
+	if (k < size)
+	{
+		h0 = _mm512_fmadd_pd(gv, _mm512_loadu_pd(prev), _mm512_mul_pd(bv, _mm512_loadu_pd(h)));
+		_mm512_storeu_pd(h, h0);
+		s0 = _mm512_fmadd_pd(h0, _mm512_loadu_pd(cur), s0);
+	}
+	_mm512_storeu_pd(acc, _mm512_add_pd(s0, s1));
+}
+#endif
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          TYPED DOT KERNELS
+*******************************************************************************/
+float dot_f32_scalar(const f32_t* a, const f32_t* b, const size_t size)
+{
+	float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+
+	for (; i + 4 <= size; i += 4)
+	{
+		s0 += a[i] * b[i];
+		s1 += a[i + 1] * b[i + 1];
+		s2 += a[i + 2] * b[i + 2];
+		s3 += a[i + 3] * b[i + 3];
+	}
+	for (; i < size; i++) s0 += a[i] * b[i];
+
+	return (s0 + s1) + (s2 + s3);
+}
+
+int64_t dot_q15_scalar(const q15_t* a, const q15_t* b, const size_t size)
+{
+	int64_t s0 = 0, s1 = 0;
+	size_t i = 0;
+
+	for (; i + 2 <= size; i += 2)
+	{
+		s0 += (int32_t)a[i] * b[i];
+		s1 += (int32_t)a[i + 1] * b[i + 1];
+	}
+	for (; i < size; i++) s0 += (int32_t)a[i] * b[i];
+
+	return s0 + s1;
+}
+
+#ifdef __SIMD_X86__
+SIMD_TARGET("sse2")
+float dot_f32_sse2(const f32_t* a, const f32_t* b, const size_t size)
+{
+	__m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps(), s2 = _mm_setzero_ps(), s3 = _mm_setzero_ps();
+	float sum;
+	size_t i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+		s2 = _mm_add_ps(s2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+		s3 = _mm_add_ps(s3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+	}
+	for (; i + 4 <= size; i += 4)
+		s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+	s0 = _mm_add_ps(_mm_add_ps(s0, s1), _mm_add_ps(s2, s3));
+	s0 = _mm_add_ps(s0, _mm_movehl_ps(s0, s0));
+	s0 = _mm_add_ss(s0, _mm_shuffle_ps(s0, s0, 1));
+	sum = _mm_cvtss_f32(s0);
+
+	for (; i < size; i++) sum += a[i] * b[i];
+	return sum;
+}
+
+SIMD_TARGET("sse2")
+static int64_t hsum_epi64_sse2(__m128i v)
+{
+	v = _mm_add_epi64(v, _mm_unpackhi_epi64(v, v));
+#if defined(__x86_64__) || defined(_M_X64)
+	return (int64_t)_mm_cvtsi128_si64(v);
+#else
+	{
+		int64_t out[2];
+		_mm_storeu_si128((__m128i*)out, v);
+		return out[0];
+	}
+#endif
+}
+
+SIMD_TARGET("sse2")
+static __m128i widen_add_epi32_sse2(__m128i acc, __m128i v)
+{
+	/*
+	* widen the four pmaddwd sums of v to int64 and add them to the two int64 of acc.
+	* A pair sum is at least -2^31 + 2^16, so INT32_MIN only comes from the wrapped
+	* +2^31 of two (-32768 * -32768) products : it is zero extended instead.
+	*/
+	__m128i sign = _mm_andnot_si128(_mm_cmpeq_epi32(v, _mm_set1_epi32(INT32_MIN)), _mm_srai_epi32(v, 31));
+	acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+	return _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+}
+
+SIMD_TARGET("sse2")
+int64_t dot_q15_sse2(const q15_t* a, const q15_t* b, const size_t size)
+{
+	/*
+	* pmaddwd gives int32 sums of two Q30 products, they are widened to int64
+	* before accumulation so long vectors do not overflow. The one sum pmaddwd
+	* wraps, a pair of (-32768 * -32768) products, is undone by the widening.
+	*/
+
+	__m128i s0 = _mm_setzero_si128(), s1 = _mm_setzero_si128();
+	int64_t sum;
+	size_t i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		s0 = widen_add_epi32_sse2(s0, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i))));
+		s1 = widen_add_epi32_sse2(s1, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(a + i + 8)), _mm_loadu_si128((const __m128i*)(b + i + 8))));
+	}
+	for (; i + 8 <= size; i += 8)
+		s0 = widen_add_epi32_sse2(s0, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i))));
+
+	sum = hsum_epi64_sse2(_mm_add_epi64(s0, s1));
+	for (; i < size; i++) sum += (int32_t)a[i] * b[i];
+	return sum;
+}
+
+SIMD_TARGET("avx2,fma")
+float dot_f32_avx2(const f32_t* a, const f32_t* b, const size_t size)
+{
+	__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+	__m128 h;
+	float sum;
+	size_t i = 0;
+
+	for (; i + 32 <= size; i += 32)
+	{
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+		s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), s1);
+		s2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), s2);
+		s3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), s3);
+	}
+	for (; i + 8 <= size; i += 8)
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+
+	s0 = _mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3));
+	h = _mm_add_ps(_mm256_castps256_ps128(s0), _mm256_extractf128_ps(s0, 1));
+	h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+	h = _mm_add_ss(h, _mm_shuffle_ps(h, h, 1));
+	sum = _mm_cvtss_f32(h);
+
+	for (; i < size; i++) sum += a[i] * b[i];
+	return sum;
+}
+
+SIMD_TARGET("avx2,fma")
+int64_t dot_q15_avx2(const q15_t* a, const q15_t* b, const size_t size)
+{
+	/* same scheme as dot_q15_sse2 : vpmaddwd, then widening to int64 with the wrapped +2^31 zero extended */
+
+	const __m256i wrapped = _mm256_set1_epi32(INT32_MIN);
+	__m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256(), p, sign;
+	__m128i h;
+	int64_t sum;
+	size_t i = 0;
+
+	for (; i + 16 <= size; i += 16)
+	{
+		p = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+		sign = _mm256_andnot_si256(_mm256_cmpeq_epi32(p, wrapped), _mm256_srai_epi32(p, 31));
+		s0 = _mm256_add_epi64(s0, _mm256_unpacklo_epi32(p, sign));
+		s1 = _mm256_add_epi64(s1, _mm256_unpackhi_epi32(p, sign));
+	}
+
+	s0 = _mm256_add_epi64(s0, s1);
+	h = _mm_add_epi64(_mm256_castsi256_si128(s0), _mm256_extracti128_si256(s0, 1));
+	sum = hsum_epi64_sse2(h);
+
+	for (; i < size; i++) sum += (int32_t)a[i] * b[i];
+	return sum;
+}
+
+SIMD_TARGET("avx512f")
+float dot_f32_avx512(const f32_t* a, const f32_t* b, const size_t size)
+{
+	__m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+	float sum;
+	size_t i = 0;
+
+	for (; i + 32 <= size; i += 32)
+	{
+		s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), s0);
+		s1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), s1);
+	}
+	for (; i + 16 <= size; i += 16)
+		s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), s0);
+
+	sum = _mm512_reduce_add_ps(_mm512_add_ps(s0, s1));
+
+	for (; i < size; i++) sum += a[i] * b[i];
+	return sum;
+}
+#endif
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          OSCILLATOR KERNELS
+*******************************************************************************/
+void osc_lanes_scalar(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate)
+{
+	dtype r;
+	size_t s, l;
+
+	for (s = 0; s < steps; s++, out += stride)
+	{
+		for (l = 0; l < SIMD_LANES; l++)
+		{
+			if (accumulate) out[l] += amp[l] * im[l];
+			else out[l] = amp[l] * im[l];
+			r = re[l] * step_re[l] - im[l] * step_im[l];
+			im[l] = re[l] * step_im[l] + im[l] * step_re[l];
+			re[l] = r;
+		}
+	}
+}
+
+#ifdef __SIMD_X86__
+SIMD_TARGET("sse2")
+void osc_lanes_sse2(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate)
+{
+	__m128d zr[4], zi[4], sr[4], si[4], a[4], y, r;
+	size_t s;
+	int l;
+
+	for (l = 0; l < 4; l++)
+	{
+		zr[l] = _mm_loadu_pd(re + 2 * l), zi[l] = _mm_loadu_pd(im + 2 * l);
+		sr[l] = _mm_loadu_pd(step_re + 2 * l), si[l] = _mm_loadu_pd(step_im + 2 * l);
+		a[l] = _mm_loadu_pd(amp + 2 * l);
+	}
+
+	for (s = 0; s < steps; s++, out += stride)
+	{
+		for (l = 0; l < 4; l++)
+		{
+			y = _mm_mul_pd(a[l], zi[l]);
+			if (accumulate) y = _mm_add_pd(y, _mm_loadu_pd(out + 2 * l));
+			_mm_storeu_pd(out + 2 * l, y);
+			r = _mm_sub_pd(_mm_mul_pd(zr[l], sr[l]), _mm_mul_pd(zi[l], si[l]));
+			zi[l] = _mm_add_pd(_mm_mul_pd(zr[l], si[l]), _mm_mul_pd(zi[l], sr[l]));
+			zr[l] = r;
+		}
+	}
+
+	for (l = 0; l < 4; l++) _mm_storeu_pd(re + 2 * l, zr[l]), _mm_storeu_pd(im + 2 * l, zi[l]);
+}
+
+SIMD_TARGET("avx2,fma")
+void osc_lanes_avx2(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate)
+{
+	/* two chains, z and z * step, both rotated by step^2 : hides the latency of the rotation */
+	const __m256d sr0 = _mm256_loadu_pd(step_re), sr1 = _mm256_loadu_pd(step_re + 4);
+	const __m256d si0 = _mm256_loadu_pd(step_im), si1 = _mm256_loadu_pd(step_im + 4);
+	const __m256d qr0 = _mm256_fmsub_pd(sr0, sr0, _mm256_mul_pd(si0, si0)), qr1 = _mm256_fmsub_pd(sr1, sr1, _mm256_mul_pd(si1, si1));
+	const __m256d qi0 = _mm256_mul_pd(_mm256_add_pd(sr0, sr0), si0), qi1 = _mm256_mul_pd(_mm256_add_pd(sr1, sr1), si1);
+	const __m256d a0 = _mm256_loadu_pd(amp), a1 = _mm256_loadu_pd(amp + 4);
+	__m256d zr0 = _mm256_loadu_pd(re), zr1 = _mm256_loadu_pd(re + 4);
+	__m256d zi0 = _mm256_loadu_pd(im), zi1 = _mm256_loadu_pd(im + 4);
+	__m256d wr0 = _mm256_fmsub_pd(zr0, sr0, _mm256_mul_pd(zi0, si0)), wr1 = _mm256_fmsub_pd(zr1, sr1, _mm256_mul_pd(zi1, si1));
+	__m256d wi0 = _mm256_fmadd_pd(zr0, si0, _mm256_mul_pd(zi0, sr0)), wi1 = _mm256_fmadd_pd(zr1, si1, _mm256_mul_pd(zi1, sr1));
+	__m256d r0, r1, r2, r3;
+	size_t s = 0;
+
+	for (; s + 2 <= steps; s += 2, out += 2 * stride)
+	{
+		if (accumulate)
+		{
+			_mm256_storeu_pd(out, _mm256_fmadd_pd(a0, zi0, _mm256_loadu_pd(out)));
+			_mm256_storeu_pd(out + 4, _mm256_fmadd_pd(a1, zi1, _mm256_loadu_pd(out + 4)));
+			_mm256_storeu_pd(out + stride, _mm256_fmadd_pd(a0, wi0, _mm256_loadu_pd(out + stride)));
+			_mm256_storeu_pd(out + stride + 4, _mm256_fmadd_pd(a1, wi1, _mm256_loadu_pd(out + stride + 4)));
+		}
+		else
+		{
+			_mm256_storeu_pd(out, _mm256_mul_pd(a0, zi0));
+			_mm256_storeu_pd(out + 4, _mm256_mul_pd(a1, zi1));
+			_mm256_storeu_pd(out + stride, _mm256_mul_pd(a0, wi0));
+			_mm256_storeu_pd(out + stride + 4, _mm256_mul_pd(a1, wi1));
+		}
+		r0 = _mm256_fmsub_pd(zr0, qr0, _mm256_mul_pd(zi0, qi0));
+		r1 = _mm256_fmsub_pd(zr1, qr1, _mm256_mul_pd(zi1, qi1));
+		r2 = _mm256_fmsub_pd(wr0, qr0, _mm256_mul_pd(wi0, qi0));
+		r3 = _mm256_fmsub_pd(wr1, qr1, _mm256_mul_pd(wi1, qi1));
+		zi0 = _mm256_fmadd_pd(zr0, qi0, _mm256_mul_pd(zi0, qr0));
+		zi1 = _mm256_fmadd_pd(zr1, qi1, _mm256_mul_pd(zi1, qr1));
+		wi0 = _mm256_fmadd_pd(wr0, qi0, _mm256_mul_pd(wi0, qr0));
+		wi1 = _mm256_fmadd_pd(wr1, qi1, _mm256_mul_pd(wi1, qr1));
+		zr0 = r0, zr1 = r1, wr0 = r2, wr1 = r3;
+	}
+	if (s < steps) // odd step : emit z, the next state is w
+	{
+		if (accumulate)
+		{
+			_mm256_storeu_pd(out, _mm256_fmadd_pd(a0, zi0, _mm256_loadu_pd(out)));
+			_mm256_storeu_pd(out + 4, _mm256_fmadd_pd(a1, zi1, _mm256_loadu_pd(out + 4)));
+		}
+		else
+		{
+			_mm256_storeu_pd(out, _mm256_mul_pd(a0, zi0));
+			_mm256_storeu_pd(out + 4, _mm256_mul_pd(a1, zi1));
+		}
+		zr0 = wr0, zr1 = wr1, zi0 = wi0, zi1 = wi1;
+	}
+
+	_mm256_storeu_pd(re, zr0), _mm256_storeu_pd(re + 4, zr1);
+	_mm256_storeu_pd(im, zi0), _mm256_storeu_pd(im + 4, zi1);
+}
+
+SIMD_TARGET("avx512f")
+void osc_lanes_avx512(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate)
+{
+	/* two chains as in the avx2 kernel */
+	const __m512d sr = _mm512_loadu_pd(step_re), si = _mm512_loadu_pd(step_im), a = _mm512_loadu_pd(amp);
+	const __m512d qr = _mm512_fmsub_pd(sr, sr, _mm512_mul_pd(si, si)), qi = _mm512_mul_pd(_mm512_add_pd(sr, sr), si);
+	__m512d zr = _mm512_loadu_pd(re), zi = _mm512_loadu_pd(im);
+	__m512d wr = _mm512_fmsub_pd(zr, sr, _mm512_mul_pd(zi, si)), wi = _mm512_fmadd_pd(zr, si, _mm512_mul_pd(zi, sr));
+	__m512d r0, r1;
+	size_t s = 0;
+
+	for (; s + 2 <= steps; s += 2, out += 2 * stride)
+	{
+		if (accumulate)
+		{
+			_mm512_storeu_pd(out, _mm512_fmadd_pd(a, zi, _mm512_loadu_pd(out)));
+			_mm512_storeu_pd(out + stride, _mm512_fmadd_pd(a, wi, _mm512_loadu_pd(out + stride)));
+		}
+		else
+		{
+			_mm512_storeu_pd(out, _mm512_mul_pd(a, zi));
+			_mm512_storeu_pd(out + stride, _mm512_mul_pd(a, wi));
+		}
+		r0 = _mm512_fmsub_pd(zr, qr, _mm512_mul_pd(zi, qi));
+		r1 = _mm512_fmsub_pd(wr, qr, _mm512_mul_pd(wi, qi));
+		zi = _mm512_fmadd_pd(zr, qi, _mm512_mul_pd(zi, qr));
+		wi = _mm512_fmadd_pd(wr, qi, _mm512_mul_pd(wi, qr));
+		zr = r0, wr = r1;
+	}
+	if (s < steps)
+	{
+		if (accumulate) _mm512_storeu_pd(out, _mm512_fmadd_pd(a, zi, _mm512_loadu_pd(out)));
+		else _mm512_storeu_pd(out, _mm512_mul_pd(a, zi));
+		zr = wr, zi = wi;
+	}
+
+	_mm512_storeu_pd(re, zr);
+	_mm512_storeu_pd(im, zi);
+}
+#endif
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          RANDOM KERNELS
+*******************************************************************************/
+#define rotl64(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+void rng_lanes_scalar(uint64_t* state, uint64_t* out, const size_t steps)
+{
+	uint64_t* s0 = state, * s1 = state + SIMD_LANES, * s2 = state + 2 * SIMD_LANES, * s3 = state + 3 * SIMD_LANES;
+	uint64_t t, r;
+	size_t s;
+	int l;
+
+	for (s = 0; s < steps; s++, out += SIMD_LANES)
+	{
+		for (l = 0; l < SIMD_LANES; l++)
+		{
+			r = s0[l] + s3[l];
+			out[l] = rotl64(r, 23) + s0[l];
+			t = s1[l] << 17;
+			s2[l] ^= s0[l];
+			s3[l] ^= s1[l];
+			s1[l] ^= s2[l];
+			s0[l] ^= s3[l];
+			s2[l] ^= t;
+			s3[l] = rotl64(s3[l], 45);
+		}
+	}
+}
+
+#ifdef __SIMD_X86__
+#define rotl_epi64_sse2(x, k) _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - (k)))
+#define rotl_epi64_avx2(x, k) _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - (k)))
+
+SIMD_TARGET("sse2")
+void rng_lanes_sse2(uint64_t* state, uint64_t* out, const size_t steps)
+{
+	__m128i s0[4], s1[4], s2[4], s3[4], t, r;
+	size_t s;
+	int l;
+
+	for (l = 0; l < 4; l++)
+	{
+		s0[l] = _mm_loadu_si128((const __m128i*)(state + 2 * l));
+		s1[l] = _mm_loadu_si128((const __m128i*)(state + SIMD_LANES + 2 * l));
+		s2[l] = _mm_loadu_si128((const __m128i*)(state + 2 * SIMD_LANES + 2 * l));
+		s3[l] = _mm_loadu_si128((const __m128i*)(state + 3 * SIMD_LANES + 2 * l));
+	}
+
+	for (s = 0; s < steps; s++, out += SIMD_LANES)
+	{
+		for (l = 0; l < 4; l++)
+		{
+			r = _mm_add_epi64(s0[l], s3[l]);
+			_mm_storeu_si128((__m128i*)(out + 2 * l), _mm_add_epi64(rotl_epi64_sse2(r, 23), s0[l]));
+			t = _mm_slli_epi64(s1[l], 17);
+			s2[l] = _mm_xor_si128(s2[l], s0[l]);
+			s3[l] = _mm_xor_si128(s3[l], s1[l]);
+			s1[l] = _mm_xor_si128(s1[l], s2[l]);
+			s0[l] = _mm_xor_si128(s0[l], s3[l]);
+			s2[l] = _mm_xor_si128(s2[l], t);
+			s3[l] = rotl_epi64_sse2(s3[l], 45);
+		}
+	}
+
+	for (l = 0; l < 4; l++)
+	{
+		_mm_storeu_si128((__m128i*)(state + 2 * l), s0[l]);
+		_mm_storeu_si128((__m128i*)(state + SIMD_LANES + 2 * l), s1[l]);
+		_mm_storeu_si128((__m128i*)(state + 2 * SIMD_LANES + 2 * l), s2[l]);
+		_mm_storeu_si128((__m128i*)(state + 3 * SIMD_LANES + 2 * l), s3[l]);
+	}
+}
+
+SIMD_TARGET("avx2")
+void rng_lanes_avx2(uint64_t* state, uint64_t* out, const size_t steps)
+{
+	__m256i s0[2], s1[2], s2[2], s3[2], t, r;
+	size_t s;
+	int l;
+
+	for (l = 0; l < 2; l++)
+	{
+		s0[l] = _mm256_loadu_si256((const __m256i*)(state + 4 * l));
+		s1[l] = _mm256_loadu_si256((const __m256i*)(state + SIMD_LANES + 4 * l));
+		s2[l] = _mm256_loadu_si256((const __m256i*)(state + 2 * SIMD_LANES + 4 * l));
+		s3[l] = _mm256_loadu_si256((const __m256i*)(state + 3 * SIMD_LANES + 4 * l));
+	}
+
+	for (s = 0; s < steps; s++, out += SIMD_LANES)
+	{
+		for (l = 0; l < 2; l++)
+		{
+			r = _mm256_add_epi64(s0[l], s3[l]);
+			_mm256_storeu_si256((__m256i*)(out + 4 * l), _mm256_add_epi64(rotl_epi64_avx2(r, 23), s0[l]));
+			t = _mm256_slli_epi64(s1[l], 17);
+			s2[l] = _mm256_xor_si256(s2[l], s0[l]);
+			s3[l] = _mm256_xor_si256(s3[l], s1[l]);
+			s1[l] = _mm256_xor_si256(s1[l], s2[l]);
+			s0[l] = _mm256_xor_si256(s0[l], s3[l]);
+			s2[l] = _mm256_xor_si256(s2[l], t);
+			s3[l] = rotl_epi64_avx2(s3[l], 45);
+		}
+	}
+
+	for (l = 0; l < 2; l++)
+	{
+		_mm256_storeu_si256((__m256i*)(state + 4 * l), s0[l]);
+		_mm256_storeu_si256((__m256i*)(state + SIMD_LANES + 4 * l), s1[l]);
+		_mm256_storeu_si256((__m256i*)(state + 2 * SIMD_LANES + 4 * l), s2[l]);
+		_mm256_storeu_si256((__m256i*)(state + 3 * SIMD_LANES + 4 * l), s3[l]);
+	}
+}
+
+SIMD_TARGET("avx512f")
+void rng_lanes_avx512(uint64_t* state, uint64_t* out, const size_t steps)
+{
+	__m512i s0 = _mm512_loadu_si512(state), s1 = _mm512_loadu_si512(state + SIMD_LANES);
+	__m512i s2 = _mm512_loadu_si512(state + 2 * SIMD_LANES), s3 = _mm512_loadu_si512(state + 3 * SIMD_LANES);
+	__m512i t;
+	size_t s;
+
+	for (s = 0; s < steps; s++, out += SIMD_LANES)
+	{
+		_mm512_storeu_si512(out, _mm512_add_epi64(_mm512_rol_epi64(_mm512_add_epi64(s0, s3), 23), s0));
+		t = _mm512_slli_epi64(s1, 17);
+		s2 = _mm512_xor_si512(s2, s0);
+		s3 = _mm512_xor_si512(s3, s1);
+		s1 = _mm512_xor_si512(s1, s2);
+		s0 = _mm512_xor_si512(s0, s3);
+		s2 = _mm512_xor_si512(s2, t);
+		s3 = _mm512_rol_epi64(s3, 45);
+	}
+
+	_mm512_storeu_si512(state, s0);
+	_mm512_storeu_si512(state + SIMD_LANES, s1);
+	_mm512_storeu_si512(state + 2 * SIMD_LANES, s2);
+	_mm512_storeu_si512(state + 3 * SIMD_LANES, s3);
+}
+#endif
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          BIQUAD KERNELS
+*******************************************************************************/
+/*
+* The recurrence of one section is a chain of two multiply-adds per frame.
+* The avx2 and avx512 kernels run two sections at once, the second one a
+* frame behind the first (it filters the output of the previous frame),
+* so the two chains are independent and overlap.
+*/
+#define BQ_COEF (5 * SIMD_LANES)	// coefficients of one section
+#define BQ_STATE (2 * SIMD_LANES)	// state of one section
+
+static void biquad_section_scalar(const dtype* coef, dtype* state, dtype* x, const size_t n, const size_t stride)
+{
+	const dtype* b0 = coef, * b1 = coef + SIMD_LANES, * b2 = coef + 2 * SIMD_LANES;
+	const dtype* a1 = coef + 3 * SIMD_LANES, * a2 = coef + 4 * SIMD_LANES;
+	dtype s1[SIMD_LANES], s2[SIMD_LANES], xv, y;
+	size_t k, l;
+
+	for (l = 0; l < SIMD_LANES; l++) s1[l] = state[l], s2[l] = state[SIMD_LANES + l];
+
+	for (k = 0; k < n; k++, x += stride)
+	{
+		for (l = 0; l < SIMD_LANES; l++)
+		{
+			xv = x[l];
+			y = b0[l] * xv + s1[l];
+			s1[l] = b1[l] * xv - a1[l] * y + s2[l];
+			s2[l] = b2[l] * xv - a2[l] * y;
+			x[l] = y;
+		}
+	}
+
+	for (l = 0; l < SIMD_LANES; l++) state[l] = s1[l], state[SIMD_LANES + l] = s2[l];
+}
+
+void biquad_lanes_scalar(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride)
+{
+	size_t s;
+
+	for (s = 0; s < n_sections; s++) biquad_section_scalar(coef + s * BQ_COEF, state + s * BQ_STATE, x, n, stride);
+}
+
+#ifdef __SIMD_X86__
+SIMD_TARGET("sse2")
+void biquad_lanes_sse2(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride)
+{
+	/* four independent vectors per frame already overlap, one section at a time */
+	__m128d b0[4], b1[4], b2[4], a1[4], a2[4], s1[4], s2[4], xv, y;
+	dtype* p;
+	size_t k, s;
+	int l;
+
+	for (s = 0; s < n_sections; s++, coef += BQ_COEF, state += BQ_STATE)
+	{
+		for (l = 0; l < 4; l++)
+		{
+			b0[l] = _mm_loadu_pd(coef + 2 * l), b1[l] = _mm_loadu_pd(coef + SIMD_LANES + 2 * l);
+			b2[l] = _mm_loadu_pd(coef + 2 * SIMD_LANES + 2 * l);
+			a1[l] = _mm_loadu_pd(coef + 3 * SIMD_LANES + 2 * l), a2[l] = _mm_loadu_pd(coef + 4 * SIMD_LANES + 2 * l);
+			s1[l] = _mm_loadu_pd(state + 2 * l), s2[l] = _mm_loadu_pd(state + SIMD_LANES + 2 * l);
+		}
+
+		for (k = 0, p = x; k < n; k++, p += stride)
+		{
+			for (l = 0; l < 4; l++)
+			{
+				xv = _mm_loadu_pd(p + 2 * l);
+				y = _mm_add_pd(_mm_mul_pd(b0[l], xv), s1[l]);
+				s1[l] = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(b1[l], xv), s2[l]), _mm_mul_pd(a1[l], y));
+				s2[l] = _mm_sub_pd(_mm_mul_pd(b2[l], xv), _mm_mul_pd(a2[l], y));
+				_mm_storeu_pd(p + 2 * l, y);
+			}
+		}
+
+		for (l = 0; l < 4; l++) _mm_storeu_pd(state + 2 * l, s1[l]), _mm_storeu_pd(state + SIMD_LANES + 2 * l, s2[l]);
+	}
+}
+
+#define bq_step_avx2(y, xv, c, s1, s2) \
+	y = _mm256_fmadd_pd(c[0], xv, s1); \
+	s1 = _mm256_fnmadd_pd(c[3], y, _mm256_fmadd_pd(c[1], xv, s2)); \
+	s2 = _mm256_fnmadd_pd(c[4], y, _mm256_mul_pd(c[2], xv))
+
+SIMD_TARGET("avx2,fma")
+void biquad_lanes_avx2(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride)
+{
+	/* lanes 0..3 and 4..7 of a section are two more independent chains */
+	__m256d c0[5], c1[5], d0[5], d1[5];	// section s (c) and s + 1 (d), low and high half
+	__m256d s10, s11, s20, s21, t10, t11, t20, t21, x0, x1, y0, y1, z0, z1, p0, p1;
+	dtype* p;
+	size_t k, s = 0;
+	int j;
+
+	if (n == 0) return;
+
+	for (; s + 2 <= n_sections; s += 2, coef += 2 * BQ_COEF, state += 2 * BQ_STATE)
+	{
+		for (j = 0; j < 5; j++)
+		{
+			c0[j] = _mm256_loadu_pd(coef + j * SIMD_LANES), c1[j] = _mm256_loadu_pd(coef + j * SIMD_LANES + 4);
+			d0[j] = _mm256_loadu_pd(coef + BQ_COEF + j * SIMD_LANES), d1[j] = _mm256_loadu_pd(coef + BQ_COEF + j * SIMD_LANES + 4);
+		}
+		s10 = _mm256_loadu_pd(state), s11 = _mm256_loadu_pd(state + 4);
+		s20 = _mm256_loadu_pd(state + SIMD_LANES), s21 = _mm256_loadu_pd(state + SIMD_LANES + 4);
+		t10 = _mm256_loadu_pd(state + BQ_STATE), t11 = _mm256_loadu_pd(state + BQ_STATE + 4);
+		t20 = _mm256_loadu_pd(state + BQ_STATE + SIMD_LANES), t21 = _mm256_loadu_pd(state + BQ_STATE + SIMD_LANES + 4);
+
+		x0 = _mm256_loadu_pd(x), x1 = _mm256_loadu_pd(x + 4);
+		bq_step_avx2(p0, x0, c0, s10, s20);
+		bq_step_avx2(p1, x1, c1, s11, s21);
+
+		for (k = 1, p = x; k < n; k++, p += stride) // p : frame k - 1
+		{
+			x0 = _mm256_loadu_pd(p + stride), x1 = _mm256_loadu_pd(p + stride + 4);
+			bq_step_avx2(y0, x0, c0, s10, s20);
+			bq_step_avx2(y1, x1, c1, s11, s21);
+			bq_step_avx2(z0, p0, d0, t10, t20);
+			bq_step_avx2(z1, p1, d1, t11, t21);
+			_mm256_storeu_pd(p, z0), _mm256_storeu_pd(p + 4, z1);
+			p0 = y0, p1 = y1;
+		}
+		bq_step_avx2(z0, p0, d0, t10, t20);
+		bq_step_avx2(z1, p1, d1, t11, t21);
+		_mm256_storeu_pd(p, z0), _mm256_storeu_pd(p + 4, z1);
+
+		_mm256_storeu_pd(state, s10), _mm256_storeu_pd(state + 4, s11);
+		_mm256_storeu_pd(state + SIMD_LANES, s20), _mm256_storeu_pd(state + SIMD_LANES + 4, s21);
+		_mm256_storeu_pd(state + BQ_STATE, t10), _mm256_storeu_pd(state + BQ_STATE + 4, t11);
+		_mm256_storeu_pd(state + BQ_STATE + SIMD_LANES, t20), _mm256_storeu_pd(state + BQ_STATE + SIMD_LANES + 4, t21);
+	}
+
+	if (s < n_sections) // last odd section
+	{
+		for (j = 0; j < 5; j++) c0[j] = _mm256_loadu_pd(coef + j * SIMD_LANES), c1[j] = _mm256_loadu_pd(coef + j * SIMD_LANES + 4);
+		s10 = _mm256_loadu_pd(state), s11 = _mm256_loadu_pd(state + 4);
+		s20 = _mm256_loadu_pd(state + SIMD_LANES), s21 = _mm256_loadu_pd(state + SIMD_LANES + 4);
+
+		for (k = 0, p = x; k < n; k++, p += stride)
+		{
+			x0 = _mm256_loadu_pd(p), x1 = _mm256_loadu_pd(p + 4);
+			bq_step_avx2(y0, x0, c0, s10, s20);
+			bq_step_avx2(y1, x1, c1, s11, s21);
+			_mm256_storeu_pd(p, y0), _mm256_storeu_pd(p + 4, y1);
+		}
+
+		_mm256_storeu_pd(state, s10), _mm256_storeu_pd(state + 4, s11);
+		_mm256_storeu_pd(state + SIMD_LANES, s20), _mm256_storeu_pd(state + SIMD_LANES + 4, s21);
+	}
+}
+
+#define bq_step_avx512(y, xv, c, s1, s2) \
+	y = _mm512_fmadd_pd(c[0], xv, s1); \
+	s1 = _mm512_fnmadd_pd(c[3], y, _mm512_fmadd_pd(c[1], xv, s2)); \
+	s2 = _mm512_fnmadd_pd(c[4], y, _mm512_mul_pd(c[2], xv))
+
+SIMD_TARGET("avx512f")
+void biquad_lanes_avx512(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride)
+{
+	__m512d c[5], d[5], s1, s2, t1, t2, xv, y, z, prev;
+	dtype* p;
+	size_t k, s = 0;
+	int j;
+
+	if (n == 0) return;
+
+	for (; s + 2 <= n_sections; s += 2, coef += 2 * BQ_COEF, state += 2 * BQ_STATE)
+	{
+		for (j = 0; j < 5; j++) c[j] = _mm512_loadu_pd(coef + j * SIMD_LANES), d[j] = _mm512_loadu_pd(coef + BQ_COEF + j * SIMD_LANES);
+		s1 = _mm512_loadu_pd(state), s2 = _mm512_loadu_pd(state + SIMD_LANES);
+		t1 = _mm512_loadu_pd(state + BQ_STATE), t2 = _mm512_loadu_pd(state + BQ_STATE + SIMD_LANES);
+
+		xv = _mm512_loadu_pd(x);
+		bq_step_avx512(prev, xv, c, s1, s2);
+
+		for (k = 1, p = x; k < n; k++, p += stride) // p : frame k - 1
+		{
+			xv = _mm512_loadu_pd(p + stride);
+			bq_step_avx512(y, xv, c, s1, s2);
+			bq_step_avx512(z, prev, d, t1, t2);
+			_mm512_storeu_pd(p, z);
+			prev = y;
+		}
+		bq_step_avx512(z, prev, d, t1, t2);
+		_mm512_storeu_pd(p, z);
+
+		_mm512_storeu_pd(state, s1), _mm512_storeu_pd(state + SIMD_LANES, s2);
+		_mm512_storeu_pd(state + BQ_STATE, t1), _mm512_storeu_pd(state + BQ_STATE + SIMD_LANES, t2);
+	}
+
+	if (s < n_sections) // last odd section
+	{
+		for (j = 0; j < 5; j++) c[j] = _mm512_loadu_pd(coef + j * SIMD_LANES);
+		s1 = _mm512_loadu_pd(state), s2 = _mm512_loadu_pd(state + SIMD_LANES);
+
+		for (k = 0, p = x; k < n; k++, p += stride)
+		{
+			xv = _mm512_loadu_pd(p);
+			bq_step_avx512(y, xv, c, s1, s2);
+			_mm512_storeu_pd(p, y);
+		}
+
+		_mm512_storeu_pd(state, s1), _mm512_storeu_pd(state + SIMD_LANES, s2);
+	}
+}
+#endif
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          ELEMENT-WISE KERNELS
+*******************************************************************************/
+/*
+* Clamp is max(a, x) then min(b, .) with the bound as the first operand :
+* maxpd / minpd return the second operand on a NaN, so a NaN passes through
+* like in the scalar compare chain.
+*/
+void elementwise_scalar(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op)
+{
+	size_t k;
+
+	switch (op)
+	{
+	case SIMD_EW_SCALE: for (k = 0; k < n; k++) x[k] *= a; break;
+	case SIMD_EW_OFFSET: for (k = 0; k < n; k++) x[k] += a; break;
+	case SIMD_EW_ADD: for (k = 0; k < n; k++) x[k] += arr[k]; break;
+	case SIMD_EW_MUL: for (k = 0; k < n; k++) x[k] *= arr[k]; break;
+	case SIMD_EW_CLAMP: for (k = 0; k < n; k++) x[k] = x[k] < a ? a : x[k] > b ? b : x[k]; break;
+	}
+}
+
+#ifdef __SIMD_X86__
+#define EW_LOOP(W, load, store, expr) for (; k + (W) <= n; k += (W)) { v = load(x + k); store(x + k, expr); }
+
+SIMD_TARGET("sse2")
+void elementwise_sse2(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op)
+{
+	const __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b);
+	__m128d v;
+	size_t k = 0;
+
+	switch (op)
+	{
+	case SIMD_EW_SCALE: EW_LOOP(2, _mm_loadu_pd, _mm_storeu_pd, _mm_mul_pd(v, va)) break;
+	case SIMD_EW_OFFSET: EW_LOOP(2, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd(v, va)) break;
+	case SIMD_EW_ADD: EW_LOOP(2, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd(v, _mm_loadu_pd(arr + k))) break;
+	case SIMD_EW_MUL: EW_LOOP(2, _mm_loadu_pd, _mm_storeu_pd, _mm_mul_pd(v, _mm_loadu_pd(arr + k))) break;
+	case SIMD_EW_CLAMP: EW_LOOP(2, _mm_loadu_pd, _mm_storeu_pd, _mm_min_pd(vb, _mm_max_pd(va, v))) break;
+	}
+	elementwise_scalar(x + k, arr ? arr + k : NULL, a, b, n - k, op);
+}
+
+SIMD_TARGET("avx2")
+void elementwise_avx2(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op)
+{
+	const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+	__m256d v;
+	size_t k = 0;
+
+	switch (op)
+	{
+	case SIMD_EW_SCALE: EW_LOOP(4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_mul_pd(v, va)) break;
+	case SIMD_EW_OFFSET: EW_LOOP(4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd(v, va)) break;
+	case SIMD_EW_ADD: EW_LOOP(4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd(v, _mm256_loadu_pd(arr + k))) break;
+	case SIMD_EW_MUL: EW_LOOP(4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_mul_pd(v, _mm256_loadu_pd(arr + k))) break;
+	case SIMD_EW_CLAMP: EW_LOOP(4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_min_pd(vb, _mm256_max_pd(va, v))) break;
+	}
+	elementwise_scalar(x + k, arr ? arr + k : NULL, a, b, n - k, op);
+}
+
+SIMD_TARGET("avx512f")
+void elementwise_avx512(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op)
+{
+	const __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b);
+	__m512d v;
+	size_t k = 0;
+
+	switch (op)
+	{
+	case SIMD_EW_SCALE: EW_LOOP(8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_mul_pd(v, va)) break;
+	case SIMD_EW_OFFSET: EW_LOOP(8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_add_pd(v, va)) break;
+	case SIMD_EW_ADD: EW_LOOP(8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_add_pd(v, _mm512_loadu_pd(arr + k))) break;
+	case SIMD_EW_MUL: EW_LOOP(8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_mul_pd(v, _mm512_loadu_pd(arr + k))) break;
+	case SIMD_EW_CLAMP: EW_LOOP(8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_min_pd(vb, _mm512_max_pd(va, v))) break;
+	}
+	elementwise_scalar(x + k, arr ? arr + k : NULL, a, b, n - k, op);
+}
+#endif
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          DISPATCH
+*******************************************************************************/
+static void install_kernels(int level)
+{
+	switch (level)
+	{
+#ifdef __SIMD_X86__
+	case SIMD_AVX512:
+		simd_dot = dot_avx512; simd_dot_shift4 = dot_shift4_avx512; simd_dot_stride4 = dot_stride4_avx512;
+		simd_lms_update_dot = lms_update_dot_avx512;
+		simd_lanes_fir = lanes_fir_avx512; simd_lanes_lms = lanes_lms_avx512;
+		simd_dot_f32 = dot_f32_avx512; simd_dot_q15 = dot_q15_avx2;
+		simd_osc_lanes = osc_lanes_avx512; simd_rng_lanes = rng_lanes_avx512;
+		simd_biquad_lanes = biquad_lanes_avx512; simd_elementwise = elementwise_avx512; break;
+	case SIMD_AVX2:
+		simd_dot = dot_avx2; simd_dot_shift4 = dot_shift4_avx2; simd_dot_stride4 = dot_stride4_avx2;
+		simd_lms_update_dot = lms_update_dot_avx2;
+		simd_lanes_fir = lanes_fir_avx2; simd_lanes_lms = lanes_lms_avx2;
+		simd_dot_f32 = dot_f32_avx2; simd_dot_q15 = dot_q15_avx2;
+		simd_osc_lanes = osc_lanes_avx2; simd_rng_lanes = rng_lanes_avx2;
+		simd_biquad_lanes = biquad_lanes_avx2; simd_elementwise = elementwise_avx2; break;
+	case SIMD_SSE2:
+		simd_dot = dot_sse2; simd_dot_shift4 = dot_shift4_sse2; simd_dot_stride4 = dot_stride4_sse2;
+		simd_lms_update_dot = lms_update_dot_sse2;
+		simd_lanes_fir = lanes_fir_sse2; simd_lanes_lms = lanes_lms_sse2;
+		simd_dot_f32 = dot_f32_sse2; simd_dot_q15 = dot_q15_sse2;
+		simd_osc_lanes = osc_lanes_sse2; simd_rng_lanes = rng_lanes_sse2;
+		simd_biquad_lanes = biquad_lanes_sse2; simd_elementwise = elementwise_sse2; break;
+#endif
+	default:
+		simd_dot = dot_scalar; simd_dot_shift4 = dot_shift4_scalar; simd_dot_stride4 = dot_stride4_scalar;
+		simd_lms_update_dot = lms_update_dot_scalar;
+		simd_lanes_fir = lanes_fir_scalar; simd_lanes_lms = lanes_lms_scalar;
+		simd_dot_f32 = dot_f32_scalar; simd_dot_q15 = dot_q15_scalar;
+		simd_osc_lanes = osc_lanes_scalar; simd_rng_lanes = rng_lanes_scalar;
+		simd_biquad_lanes = biquad_lanes_scalar; simd_elementwise = elementwise_scalar; level = SIMD_SCALAR; break;
+	}
+	used_level = level;
+}
+
+static dtype dot_resolve(const dtype* a, const dtype* b, const size_t size)
+{
+	simd_level();
+	return simd_dot(a, b, size);
+}
+
+static void dot_shift4_resolve(const dtype* h, const dtype* x, const size_t size, dtype out[4])
+{
+	simd_level();
+	simd_dot_shift4(h, x, size, out);
+}
+
+static void dot_stride4_resolve(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4])
+{
+	simd_level();
+	simd_dot_stride4(h, x, size, stride, out);
+}
+
+static dtype lms_update_dot_resolve(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g)
+{
+	simd_level();
+	return simd_lms_update_dot(h, cur, prev, size, beta, g);
+}
+
+static void lanes_fir_resolve(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES])
+{
+	simd_level();
+	simd_lanes_fir(h, x, size, stride, acc);
+}
+
+static void lanes_lms_resolve(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES])
+{
+	simd_level();
+	simd_lanes_lms(h, cur, size, stride, beta, gain, acc);
+}
+
+static float dot_f32_resolve(const f32_t* a, const f32_t* b, const size_t size)
+{
+	simd_level();
+	return simd_dot_f32(a, b, size);
+}
+
+static int64_t dot_q15_resolve(const q15_t* a, const q15_t* b, const size_t size)
+{
+	simd_level();
+	return simd_dot_q15(a, b, size);
+}
+
+static void osc_lanes_resolve(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate)
+{
+	simd_level();
+	simd_osc_lanes(re, im, step_re, step_im, amp, out, steps, stride, accumulate);
+}
+
+static void rng_lanes_resolve(uint64_t* state, uint64_t* out, const size_t steps)
+{
+	simd_level();
+	simd_rng_lanes(state, out, steps);
+}
+
+static void biquad_lanes_resolve(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride)
+{
+	simd_level();
+	simd_biquad_lanes(coef, state, n_sections, x, n, stride);
+}
+
+static void elementwise_resolve(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op)
+{
+	simd_level();
+	simd_elementwise(x, arr, a, b, n, op);
+}
+
+dot_kernel_t simd_dot = dot_resolve;
+dot_shift4_kernel_t simd_dot_shift4 = dot_shift4_resolve;
+dot_stride4_kernel_t simd_dot_stride4 = dot_stride4_resolve;
+lms_kernel_t simd_lms_update_dot = lms_update_dot_resolve;
+lanes_fir_kernel_t simd_lanes_fir = lanes_fir_resolve;
+lanes_lms_kernel_t simd_lanes_lms = lanes_lms_resolve;
+dot_f32_kernel_t simd_dot_f32 = dot_f32_resolve;
+dot_q15_kernel_t simd_dot_q15 = dot_q15_resolve;
+osc_lanes_kernel_t simd_osc_lanes = osc_lanes_resolve;
+rng_lanes_kernel_t simd_rng_lanes = rng_lanes_resolve;
+biquad_lanes_kernel_t simd_biquad_lanes = biquad_lanes_resolve;
+elementwise_kernel_t simd_elementwise = elementwise_resolve;
+
+int simd_level(void)
+{
+	/*
+	Description
+	-	Returns the level of the installed kernels.
+		The first call detects the cpu and installs the widest kernels,
+		calling it again is cheap. Detection is idempotent, so a race
+		between threads on the first call is harmless.
+	*/
+
+	if (used_level < 0)
+	{
+		cpu_level = detect_level();
+		install_kernels(cpu_level);
+	}
+	return used_level;
+}
+
+void simd_force_level(int level)
+{
+	if (cpu_level < 0) cpu_level = detect_level();
+	install_kernels(level < cpu_level ? level : cpu_level);
+}
+
+const char* simd_level_name(int level)
+{
+	switch (level)
+	{
+	case SIMD_SSE2: return "sse2";
+	case SIMD_AVX2: return "avx2";
+	case SIMD_AVX512: return "avx512";
+	default: return "scalar";
+	}
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#include "common.h"
+
+/******************************************************************************
+**                          SIMD LEVEL
+*******************************************************************************/
+#define SIMD_SCALAR 0
+#define SIMD_SSE2 1
+#define SIMD_AVX2 2   // AVX2 + FMA
+#define SIMD_AVX512 3 // AVX-512F
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define __SIMD_X86__
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(x) __attribute__((target(x)))
+#else
+#define SIMD_TARGET(x) // msvc compiles intrinsics without target flags
+#endif
+
+int simd_level(void);
+const char* simd_level_name(int level);
+void simd_force_level(int level); // for benchmarks and tests, clamped to the cpu level
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          DOT PRODUCT KERNELS
+*******************************************************************************/
+typedef dtype(*dot_kernel_t)(const dtype* a, const dtype* b, const size_t size);
+
+typedef void(*dot_shift4_kernel_t)(const dtype* h, const dtype* x, const size_t size, dtype out[4]);
+	// out[m] = h[0] * x[m] + ... + h[size - 1] * x[size - 1 + m], m = 0..3
+typedef void(*dot_stride4_kernel_t)(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4]);
+	// out[m] = h[0] * x[m * stride] + ... + h[size - 1] * x[size - 1 + m * stride], m = 0..3
+typedef dtype(*lms_kernel_t)(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g);
+	// h[k] = beta * h[k] + g * prev[k], returns h[0] * cur[0] + ... (updated h)
+
+/* lane kernels : SIMD_LANES independent channels, element k of lane l at x[k * stride + l] */
+#define SIMD_LANES 8
+
+typedef void(*lanes_fir_kernel_t)(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES]);
+	// acc[l] = sum h[k * stride + l] * x[k * stride + l]
+typedef void(*lanes_lms_kernel_t)(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES]);
+	// h = beta * h + gain * prev (prev = cur + stride), acc[l] = sum h * cur
+
+dtype dot_scalar(const dtype* a, const dtype* b, const size_t size);
+void dot_shift4_scalar(const dtype* h, const dtype* x, const size_t size, dtype out[4]);
+void dot_stride4_scalar(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4]);
+dtype lms_update_dot_scalar(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g);
+void lanes_fir_scalar(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES]);
+void lanes_lms_scalar(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES]);
+#ifdef __SIMD_X86__
+dtype dot_sse2(const dtype* a, const dtype* b, const size_t size);
+dtype dot_avx2(const dtype* a, const dtype* b, const size_t size);
+dtype dot_avx512(const dtype* a, const dtype* b, const size_t size);
+void dot_shift4_sse2(const dtype* h, const dtype* x, const size_t size, dtype out[4]);
+void dot_shift4_avx2(const dtype* h, const dtype* x, const size_t size, dtype out[4]);
+void dot_shift4_avx512(const dtype* h, const dtype* x, const size_t size, dtype out[4]);
+void dot_stride4_sse2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4]);
+void dot_stride4_avx2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4]);
+void dot_stride4_avx512(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype out[4]);
+dtype lms_update_dot_sse2(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g);
+dtype lms_update_dot_avx2(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g);
+dtype lms_update_dot_avx512(dtype* h, const dtype* cur, const dtype* prev, const size_t size, const dtype beta, const dtype g);
+void lanes_fir_sse2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES]);
+void lanes_fir_avx2(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES]);
+void lanes_fir_avx512(const dtype* h, const dtype* x, const size_t size, const size_t stride, dtype acc[SIMD_LANES]);
+void lanes_lms_sse2(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES]);
+void lanes_lms_avx2(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES]);
+void lanes_lms_avx512(dtype* h, const dtype* cur, const size_t size, const size_t stride,
+	const dtype beta[SIMD_LANES], const dtype gain[SIMD_LANES], dtype acc[SIMD_LANES]);
+#endif
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          TYPED DOT KERNELS
+*******************************************************************************/
+typedef float(*dot_f32_kernel_t)(const f32_t* a, const f32_t* b, const size_t size);
+typedef int64_t(*dot_q15_kernel_t)(const q15_t* a, const q15_t* b, const size_t size);
+	// exact sum of the Q30 products
+
+float dot_f32_scalar(const f32_t* a, const f32_t* b, const size_t size);
+int64_t dot_q15_scalar(const q15_t* a, const q15_t* b, const size_t size);
+#ifdef __SIMD_X86__
+float dot_f32_sse2(const f32_t* a, const f32_t* b, const size_t size);
+float dot_f32_avx2(const f32_t* a, const f32_t* b, const size_t size);
+float dot_f32_avx512(const f32_t* a, const f32_t* b, const size_t size);
+int64_t dot_q15_sse2(const q15_t* a, const q15_t* b, const size_t size);
+int64_t dot_q15_avx2(const q15_t* a, const q15_t* b, const size_t size); // also used at avx512 level
+#endif
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          OSCILLATOR KERNELS
+*******************************************************************************/
+typedef void(*osc_lanes_kernel_t)(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate);
+	// SIMD_LANES phasors z[l] = re[l] + j im[l], for s = 0..steps - 1 :
+	// out[s * stride + l] = (or += when accumulate) amp[l] * im[l], then z[l] *= step[l]
+
+void osc_lanes_scalar(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate);
+#ifdef __SIMD_X86__
+void osc_lanes_sse2(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate);
+void osc_lanes_avx2(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate);
+void osc_lanes_avx512(dtype* re, dtype* im, const dtype* step_re, const dtype* step_im, const dtype* amp,
+	dtype* out, const size_t steps, const size_t stride, const int accumulate);
+#endif
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          RANDOM KERNELS
+*******************************************************************************/
+typedef void(*rng_lanes_kernel_t)(uint64_t* state, uint64_t* out, const size_t steps);
+	// SIMD_LANES xoshiro256++ streams, word k of lane l at state[k * SIMD_LANES + l] :
+	// out[s * SIMD_LANES + l] = next output of lane l, s = 0..steps - 1
+
+void rng_lanes_scalar(uint64_t* state, uint64_t* out, const size_t steps);
+#ifdef __SIMD_X86__
+void rng_lanes_sse2(uint64_t* state, uint64_t* out, const size_t steps);
+void rng_lanes_avx2(uint64_t* state, uint64_t* out, const size_t steps);
+void rng_lanes_avx512(uint64_t* state, uint64_t* out, const size_t steps);
+#endif
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          BIQUAD KERNELS
+*******************************************************************************/
+typedef void(*biquad_lanes_kernel_t)(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride);
+	// n_sections transposed direct form II sections in cascade on SIMD_LANES channels, in place on x[k * stride + l], k = 0..n - 1 :
+	// section s : coef[(s * 5 + j) * SIMD_LANES + l] = b0, b1, b2, a1, a2, state[(s * 2 + j) * SIMD_LANES + l] = s1, s2
+
+void biquad_lanes_scalar(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride);
+#ifdef __SIMD_X86__
+void biquad_lanes_sse2(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride);
+void biquad_lanes_avx2(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride);
+void biquad_lanes_avx512(const dtype* coef, dtype* state, const size_t n_sections, dtype* x, const size_t n, const size_t stride);
+#endif
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          ELEMENT-WISE KERNELS
+*******************************************************************************/
+#define SIMD_EW_SCALE 0		// x[k] *= a
+#define SIMD_EW_OFFSET 1	// x[k] += a
+#define SIMD_EW_ADD 2		// x[k] += arr[k]
+#define SIMD_EW_MUL 3		// x[k] *= arr[k]
+#define SIMD_EW_CLAMP 4		// x[k] = x[k] < a ? a : x[k] > b ? b : x[k]
+
+typedef void(*elementwise_kernel_t)(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op);
+	// in place on x[0 .. n - 1], no fma : every level rounds like the scalar loop
+
+void elementwise_scalar(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op);
+#ifdef __SIMD_X86__
+void elementwise_sse2(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op);
+void elementwise_avx2(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op);
+void elementwise_avx512(dtype* x, const dtype* arr, const dtype a, const dtype b, const size_t n, const int op);
+#endif
+
+extern dot_kernel_t simd_dot; // selected by cpuid on first call
+extern dot_shift4_kernel_t simd_dot_shift4;
+extern dot_stride4_kernel_t simd_dot_stride4;
+extern lms_kernel_t simd_lms_update_dot;
+extern lanes_fir_kernel_t simd_lanes_fir;
+extern lanes_lms_kernel_t simd_lanes_lms;
+extern dot_f32_kernel_t simd_dot_f32;
+extern dot_q15_kernel_t simd_dot_q15;
+extern osc_lanes_kernel_t simd_osc_lanes;
+extern rng_lanes_kernel_t simd_rng_lanes;
+extern biquad_lanes_kernel_t simd_biquad_lanes;
+extern elementwise_kernel_t simd_elementwise;
+
+#endif
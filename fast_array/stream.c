@@ -0,0 +1,300 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Streaming file source : a background thread reads fixed size
+** chunks into two buffers while the caller consumes the other one
+** and pushes it into fast array rings.
+*/
+
+#include "stream.h"
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          READER THREAD
+*******************************************************************************/
+static size_t stream_fill(stream_handle stream, dtype* buffer, int* error)
+{
+	/* reads the next chunk into buffer, returns the number of frames, *error = 1 on a short read */
+
+	const size_t want = stream->chunk * stream->channels;
+	size_t frames, n;
+
+	if (!stream->binary)
+	{
+		n = read_data_chunk(stream->fp, buffer, want, stream->token, stream->data_type);
+		if (n < want && !feof(stream->fp)) *error = 1; // stopped at text that does not parse
+		if (stream->elem == ELEM_Q15) scaling(buffer, n, 1.0 / 32768.0); // same fractions as the binary path
+		else if (stream->elem == ELEM_Q31) scaling(buffer, n, 1.0 / 2147483648.0);
+		return n / stream->channels;
+	}
+
+	frames = (size_t)(stream->remain < stream->chunk ? stream->remain : stream->chunk);
+	if (frames == 0) return 0;
+	n = frames * stream->channels;
+
+	switch (stream->elem)
+	{
+	case ELEM_F64:
+		if (fread(buffer, sizeof(f64_t), n, stream->fp) != n) *error = 1;
+		break;
+	case ELEM_F32:
+		if (fread(stream->raw, sizeof(f32_t), n, stream->fp) != n) *error = 1;
+		to_dtype_f32((const f32_t*)stream->raw, buffer, n);
+		break;
+	case ELEM_Q15:
+		if (fread(stream->raw, sizeof(q15_t), n, stream->fp) != n) *error = 1;
+		to_dtype_q15((const q15_t*)stream->raw, buffer, n);
+		break;
+	default:
+		if (fread(stream->raw, sizeof(q31_t), n, stream->fp) != n) *error = 1;
+		to_dtype_q31((const q31_t*)stream->raw, buffer, n);
+		break;
+	}
+	if (*error) return 0;
+
+	stream->remain -= frames;
+	return frames;
+}
+
+static void stream_reader(void* arg)
+{
+	stream_handle stream = (stream_handle)arg;
+	size_t frames;
+	int w = 0, error = 0;
+
+	for (;;)
+	{
+		sync_lock(stream->sync);
+		while (stream->full[w] && !stream->quit) sync_wait(stream->sync);
+		if (stream->quit)
+		{
+			sync_unlock(stream->sync);
+			return;
+		}
+		sync_unlock(stream->sync);
+
+		frames = stream_fill(stream, stream->buffer[w], &error); // no lock held while reading
+
+		sync_lock(stream->sync);
+		stream->frames[w] = frames;
+		stream->full[w] = 1;
+		stream->error = error; // published with the chunk
+		sync_broadcast(stream->sync);
+		sync_unlock(stream->sync);
+
+		if (frames == 0) return; // end of file (or error), an empty chunk marks it
+		w ^= 1;
+	}
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          STREAM
+*******************************************************************************/
+stream_handle stream_open(char* file_name, const size_t chunk, const size_t channels, const char token, const type_t data_type)
+{
+	/*
+	* Arguments
+	- chunk : Frames per chunk, 0 selects STREAM_DEFAULT_CHUNK
+	- channels : Interleaved channels of a text file, ignored for signal files
+	- token, data_type : Text format as in read_data_file, ignored for signal files
+
+	Description
+	-	Opens the file and starts the reader thread.
+		Returns NULL on failure.
+	*/
+
+	stream_handle stream;
+	signal_header_t header;
+	char magic[4];
+	FILE* fp;
+	int i;
+
+	if ((stream = (stream_handle)calloc(1, sizeof(fa_stream_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	stream->chunk = chunk ? chunk : STREAM_DEFAULT_CHUNK;
+
+	// signal file if the name opens as is and starts with the magic
+	if ((fp = fopen(file_name, "rb")) != NULL && fread(magic, 1, 4, fp) == 4 && memcmp(magic, SIGNAL_MAGIC, 4) == 0)
+	{
+		fclose(fp);
+		if (read_signal_header(file_name, &header) < 0 || (stream->fp = fopen(file_name, "rb")) == NULL
+			|| file_seek(stream->fp, (int64_t)header.data_offset, SEEK_SET) < 0)
+		{
+			stream_close(stream);
+			return NULL;
+		}
+		stream->binary = 1;
+		stream->elem = (elem_t)header.elem;
+		stream->channels = header.channels;
+		stream->sample_rate = header.sample_rate;
+		stream->remain = header.length;
+	}
+	else
+	{
+		if (fp) fclose(fp);
+		if (channels == 0 || text_elem(data_type) == ELEM_UNKNOWN) // the check read_data_chunk makes
+		{
+			fprintf(stderr, "stream_open : invalid channel count or data type\n");
+			stream_close(stream);
+			return NULL;
+		}
+		if ((stream->fp = open_data_file(file_name, "rb")) == NULL)
+		{
+			stream_close(stream);
+			return NULL;
+		}
+		stream->elem = text_elem(data_type);
+		stream->channels = channels;
+		stream->token = token;
+		stream->data_type = data_type;
+	}
+
+	for (i = 0; i < 2; i++)
+	{
+		if ((stream->buffer[i] = (dtype*)fa_aligned_malloc(sizeof(dtype) * stream->chunk * stream->channels)) == NULL)
+		{
+			stream_close(stream);
+			return NULL;
+		}
+	}
+	if ((stream->scratch = (dtype*)fa_aligned_malloc(sizeof(dtype) * stream->chunk)) == NULL
+		|| (stream->binary && stream->elem != ELEM_F64
+			&& (stream->raw = fa_aligned_malloc(elem_size(stream->elem) * stream->chunk * stream->channels)) == NULL)
+		|| (stream->sync = sync_create()) == NULL
+		|| (stream->reader = thread_start(stream_reader, stream)) == NULL)
+	{
+		stream_close(stream);
+		return NULL;
+	}
+
+	return stream;
+}
+
+void stream_close(stream_handle stream)
+{
+	/* stops the reader (also in the middle of the file) and frees the stream */
+
+	if (stream == NULL) return;
+
+	if (stream->reader)
+	{
+		sync_lock(stream->sync);
+		stream->quit = 1;
+		sync_broadcast(stream->sync);
+		sync_unlock(stream->sync);
+		thread_join(stream->reader);
+	}
+
+	sync_destroy(stream->sync);
+	if (stream->fp) fclose(stream->fp);
+	fa_aligned_free(stream->buffer[0]);
+	fa_aligned_free(stream->buffer[1]);
+	fa_aligned_free(stream->raw);
+	fa_aligned_free(stream->scratch);
+	free(stream);
+}
+
+size_t stream_channels(const stream_handle stream)
+{
+	return stream->channels;
+}
+
+double stream_sample_rate(const stream_handle stream)
+{
+	return stream->sample_rate;
+}
+
+int stream_error(const stream_handle stream)
+{
+	/* set by the reader thread, read under the lock that publishes its chunks */
+
+	int error;
+
+	sync_lock(stream->sync);
+	error = stream->error;
+	sync_unlock(stream->sync);
+	return error;
+}
+
+const dtype* stream_acquire(stream_handle stream, size_t* frames)
+{
+	/*
+	Description
+	-	Waits for the next chunk and lends it to the caller until stream_release.
+		Returns NULL with *frames = 0 at the end of the stream.
+	*/
+
+	const int r = stream->current;
+
+	if (stream->eof)
+	{
+		*frames = 0;
+		return NULL;
+	}
+
+	sync_lock(stream->sync);
+	while (!stream->full[r]) sync_wait(stream->sync);
+	sync_unlock(stream->sync);
+
+	*frames = stream->frames[r];
+	if (*frames == 0)
+	{
+		stream->eof = 1;
+		return NULL;
+	}
+	return stream->buffer[r];
+}
+
+void stream_release(stream_handle stream)
+{
+	/* gives the acquired chunk back to the reader */
+
+	const int r = stream->current;
+
+	sync_lock(stream->sync);
+	stream->full[r] = 0;
+	sync_broadcast(stream->sync);
+	sync_unlock(stream->sync);
+
+	stream->current = r ^ 1;
+}
+
+size_t stream_push(stream_handle stream, fa_handle* rings)
+{
+	/*
+	* Arguments
+	- rings : One fast array per channel
+
+	Description
+	-	Pushes the next chunk into the rings (channel c into rings[c])
+		and returns the number of frames pushed, 0 at the end of the stream.
+		The newest window of each ring stays contiguous at fa_window.
+	*/
+
+	const dtype* chunk;
+	size_t frames, c, n;
+	const size_t channels = stream->channels;
+
+	if ((chunk = stream_acquire(stream, &frames)) == NULL) return 0;
+
+	if (channels == 1)
+	{
+		push_block_fa(rings[0], chunk, frames);
+	}
+	else
+	{
+		for (c = 0; c < channels; c++)
+		{
+			for (n = 0; n < frames; n++) stream->scratch[n] = chunk[n * channels + c];
+			push_block_fa(rings[c], stream->scratch, frames);
+		}
+	}
+
+	stream_release(stream);
+	return frames;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include "fast_array.h"
+#include "util.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          STREAMING SOURCE
+*******************************************************************************/
+/*
+* A stream reads a file chunk by chunk on a background thread into two
+* chunk buffers (double buffering) : while the caller processes one chunk
+* the next one is read. Binary signal files (util.h) are detected by their
+* header, anything else is read as token separated text.
+* Samples come out as dtype with one scaling for both formats : floats as
+* they are, q15 / int16 / short (and ushort) as value / 2^15, q31 / int32 /
+* int (and uint) as value / 2^31, the Q15 / Q31 fractions of typed.h.
+* Memory use is two chunks, independent of the file size.
+*/
+#define STREAM_DEFAULT_CHUNK 4096 // frames per chunk
+
+typedef struct _fa_stream
+{
+	FILE* fp;
+	int binary;				// 1 : signal file, 0 : text
+	elem_t elem;			// element type in the file
+	size_t channels;
+	double sample_rate;		// 0 for text
+	uint64_t remain;		// binary : frames left in the file
+	char token;				// text : separator
+	type_t data_type;		// text : element type string
+
+	size_t chunk;			// frames per chunk
+	dtype* buffer[2];		// chunk * channels samples each
+	size_t frames[2];		// frames in each buffer
+	int full[2];			// 1 : filled by the reader, 0 : free
+	void* raw;				// binary non dtype : raw elements of one chunk
+	dtype* scratch;			// one channel of a chunk
+	int current;			// buffer handed to the caller next
+	int eof, error, quit;
+
+	fa_sync sync;
+	fa_thread reader;
+} fa_stream_t;
+
+typedef fa_stream_t* stream_handle;
+
+stream_handle stream_open(char* file_name, const size_t chunk, const size_t channels, const char token, const type_t data_type);
+void stream_close(stream_handle stream);
+size_t stream_channels(const stream_handle stream);
+double stream_sample_rate(const stream_handle stream);
+int stream_error(const stream_handle stream);
+
+const dtype* stream_acquire(stream_handle stream, size_t* frames);
+void stream_release(stream_handle stream);
+size_t stream_push(stream_handle stream, fa_handle* rings);
+
+/* wrapper function : stream */
+#define fa_stream_push stream_push
+
+#endif
@@ -0,0 +1,652 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Number <-> text conversion for the .dat / .txt data files.
+** Numbers are scanned by hand from one large buffer and formatted
+** into one output buffer, instead of one fscanf / fprintf per element.
+** Doubles and floats are written with digits that always read back to
+** the same value (Grisu2), shortest in almost every case, floats in
+** float precision.
+*/
+
+#include "text.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int parse_diy(const uint64_t mant, const int exp10, double* out);
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          PARSER
+*******************************************************************************/
+static const double exact_pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+double parse_double(const char* p, const char** end)
+{
+	/*
+	Description
+	-	Decimal number with optional sign, fraction and exponent.
+		Up to 19 significant digits with a decimal exponent in [-22, 22] and
+		a mantissa below 2^53 are converted exactly with one multiply or divide
+		(Clinger's fast path). Other mantissas of up to 19 digits are scaled with
+		the 64 bit cached powers of the formatter and accepted when the error
+		bound cannot change the rounding (parse_diy). What is left (more digits,
+		results near a rounding boundary, subnormals, inf / nan) goes to strtod,
+		so the result is always correctly rounded.
+		*end is p when no number was found.
+	*/
+
+	const char* s = p;
+	uint64_t mant = 0;
+	int neg = 0, digits = 0, exp10 = 0, e = 0, eneg = 0, any = 0;
+	double v;
+	char* strtod_end;
+
+	if (*s == '-') neg = 1, s++;
+	else if (*s == '+') s++;
+
+	while (*s >= '0' && *s <= '9')
+	{
+		if (digits < 19) mant = mant * 10 + (uint64_t)(*s - '0'), digits += (mant != 0);
+		else exp10++;
+		s++, any = 1;
+	}
+	if (*s == '.')
+	{
+		s++;
+		while (*s >= '0' && *s <= '9')
+		{
+			if (digits < 19) mant = mant * 10 + (uint64_t)(*s - '0'), digits += (mant != 0), exp10--;
+			s++, any = 1;
+		}
+	}
+	if (!any) goto slow; // inf, nan or no number
+
+	if (*s == 'e' || *s == 'E')
+	{
+		const char* t = s + 1;
+
+		if (*t == '-') eneg = 1, t++;
+		else if (*t == '+') t++;
+		if (*t >= '0' && *t <= '9')
+		{
+			while (*t >= '0' && *t <= '9')
+			{
+				if (e < 100000) e = e * 10 + (*t - '0');
+				t++;
+			}
+			s = t;
+			exp10 += eneg ? -e : e;
+		}
+	}
+
+	if (digits >= 19) goto slow;
+
+	if (mant == 0) v = 0;
+	else if (mant < ((uint64_t)1 << 53) && exp10 >= -22 && exp10 <= 22)
+		v = exp10 < 0 ? (double)mant / exact_pow10[-exp10] : (double)mant * exact_pow10[exp10];
+	else if (!parse_diy(mant, exp10, &v)) goto slow;
+
+	*end = s;
+	return neg ? -v : v;
+
+slow:
+	v = strtod(p, &strtod_end);
+	*end = strtod_end;
+	return v;
+}
+
+size_t parse_text(const char* text, const size_t length, dtype* arr, const size_t size, const char token, size_t* consumed)
+{
+	/*
+	* Arguments
+	- text : Buffer of length bytes, text[length] must be readable and not a digit (e.g. '\0')
+	- consumed : Bytes used by the returned values (may be NULL)
+
+	Description
+	-	Reads up to size values separated by token and / or white space,
+		the same input fscanf("%lf<token>") accepts. Stops at the first
+		character that is not a number.
+	*/
+
+	const char* p = text, * limit = text + length, * next;
+	size_t n = 0;
+	PROF_BEGIN(PROF_PARSE);
+
+	while (n < size)
+	{
+		while (p < limit && text_separator(*p, token)) p++;
+		if (p >= limit) break;
+
+		arr[n] = (dtype)parse_double(p, &next);
+		if (next == p || next > limit) break;
+		p = next, n++;
+	}
+
+	if (consumed) *consumed = (size_t)(p - text);
+	PROF_END(PROF_PARSE, p - text);
+	return n;
+}
+
+size_t count_text(const char* text, const size_t length, const char token)
+{
+	/* number of separator delimited fields */
+
+	size_t i, n = 0;
+	int in_field = 0, sep;
+
+	for (i = 0; i < length; i++)
+	{
+		sep = text_separator(text[i], token);
+		n += (!sep && !in_field);
+		in_field = !sep;
+	}
+	return n;
+}
+
+typedef struct _parse_job
+{
+	const char* text;
+	size_t length;
+	dtype* arr;
+	size_t size;
+	char token;
+	const char* cut[TEXT_MAX_THREADS + 1];	// segment bounds, on separators
+	size_t offset[TEXT_MAX_THREADS + 1];	// first value of each segment
+	size_t parsed[TEXT_MAX_THREADS];
+} parse_job_t;
+
+static void parse_count_task(void* arg, int worker, int n_workers)
+{
+	parse_job_t* job = (parse_job_t*)arg;
+	job->offset[worker + 1] = count_text(job->cut[worker], (size_t)(job->cut[worker + 1] - job->cut[worker]), job->token);
+	(void)n_workers;
+}
+
+static void parse_segment_task(void* arg, int worker, int n_workers)
+{
+	parse_job_t* job = (parse_job_t*)arg;
+	size_t first = job->offset[worker], n = job->offset[worker + 1] - first;
+
+	(void)n_workers;
+	if (first >= job->size) { job->parsed[worker] = 0; return; }
+	if (first + n > job->size) n = job->size - first;
+	job->parsed[worker] = parse_text(job->cut[worker], (size_t)(job->cut[worker + 1] - job->cut[worker]), job->arr + first, n, job->token, NULL);
+}
+
+size_t parse_text_parallel(const char* text, const size_t length, dtype* arr, const size_t size, const char token, int n_threads)
+{
+	/*
+	* Arguments
+	- n_threads : Worker count, <= 0 selects cpu_count()
+
+	Description
+	-	parse_text over TEXT_PARALLEL_MIN bytes and more split into segments
+		that end on a separator. Each worker counts the fields of its segment,
+		the prefix sum gives the output offset, then all segments are parsed
+		at once. Falls back to parse_text for small inputs or one worker.
+	*/
+
+	parse_job_t job;
+	fa_pool pool;
+	size_t total = 0, i;
+	int w;
+
+	if (n_threads <= 0) n_threads = cpu_count();
+	if (n_threads > TEXT_MAX_THREADS) n_threads = TEXT_MAX_THREADS;
+	if (n_threads < 2 || length < TEXT_PARALLEL_MIN || (pool = pool_create(n_threads)) == NULL)
+		return parse_text(text, length, arr, size, token, NULL);
+	n_threads = pool_size(pool);
+
+	job.text = text, job.length = length, job.arr = arr, job.size = size, job.token = token;
+	job.cut[0] = text;
+	job.cut[n_threads] = text + length;
+	for (w = 1; w < n_threads; w++)
+	{
+		i = length * w / n_threads;
+		while (i < length && !text_separator(text[i], token)) i++; // never split a number
+		job.cut[w] = text + i;
+		if (job.cut[w] < job.cut[w - 1]) job.cut[w] = job.cut[w - 1];
+	}
+
+	job.offset[0] = 0;
+	pool_run(pool, parse_count_task, &job);
+	for (w = 0; w < n_threads; w++) job.offset[w + 1] += job.offset[w];
+
+	pool_run(pool, parse_segment_task, &job);
+	pool_destroy(pool);
+
+	for (w = 0; w < n_threads; w++)
+	{
+		total += job.parsed[w];
+		if (job.offset[w] + job.parsed[w] < job.offset[w + 1] && job.offset[w] + job.parsed[w] < size) break; // stopped early
+	}
+	return total;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          SHORTEST ROUND TRIP FORMAT (GRISU2)
+*******************************************************************************/
+/*
+* Grisu2 (Loitsch, "Printing floating-point numbers quickly and accurately
+* with integers") : a 64 bit "do it yourself" float and a table of cached
+* powers of ten. The digits always read back to the input and are the
+* shortest possible in all but a few rare cases.
+* cached_power, grisu_round, digit_gen, prettify and write_exponent follow
+* dtoa_milo.h by Milo Yip :
+*
+* Copyright (C) 2014 Milo Yip
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+typedef struct _diy_fp
+{
+	uint64_t f;
+	int e;
+} diy_fp;
+
+static const uint64_t cached_pow_f[] = {
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+	0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+	0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+	0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+	0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+	0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+	0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+	0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+	0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+	0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+	0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+	0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+	0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+	0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+	0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const int16_t cached_pow_e[] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066
+};
+
+static const uint32_t pow10_u32[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+static diy_fp diy_mul(const diy_fp a, const diy_fp b)
+{
+	/* upper 64 bits of the 128 bit product, rounded */
+
+	const uint64_t m32 = 0xFFFFFFFFULL;
+	const uint64_t ah = a.f >> 32, al = a.f & m32, bh = b.f >> 32, bl = b.f & m32;
+	const uint64_t hh = ah * bh, lh = al * bh, hl = ah * bl, ll = al * bl;
+	uint64_t mid = (ll >> 32) + (hl & m32) + (lh & m32);
+	diy_fp r;
+
+	mid += 1U << 31;
+	r.f = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+	r.e = a.e + b.e + 64;
+	return r;
+}
+
+static diy_fp diy_normalize(diy_fp x)
+{
+	/* x.f != 0 */
+
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long msb;
+	int shift;
+
+	_BitScanReverse64(&msb, x.f);
+	shift = 63 - (int)msb;
+#elif defined(__GNUC__) || defined(__clang__)
+	const int shift = __builtin_clzll(x.f);
+#else
+	int shift = 0;
+
+	while (!((x.f << shift) & 0x8000000000000000ULL)) shift++;
+#endif
+	x.f <<= shift;
+	x.e -= shift;
+	return x;
+}
+
+static diy_fp cached_power(const int e, int* k)
+{
+	/* c = 10^-k such that the product with a normalized w of exponent e lands in [-60, -32] */
+
+	const double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int kk = (int)dk, index;
+	diy_fp c;
+
+	if (dk - kk > 0.0) kk++;
+	index = (kk >> 3) + 1;
+	*k = -(-348 + index * 8);
+	c.f = cached_pow_f[index];
+	c.e = cached_pow_e[index];
+	return c;
+}
+
+static int parse_diy(const uint64_t mant, const int exp10, double* out)
+{
+	/*
+	* mant * 10^exp10 as a 64 bit diy_fp : 10^exp10 = 10^k (cached) * 10^r (exact, r < 8).
+	* The product is off by at most a few units of the 64 bit mantissa, so the
+	* 53 bit rounding is safe unless the 11 dropped bits are within
+	* PARSE_DIY_ERROR of one half. Returns 0 when the caller must use strtod.
+	*/
+
+	static const uint64_t small_pow10[] = {
+		0x8000000000000000ULL, 0xa000000000000000ULL, 0xc800000000000000ULL, 0xfa00000000000000ULL,
+		0x9c40000000000000ULL, 0xc350000000000000ULL, 0xf424000000000000ULL, 0x9896800000000000ULL
+	};
+	static const int small_pow10_e[] = { -63, -60, -57, -54, -50, -47, -44, -40 };
+	diy_fp x, c;
+	uint64_t low, m53;
+	int index, e2;
+
+	if (exp10 < -348 || exp10 > 340 - 8) return 0;
+
+	index = (exp10 + 348) / 8;
+	x.f = mant, x.e = 0;
+	x = diy_normalize(x);
+
+	c.f = small_pow10[exp10 + 348 - 8 * index], c.e = small_pow10_e[exp10 + 348 - 8 * index];
+	x = diy_normalize(diy_mul(x, c));
+	c.f = cached_pow_f[index], c.e = cached_pow_e[index];
+	x = diy_normalize(diy_mul(x, c));
+
+	low = x.f & 0x7FF;
+	if (low + PARSE_DIY_ERROR >= 0x400 && low <= 0x400 + PARSE_DIY_ERROR) return 0; // too close to a tie
+
+	m53 = (x.f >> 11) + (low > 0x400);
+	e2 = x.e + 11;
+	if (m53 == ((uint64_t)1 << 53)) m53 >>= 1, e2++;
+	if (e2 + 52 > 1023 || e2 + 52 < -1022) return 0; // overflow or subnormal
+
+	*out = ldexp((double)m53, e2);
+	return 1;
+}
+
+static void grisu_round(char* buffer, const int len, const uint64_t delta, uint64_t rest, const uint64_t ten_kappa, const uint64_t wp_w)
+{
+	while (rest < wp_w && delta - rest >= ten_kappa && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+	{
+		buffer[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+static int count_digits_u32(const uint32_t n)
+{
+	int d = 1;
+	while (d < 10 && n >= pow10_u32[d]) d++;
+	return d;
+}
+
+static void digit_gen(const diy_fp w, const diy_fp mp, uint64_t delta, char* buffer, int* len, int* k)
+{
+	const diy_fp one = { (uint64_t)1 << -mp.e, mp.e };
+	const uint64_t wp_w = mp.f - w.f;
+	uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+	uint64_t p2 = mp.f & (one.f - 1), tmp;
+	int kappa = count_digits_u32(p1), d;
+
+	*len = 0;
+	while (kappa > 0)
+	{
+		switch (kappa) // constant divisors, a variable one costs a real division per digit
+		{
+		case 10: d = (int)(p1 / 1000000000); p1 %= 1000000000; break;
+		case 9: d = (int)(p1 / 100000000); p1 %= 100000000; break;
+		case 8: d = (int)(p1 / 10000000); p1 %= 10000000; break;
+		case 7: d = (int)(p1 / 1000000); p1 %= 1000000; break;
+		case 6: d = (int)(p1 / 100000); p1 %= 100000; break;
+		case 5: d = (int)(p1 / 10000); p1 %= 10000; break;
+		case 4: d = (int)(p1 / 1000); p1 %= 1000; break;
+		case 3: d = (int)(p1 / 100); p1 %= 100; break;
+		case 2: d = (int)(p1 / 10); p1 %= 10; break;
+		default: d = (int)p1; p1 = 0; break;
+		}
+		if (d || *len) buffer[(*len)++] = (char)('0' + d);
+		kappa--;
+		tmp = ((uint64_t)p1 << -one.e) + p2;
+		if (tmp <= delta)
+		{
+			*k += kappa;
+			grisu_round(buffer, *len, delta, tmp, (uint64_t)pow10_u32[kappa] << -one.e, wp_w);
+			return;
+		}
+	}
+
+	for (;;)
+	{
+		p2 *= 10;
+		delta *= 10;
+		d = (int)(p2 >> -one.e);
+		if (d || *len) buffer[(*len)++] = (char)('0' + d);
+		p2 &= one.f - 1;
+		kappa--;
+		if (p2 < delta)
+		{
+			*k += kappa;
+			grisu_round(buffer, *len, delta, p2, one.f, wp_w * (-kappa < 10 ? pow10_u32[-kappa] : 0));
+			return;
+		}
+	}
+}
+
+static void grisu2(const uint64_t f, const int e, const int lower_closer, char* buffer, int* len, int* k)
+{
+	/* f * 2^e > 0 with its neighbours : upper boundary at + half ulp, lower at - half ulp (- quarter at a power of two) */
+
+	diy_fp v, plus, minus, c, w, wp, wm;
+
+	v.f = f, v.e = e;
+	plus.f = (f << 1) + 1, plus.e = e - 1;
+	plus = diy_normalize(plus);
+	if (lower_closer) minus.f = (f << 2) - 1, minus.e = e - 2;
+	else minus.f = (f << 1) - 1, minus.e = e - 1;
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+
+	c = cached_power(plus.e, k);
+	w = diy_mul(diy_normalize(v), c);
+	wp = diy_mul(plus, c);
+	wm = diy_mul(minus, c);
+	wm.f++;
+	wp.f--;
+	digit_gen(w, wp, wp.f - wm.f, buffer, len, k);
+}
+
+static int write_exponent(int k, char* out)
+{
+	char* p = out;
+
+	if (k < 0) *p++ = '-', k = -k;
+	if (k >= 100) *p++ = (char)('0' + k / 100), k %= 100, *p++ = (char)('0' + k / 10), *p++ = (char)('0' + k % 10);
+	else if (k >= 10) *p++ = (char)('0' + k / 10), *p++ = (char)('0' + k % 10);
+	else *p++ = (char)('0' + k);
+	return (int)(p - out);
+}
+
+static int prettify(char* buffer, const int len, const int k)
+{
+	/* digits d1..dn * 10^k to plain or exponent notation, returns the length */
+
+	const int kk = len + k; // 10^(kk - 1) <= v < 10^kk
+	int i;
+
+	if (len <= kk && kk <= 21) // 1234e7 -> 12340000000
+	{
+		for (i = len; i < kk; i++) buffer[i] = '0';
+		return kk;
+	}
+	if (0 < kk && kk <= 21) // 1234e-2 -> 12.34
+	{
+		memmove(buffer + kk + 1, buffer + kk, (size_t)(len - kk));
+		buffer[kk] = '.';
+		return len + 1;
+	}
+	if (-6 < kk && kk <= 0) // 1234e-6 -> 0.001234
+	{
+		const int offset = 2 - kk;
+		memmove(buffer + offset, buffer, (size_t)len);
+		buffer[0] = '0';
+		buffer[1] = '.';
+		for (i = 2; i < offset; i++) buffer[i] = '0';
+		return len + offset;
+	}
+	if (len == 1) // 1e30
+	{
+		buffer[1] = 'e';
+		return 2 + write_exponent(kk - 1, buffer + 2);
+	}
+	memmove(buffer + 2, buffer + 1, (size_t)(len - 1)); // 1234e30 -> 1.234e33
+	buffer[1] = '.';
+	buffer[len + 1] = 'e';
+	return len + 2 + write_exponent(kk - 1, buffer + len + 2);
+}
+
+static int format_special(char* out, const double v)
+{
+	if (v != v) { memcpy(out, "nan", 3); return 3; }
+	if (v > 0) { memcpy(out, "inf", 3); return 3; }
+	memcpy(out, "-inf", 4);
+	return 4;
+}
+
+int format_double(char* out, const double v)
+{
+	/*
+	Description
+	-	Text that parses back to v, at most TEXT_MAX_CHARS bytes, not terminated.
+		The shortest such text except in rare cases (Grisu2). Returns the length.
+	*/
+
+	uint64_t bits, f;
+	int e, len, k, neg;
+
+	memcpy(&bits, &v, sizeof(bits));
+	neg = (int)(bits >> 63);
+	e = (int)((bits >> 52) & 0x7FF);
+	f = bits & 0xFFFFFFFFFFFFFULL;
+
+	if (e == 0x7FF) return format_special(out, v);
+	if (e == 0 && f == 0)
+	{
+		if (neg) { out[0] = '-', out[1] = '0'; return 2; }
+		out[0] = '0';
+		return 1;
+	}
+
+	if (neg) *out++ = '-';
+	if (e) grisu2(f | 0x10000000000000ULL, e - 1075, f == 0 && e > 1, out, &len, &k);
+	else grisu2(f, -1074, 0, out, &len, &k);
+
+	return neg + prettify(out, len, k);
+}
+
+int format_float(char* out, const float v)
+{
+	/* same as format_double with the neighbours of v in float precision */
+
+	uint32_t bits, f;
+	int e, len, k, neg;
+
+	memcpy(&bits, &v, sizeof(bits));
+	neg = (int)(bits >> 31);
+	e = (int)((bits >> 23) & 0xFF);
+	f = bits & 0x7FFFFF;
+
+	if (e == 0xFF) return format_special(out, v);
+	if (e == 0 && f == 0)
+	{
+		if (neg) { out[0] = '-', out[1] = '0'; return 2; }
+		out[0] = '0';
+		return 1;
+	}
+
+	if (neg) *out++ = '-';
+	if (e) grisu2(f | 0x800000, e - 150, f == 0 && e > 1, out, &len, &k);
+	else grisu2(f, -149, 0, out, &len, &k);
+
+	return neg + prettify(out, len, k);
+}
+
+int format_int(char* out, const long long v)
+{
+	char digits[24];
+	unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+	int n = 0, len = 0;
+
+	do digits[n++] = (char)('0' + u % 10), u /= 10; while (u);
+	if (v < 0) out[len++] = '-';
+	while (n) out[len++] = digits[--n];
+	return len;
+}
+
+size_t format_text(char* text, const dtype* arr, const size_t size, const char token, const elem_t type)
+{
+	/*
+	* Arguments
+	- text : Output of at least size * (TEXT_MAX_CHARS + 1) bytes
+	- type : ELEM_F64 / ELEM_F32 round trip in that precision,
+			 ELEM_Q15 / ELEM_Q31 values rounded to integers
+
+	Description
+	-	Every value is followed by token, as write_data_file does.
+		Returns the number of bytes written.
+	*/
+
+	char* p = text;
+	size_t i;
+	PROF_BEGIN(PROF_FORMAT);
+
+	for (i = 0; i < size; i++)
+	{
+		switch (type)
+		{
+		case ELEM_F32: p += format_float(p, (float)arr[i]); break;
+		case ELEM_Q15:
+		case ELEM_Q31: p += format_int(p, (long long)floor(arr[i] + 0.5)); break;
+		default: p += format_double(p, (double)arr[i]); break;
+		}
+		*p++ = token;
+	}
+	PROF_END(PROF_FORMAT, size);
+	return (size_t)(p - text);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#ifndef __TEXT_H__
+#define __TEXT_H__
+
+#include "common.h"
+#include "thread.h"
+#include "prof.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          NUMBER TEXT CONVERSION
+*******************************************************************************/
+#define TEXT_MAX_CHARS 32				// longest formatted number
+#define TEXT_PARALLEL_MIN (4 << 20)		// bytes, smaller inputs are parsed on one thread
+#define TEXT_MAX_THREADS 64
+#define PARSE_DIY_ERROR 8				// error bound of the 64 bit parse, in units of the last bit
+
+#define text_separator(c, token) \
+((c) == (token) || (c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+	// white space always separates, like the white space of a scanf format
+
+double parse_double(const char* p, const char** end);
+size_t parse_text(const char* text, const size_t length, dtype* arr, const size_t size, const char token, size_t* consumed);
+size_t parse_text_parallel(const char* text, const size_t length, dtype* arr, const size_t size, const char token, int n_threads);
+size_t count_text(const char* text, const size_t length, const char token);
+
+int format_double(char* out, const double v);
+int format_float(char* out, const float v);
+int format_int(char* out, const long long v);
+size_t format_text(char* text, const dtype* arr, const size_t size, const char token, const elem_t type);
+
+#endif
@@ -0,0 +1,388 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Minimal worker pool used by the multi-channel and bulk kernels.
+** Win32 threads on windows, pthreads everywhere else.
+*/
+
+#ifdef __linux__
+#define _GNU_SOURCE // pthread_setaffinity_np
+#endif
+
+#include "thread.h"
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE thread_t;
+typedef CRITICAL_SECTION mutex_t;
+typedef CONDITION_VARIABLE cond_t;
+#define mutex_init(m) InitializeCriticalSection(m)
+#define mutex_destroy(m) DeleteCriticalSection(m)
+#define mutex_lock(m) EnterCriticalSection(m)
+#define mutex_unlock(m) LeaveCriticalSection(m)
+#define cond_init(c) InitializeConditionVariable(c)
+#define cond_destroy(c)
+#define cond_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define cond_signal(c) WakeConditionVariable(c)
+#define cond_broadcast(c) WakeAllConditionVariable(c)
+#else
+#include <pthread.h>
+#include <unistd.h>
+typedef pthread_t thread_t;
+typedef pthread_mutex_t mutex_t;
+typedef pthread_cond_t cond_t;
+#define mutex_init(m) pthread_mutex_init(m, NULL)
+#define mutex_destroy(m) pthread_mutex_destroy(m)
+#define mutex_lock(m) pthread_mutex_lock(m)
+#define mutex_unlock(m) pthread_mutex_unlock(m)
+#define cond_init(c) pthread_cond_init(c, NULL)
+#define cond_destroy(c) pthread_cond_destroy(c)
+#define cond_wait(c, m) pthread_cond_wait(c, m)
+#define cond_signal(c) pthread_cond_signal(c)
+#define cond_broadcast(c) pthread_cond_broadcast(c)
+#endif
+
+typedef struct _pool_worker
+{
+	struct _fa_pool* pool;
+	int id;
+	thread_t thread;
+} pool_worker_t;
+
+struct _fa_pool
+{
+	int n_workers;				// including the caller
+	pool_worker_t* workers;		// n_workers - 1 threads
+	mutex_t lock;
+	cond_t start, done;
+	pool_task_t task;
+	void* arg;
+	unsigned long generation;	// incremented by every pool_run
+	int pending;				// workers still running the current task
+	int quit;
+};
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          WORKER POOL
+*******************************************************************************/
+int cpu_count(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#endif
+}
+
+static void pool_worker_loop(pool_worker_t* self)
+{
+	struct _fa_pool* pool = self->pool;
+	unsigned long seen = 0;
+	pool_task_t task;
+	void* arg;
+
+	for (;;)
+	{
+		mutex_lock(&pool->lock);
+		while (pool->generation == seen && !pool->quit) cond_wait(&pool->start, &pool->lock);
+		if (pool->quit)
+		{
+			mutex_unlock(&pool->lock);
+			return;
+		}
+		seen = pool->generation;
+		task = pool->task;
+		arg = pool->arg;
+		mutex_unlock(&pool->lock);
+
+		task(arg, self->id, pool->n_workers);
+
+		mutex_lock(&pool->lock);
+		if (--pool->pending == 0) cond_signal(&pool->done);
+		mutex_unlock(&pool->lock);
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI pool_thread_main(LPVOID arg)
+{
+	pool_worker_loop((pool_worker_t*)arg);
+	return 0;
+}
+#else
+static void* pool_thread_main(void* arg)
+{
+	pool_worker_loop((pool_worker_t*)arg);
+	return NULL;
+}
+#endif
+
+fa_pool pool_create(int n_workers)
+{
+	/*
+	* Arguments
+	- n_workers : Number of workers including the calling thread, <= 0 selects cpu_count()
+
+	Description
+	-	Starts n_workers - 1 threads that sleep until pool_run.
+		Returns NULL on failure.
+	*/
+
+	fa_pool pool;
+	int i, started = 0;
+
+	if (n_workers <= 0) n_workers = cpu_count();
+
+	if ((pool = (fa_pool)calloc(1, sizeof(struct _fa_pool))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	pool->n_workers = n_workers;
+
+	if (n_workers > 1 && (pool->workers = (pool_worker_t*)calloc(n_workers - 1, sizeof(pool_worker_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		free(pool);
+		return NULL;
+	}
+
+	mutex_init(&pool->lock);
+	cond_init(&pool->start);
+	cond_init(&pool->done);
+
+	for (i = 0; i < n_workers - 1; i++, started++)
+	{
+		pool->workers[i].pool = pool;
+		pool->workers[i].id = i + 1;
+#ifdef _WIN32
+		pool->workers[i].thread = CreateThread(NULL, 0, pool_thread_main, &pool->workers[i], 0, NULL);
+		if (pool->workers[i].thread == NULL) break;
+#else
+		if (pthread_create(&pool->workers[i].thread, NULL, pool_thread_main, &pool->workers[i]) != 0) break;
+#endif
+	}
+
+	if (started != n_workers - 1)
+	{
+		fprintf(stderr, "pool_create : Thread Creation Error!\n");
+		pool->n_workers = started + 1;
+		pool_destroy(pool);
+		return NULL;
+	}
+
+	return pool;
+}
+
+void pool_destroy(fa_pool pool)
+{
+	int i;
+
+	if (pool == NULL) return;
+
+	mutex_lock(&pool->lock);
+	pool->quit = 1;
+	cond_broadcast(&pool->start);
+	mutex_unlock(&pool->lock);
+
+	for (i = 0; i < pool->n_workers - 1; i++)
+	{
+#ifdef _WIN32
+		WaitForSingleObject(pool->workers[i].thread, INFINITE);
+		CloseHandle(pool->workers[i].thread);
+#else
+		pthread_join(pool->workers[i].thread, NULL);
+#endif
+	}
+
+	cond_destroy(&pool->start);
+	cond_destroy(&pool->done);
+	mutex_destroy(&pool->lock);
+	free(pool->workers);
+	free(pool);
+}
+
+void pool_run(fa_pool pool, pool_task_t task, void* arg)
+{
+	/*
+	Description
+	-	Runs task(arg, worker, n_workers) on every worker and waits for all of them.
+		The calling thread runs worker 0.
+	*/
+
+	if (pool == NULL || pool->n_workers == 1)
+	{
+		task(arg, 0, 1);
+		return;
+	}
+
+	mutex_lock(&pool->lock);
+	pool->task = task;
+	pool->arg = arg;
+	pool->pending = pool->n_workers - 1;
+	pool->generation++;
+	cond_broadcast(&pool->start);
+	mutex_unlock(&pool->lock);
+
+	task(arg, 0, pool->n_workers);
+
+	mutex_lock(&pool->lock);
+	while (pool->pending > 0) cond_wait(&pool->done, &pool->lock);
+	mutex_unlock(&pool->lock);
+}
+
+int pool_size(const fa_pool pool)
+{
+	return pool ? pool->n_workers : 1;
+}
+
+static void pool_pin_task(void* arg, int worker, int n_workers)
+{
+	/* worker w > 0 on cpu w * cpus / n_workers, the calling thread (worker 0) is left alone */
+
+	const int cpus = cpu_count(), cpu = (int)((long long)worker * cpus / n_workers);
+
+	(void)arg;
+	if (worker == 0) return;
+#if defined(_WIN32)
+	if (cpu < 64) SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+#elif defined(__linux__)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	}
+#else
+	(void)cpu;
+#endif
+}
+
+void pool_pin(fa_pool pool)
+{
+	/*
+	Description
+	-	Pins worker w of the pool to cpu w * cpu_count() / n_workers, so a worker keeps
+		its cpu, and its NUMA node, from one pool_run to the next. Memory first touched
+		by a worker then stays local to it. Best effort : silently a no-op where the
+		affinity call is not available.
+	*/
+
+	if (pool == NULL || pool->n_workers == 1) return;
+	pool_run(pool, pool_pin_task, NULL);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          THREAD AND SYNCHRONIZATION
+*******************************************************************************/
+struct _fa_thread
+{
+	thread_t thread;
+	void (*entry)(void* arg);
+	void* arg;
+};
+
+struct _fa_sync
+{
+	mutex_t lock;
+	cond_t cond;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI thread_main(LPVOID arg)
+{
+	((struct _fa_thread*)arg)->entry(((struct _fa_thread*)arg)->arg);
+	return 0;
+}
+#else
+static void* thread_main(void* arg)
+{
+	((struct _fa_thread*)arg)->entry(((struct _fa_thread*)arg)->arg);
+	return NULL;
+}
+#endif
+
+fa_thread thread_start(void (*entry)(void* arg), void* arg)
+{
+	fa_thread thread;
+
+	if ((thread = (fa_thread)calloc(1, sizeof(struct _fa_thread))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	thread->entry = entry;
+	thread->arg = arg;
+
+#ifdef _WIN32
+	if ((thread->thread = CreateThread(NULL, 0, thread_main, thread, 0, NULL)) == NULL)
+#else
+	if (pthread_create(&thread->thread, NULL, thread_main, thread) != 0)
+#endif
+	{
+		fprintf(stderr, "thread_start : Thread Creation Error!\n");
+		free(thread);
+		return NULL;
+	}
+	return thread;
+}
+
+void thread_join(fa_thread thread)
+{
+	if (thread == NULL) return;
+#ifdef _WIN32
+	WaitForSingleObject(thread->thread, INFINITE);
+	CloseHandle(thread->thread);
+#else
+	pthread_join(thread->thread, NULL);
+#endif
+	free(thread);
+}
+
+fa_sync sync_create(void)
+{
+	fa_sync sync;
+
+	if ((sync = (fa_sync)malloc(sizeof(struct _fa_sync))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	mutex_init(&sync->lock);
+	cond_init(&sync->cond);
+	return sync;
+}
+
+void sync_destroy(fa_sync sync)
+{
+	if (sync == NULL) return;
+	cond_destroy(&sync->cond);
+	mutex_destroy(&sync->lock);
+	free(sync);
+}
+
+void sync_lock(fa_sync sync)
+{
+	mutex_lock(&sync->lock);
+}
+
+void sync_unlock(fa_sync sync)
+{
+	mutex_unlock(&sync->lock);
+}
+
+void sync_wait(fa_sync sync)
+{
+	cond_wait(&sync->cond, &sync->lock);
+}
+
+void sync_broadcast(fa_sync sync)
+{
+	cond_broadcast(&sync->cond);
+}
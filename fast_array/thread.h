@@ -0,0 +1,102 @@
+#pragma once
+
+#ifndef __THREAD_H__
+#define __THREAD_H__
+
+#include "common.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          WORKER POOL
+*******************************************************************************/
+/*
+* A pool keeps n - 1 worker threads parked; pool_run wakes them,
+* runs the task on every worker (the caller is worker 0) and returns
+* when all of them are done. One pool runs one task at a time.
+*/
+typedef void (*pool_task_t)(void* arg, int worker, int n_workers);
+
+typedef struct _fa_pool* fa_pool;
+
+fa_pool pool_create(int n_workers);
+void pool_destroy(fa_pool pool);
+void pool_run(fa_pool pool, pool_task_t task, void* arg);
+int pool_size(const fa_pool pool);
+void pool_pin(fa_pool pool);	// pins the pool threads to cpus spread over the machine
+
+int cpu_count(void);
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          THREAD AND SYNCHRONIZATION
+*******************************************************************************/
+/* a single background thread and a mutex paired with one condition variable */
+typedef struct _fa_thread* fa_thread;
+typedef struct _fa_sync* fa_sync;
+
+fa_thread thread_start(void (*entry)(void* arg), void* arg);
+void thread_join(fa_thread thread);
+
+fa_sync sync_create(void);
+void sync_destroy(fa_sync sync);
+void sync_lock(fa_sync sync);
+void sync_unlock(fa_sync sync);
+void sync_wait(fa_sync sync);		// releases the lock while waiting, call with the lock held
+void sync_broadcast(fa_sync sync);
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          ATOMICS
+*******************************************************************************/
+/* acquire load / release store of a counter shared by two threads (size_t is one machine word) */
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static inline size_t fa_load_acquire(const volatile size_t* p)
+{
+#ifdef _MSC_VER
+	const size_t v = *p; // x86 / x64 loads already have acquire order, the barrier stops the compiler
+	_ReadWriteBarrier();
+	return v;
+#else
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void fa_store_release(volatile size_t* p, const size_t v)
+{
+#ifdef _MSC_VER
+	_ReadWriteBarrier(); // x86 / x64 stores already have release order
+	*p = v;
+#else
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+#endif
+}
+
+/* busy flag shared by several threads : try_lock returns 1 when the caller took it */
+static inline int fa_try_lock(volatile long* flag)
+{
+#ifdef _MSC_VER
+	return _InterlockedCompareExchange(flag, 1, 0) == 0;
+#else
+	long expected = 0;
+	return __atomic_compare_exchange_n(flag, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void fa_unlock(volatile long* flag)
+{
+#ifdef _MSC_VER
+	_ReadWriteBarrier();
+	*flag = 0;
+#else
+	__atomic_store_n(flag, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+/* split [0, n) into n_workers contiguous ranges, range of worker */
+#define pool_range(n, worker, n_workers, begin, end) \
+do { (begin) = (size_t)(n) * (worker) / (n_workers); (end) = (size_t)(n) * ((worker) + 1) / (n_workers); } while (0)
+
+#endif
@@ -0,0 +1,427 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Per thread lock-free binary trace rings, the writer thread
+** that dumps them to a file and the decoder of that file.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+#ifdef __linux__
+#define _GNU_SOURCE // nanosleep under -std=c11
+#endif
+
+#include "trace.h"
+#include "fast_array.h"
+#include "util.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef _MSC_VER
+#define TRACE_THREAD_LOCAL __declspec(thread)
+#else
+#define TRACE_THREAD_LOCAL _Thread_local
+#endif
+
+#define TRACE_MASK (TRACE_RING - 1)
+
+typedef struct _trace_ring
+{
+	/* producer : the traced thread */
+	trace_record_t* rec;
+	volatile size_t head;
+	size_t tail_cache;
+	volatile size_t dropped;	// only the producer writes
+	uint32_t seq;
+	uint16_t id;
+	char pad[FA_ALIGNMENT];		// producer and consumer fields on different cache lines
+
+	/* consumer : the writer thread */
+	volatile size_t tail;
+	size_t dropped_seen;
+	size_t dropped_base;		// dropped at trace_start
+} trace_ring_t;
+
+volatile int trace_on = 0;
+
+static trace_ring_t* volatile trace_rings[TRACE_MAX_THREADS];
+static volatile long trace_n_rings = 0;	// rings handed out, may exceed TRACE_MAX_THREADS
+static TRACE_THREAD_LOCAL trace_ring_t* thread_ring;
+static TRACE_THREAD_LOCAL int thread_ring_none;	// thread came after the TRACE_MAX_THREADS first
+
+static FILE* trace_fp = NULL;
+static fa_thread trace_writer = NULL;
+static volatile size_t trace_quit = 0;
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          BINARY TRACE
+*******************************************************************************/
+static long trace_next_ring(void)
+{
+#ifdef _MSC_VER
+	return _InterlockedIncrement(&trace_n_rings) - 1;
+#else
+	return __atomic_fetch_add(&trace_n_rings, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static long trace_ring_count(void)
+{
+#ifdef _MSC_VER
+	const long n = trace_n_rings;
+	_ReadWriteBarrier();
+#else
+	const long n = __atomic_load_n(&trace_n_rings, __ATOMIC_ACQUIRE);
+#endif
+	return n < TRACE_MAX_THREADS ? n : TRACE_MAX_THREADS;
+}
+
+static trace_ring_t* trace_ring_load(const long id)
+{
+#ifdef _MSC_VER
+	trace_ring_t* ring = trace_rings[id];
+	_ReadWriteBarrier();
+	return ring;
+#else
+	return __atomic_load_n(&trace_rings[id], __ATOMIC_ACQUIRE);
+#endif
+}
+
+static trace_ring_t* trace_ring_create(void)
+{
+	/* first record of the thread : the ring is published once filled, the writer skips empty slots */
+
+	trace_ring_t* ring;
+	long id;
+
+	if ((ring = (trace_ring_t*)fa_aligned_malloc(sizeof(trace_ring_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	memset(ring, 0, sizeof(trace_ring_t));
+	if ((ring->rec = (trace_record_t*)fa_aligned_malloc(sizeof(trace_record_t) * TRACE_RING)) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		fa_aligned_free(ring);
+		return NULL;
+	}
+
+	if ((id = trace_next_ring()) >= TRACE_MAX_THREADS)
+	{
+		fa_aligned_free(ring->rec);
+		fa_aligned_free(ring);
+		return NULL;
+	}
+	ring->id = (uint16_t)id;
+
+#ifdef _MSC_VER
+	_ReadWriteBarrier();
+	trace_rings[id] = ring;
+#else
+	__atomic_store_n(&trace_rings[id], ring, __ATOMIC_RELEASE);
+#endif
+	return ring;
+}
+
+void trace_emit(const trace_kernel_t kernel, const int32_t i, const int32_t j, const double a, const double b, const double sum)
+{
+	/*
+	* Arguments
+	- kernel : Record type
+	- i, j : Indices
+	- a, b, sum : Operands and partial result
+
+	Description
+	-	Appends one record to the ring of the calling thread, called through TRACE.
+		Rings live until the program exits and are reused by the next trace_start.
+		A full ring drops the record, the writer then adds a TRACE_DROPPED record.
+	*/
+
+	trace_ring_t* ring = thread_ring;
+	trace_record_t* r;
+	size_t h;
+
+	if (ring == NULL)
+	{
+		if (thread_ring_none || (ring = thread_ring = trace_ring_create()) == NULL)
+		{
+			thread_ring_none = 1;
+			return;
+		}
+	}
+
+	h = ring->head; // only this thread writes head
+	if (h - ring->tail_cache >= TRACE_RING)
+	{
+		ring->tail_cache = fa_load_acquire(&ring->tail);
+		if (h - ring->tail_cache >= TRACE_RING)
+		{
+			fa_store_release(&ring->dropped, ring->dropped + 1);
+			return;
+		}
+	}
+
+	r = &ring->rec[h & TRACE_MASK];
+	r->time = prof_ticks();
+	r->kernel = (uint16_t)kernel;
+	r->thread = ring->id;
+	r->seq = ring->seq++;
+	r->i = i, r->j = j;
+	r->a = a, r->b = b, r->sum = sum;
+	fa_store_release(&ring->head, h + 1);
+}
+
+static void trace_drain(trace_ring_t* ring)
+{
+	/* writer side : everything published so far, at most two fwrite for the wrap */
+
+	const size_t h = fa_load_acquire(&ring->head), t = ring->tail;
+	const size_t first = (t & TRACE_MASK) + (h - t) <= TRACE_RING ? h - t : TRACE_RING - (t & TRACE_MASK);
+	size_t dropped;
+	trace_record_t mark;
+
+	if (h != t)
+	{
+		fwrite(ring->rec + (t & TRACE_MASK), sizeof(trace_record_t), first, trace_fp);
+		if (first < h - t) fwrite(ring->rec, sizeof(trace_record_t), h - t - first, trace_fp);
+		fa_store_release(&ring->tail, h);
+	}
+
+	if ((dropped = fa_load_acquire(&ring->dropped)) != ring->dropped_seen)
+	{
+		memset(&mark, 0, sizeof(mark));
+		mark.time = prof_ticks();
+		mark.kernel = TRACE_DROPPED;
+		mark.thread = ring->id;
+		mark.i = (int32_t)(dropped - ring->dropped_seen);
+		fwrite(&mark, sizeof(mark), 1, trace_fp);
+		ring->dropped_seen = dropped;
+	}
+}
+
+static void trace_sleep_ms(const int ms)
+{
+#ifdef _WIN32
+	Sleep((DWORD)ms);
+#else
+	struct timespec ts;
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+	nanosleep(&ts, NULL);
+#endif
+}
+
+static void trace_writer_main(void* arg)
+{
+	size_t quit;
+	long k, n;
+	trace_ring_t* ring;
+
+	(void)arg;
+	for (;;)
+	{
+		quit = fa_load_acquire(&trace_quit); // read before the drain : the last pass sees every record
+		n = trace_ring_count();
+		for (k = 0; k < n; k++)
+		{
+			if ((ring = trace_ring_load(k)) != NULL) trace_drain(ring);
+		}
+		if (quit) break;
+		trace_sleep_ms(TRACE_FLUSH_MS);
+	}
+	fflush(trace_fp);
+}
+
+int trace_start(const char* file_name)
+{
+	/*
+	* Arguments
+	- file_name : Trace file, overwritten
+
+	Description
+	-	Writes the header, starts the writer thread and turns the trace points on.
+		Records left in the rings by a previous trace are discarded.
+		Returns 0, -1 when a trace is already running or on failure.
+	*/
+
+	trace_header_t header;
+	trace_ring_t* ring;
+	long k, n;
+
+	if (trace_fp != NULL)
+	{
+		fprintf(stderr, "trace_start : trace already running\n");
+		return -1;
+	}
+	if ((trace_fp = fopen(file_name, "wb")) == NULL)
+	{
+		fprintf(stderr, "File Open Error!\n");
+		return -1;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, 4);
+	header.version = TRACE_VERSION;
+	header.record_size = (uint16_t)sizeof(trace_record_t);
+	header.ns_per_tick = prof_tick_ns();
+	header.start = prof_ticks();
+	fwrite(&header, sizeof(header), 1, trace_fp);
+
+	n = trace_ring_count();
+	for (k = 0; k < n; k++)
+	{
+		if ((ring = trace_ring_load(k)) == NULL) continue;
+		ring->tail = ring->head;
+		ring->dropped_seen = ring->dropped_base = ring->dropped;
+	}
+
+	fa_store_release(&trace_quit, 0);
+	if ((trace_writer = thread_start(trace_writer_main, NULL)) == NULL)
+	{
+		fclose(trace_fp);
+		trace_fp = NULL;
+		return -1;
+	}
+	trace_on = 1;
+	return 0;
+}
+
+void trace_stop(void)
+{
+	/*
+	Description
+	-	Turns the trace points off, lets the writer drain every ring once more
+		and closes the file. A record still being written by another thread
+		at this moment may be lost.
+	*/
+
+	if (trace_fp == NULL) return;
+
+	trace_on = 0;
+	fa_store_release(&trace_quit, 1);
+	thread_join(trace_writer);
+	trace_writer = NULL;
+
+	fclose(trace_fp);
+	trace_fp = NULL;
+}
+
+uint64_t trace_dropped(void)
+{
+	trace_ring_t* ring;
+	uint64_t total = 0;
+	long k, n = trace_ring_count();
+
+	for (k = 0; k < n; k++)
+	{
+		if ((ring = trace_ring_load(k)) != NULL) total += fa_load_acquire(&ring->dropped) - ring->dropped_base;
+	}
+	return total;
+}
+
+static int trace_record_cmp(const void* p, const void* q)
+{
+	const trace_record_t* a = (const trace_record_t*)p, * b = (const trace_record_t*)q;
+
+	if (a->time != b->time) return a->time < b->time ? -1 : 1;
+	if (a->thread != b->thread) return a->thread < b->thread ? -1 : 1;
+	return a->seq < b->seq ? -1 : a->seq > b->seq;
+}
+
+static const char* trace_kernel_name(const int kernel)
+{
+	switch (kernel)
+	{
+	case TRACE_DOT_PIDX: return "dot_pidx";
+	case TRACE_DOT_DPIDX: return "dot_dpidx";
+	case TRACE_LMS: return "lms";
+	case TRACE_USER: return "user";
+	case TRACE_DROPPED: return "dropped";
+	default: return "unknown";
+	}
+}
+
+int trace_decode(const char* file_name, FILE* out)
+{
+	/*
+	* Arguments
+	- file_name : File written by trace_start / trace_stop
+	- out : Text output, one line per record
+
+	Description
+	-	Reads every record, sorts them by time and prints the time since
+		trace_start in us, the thread, the kernel and its fields in the
+		layout the printf of the old *_debug kernels used.
+		Returns the number of records, -1 on error.
+	*/
+
+	trace_header_t header;
+	trace_record_t* rec = NULL, * r;
+	FILE* fp;
+	size_t n = 0, cap = 0, got;
+	double us;
+
+	if ((fp = fopen(file_name, "rb")) == NULL)
+	{
+		fprintf(stderr, "File Open Error!\n");
+		return -1;
+	}
+	if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, TRACE_MAGIC, 4) != 0
+		|| header.version != TRACE_VERSION || header.record_size != sizeof(trace_record_t))
+	{
+		fprintf(stderr, "trace_decode : %s is not a trace file of this version\n", file_name);
+		fclose(fp);
+		return -1;
+	}
+
+	for (;;)
+	{
+		if (n == cap)
+		{
+			cap = cap ? 2 * cap : TRACE_RING;
+			if ((r = (trace_record_t*)realloc(rec, sizeof(trace_record_t) * cap)) == NULL)
+			{
+				fprintf(stderr, "Memory Allocation Error!\n");
+				free(rec);
+				fclose(fp);
+				return -1;
+			}
+			rec = r;
+		}
+		if ((got = fread(rec + n, sizeof(trace_record_t), cap - n, fp)) == 0) break;
+		n += got;
+	}
+	fclose(fp);
+
+	if (n) qsort(rec, n, sizeof(trace_record_t), trace_record_cmp);
+
+	fprintf(out, "# trace %s : %zu records\n", file_name, n);
+	for (r = rec; r < rec + n; r++)
+	{
+		us = (double)(int64_t)(r->time - header.start) * header.ns_per_tick * 1e-3;
+		fprintf(out, "%12.3f us  t%-3u %-9s ", us, (unsigned)r->thread, trace_kernel_name(r->kernel));
+		switch (r->kernel)
+		{
+		case TRACE_DOT_PIDX:
+		case TRACE_DOT_DPIDX:
+			fprintf(out, "arr[%d] = %.4f * arr2[%d]= %.4f = %.4f \n", r->i, r->a, r->j, r->b, r->sum);
+			break;
+		case TRACE_LMS:
+			fprintf(out, "y[%d] = %.6f desired = %.6f error : %f \n", r->i, r->a, r->b, r->sum);
+			break;
+		case TRACE_DROPPED:
+			fprintf(out, "%d records lost \n", r->i);
+			break;
+		default:
+			fprintf(out, "i = %d j = %d a = %g b = %g sum = %g \n", r->i, r->j, r->a, r->b, r->sum);
+			break;
+		}
+	}
+
+	free(rec);
+	return (int)n;
+}
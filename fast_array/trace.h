@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include "common.h"
+#include "prof.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          BINARY TRACE
+*******************************************************************************/
+/*
+* Fixed size binary records instead of printf in the inner loops.
+* Every tracing thread gets its own ring of TRACE_RING records on its first
+* record : the thread is the only producer, the writer thread started by
+* trace_start the only consumer, so a record costs one tick read, a 48 byte
+* store and one release store, no lock and no stdio. A full ring drops the
+* record and counts it, the kernel never waits for the writer.
+* The writer drains all rings to the file every TRACE_FLUSH_MS and once more
+* at trace_stop. Records of one thread keep their order in the file, records
+* of different threads are interleaved by batch : trace_decode sorts by time.
+* Trace points cost one load and a branch while no trace is running.
+*/
+#define TRACE_RING 16384		// records per thread, power of 2
+#define TRACE_MAX_THREADS 64	// later threads are not traced
+#define TRACE_FLUSH_MS 2
+
+#define TRACE_MAGIC "FATR"
+#define TRACE_VERSION 1
+
+typedef enum _trace_kernel_t
+{
+	TRACE_DOT_PIDX = 1,		// i = j : index, a * b, sum : partial sum
+	TRACE_DOT_DPIDX,		// i, j : indices of arr1, arr2, a * b, sum : partial sum
+	TRACE_LMS,				// i : output sample, a : y, b : desired, sum : error
+	TRACE_USER,				// free for application trace points
+	TRACE_DROPPED = 0xffff	// written by the writer, i : records lost by the thread since the last one
+} trace_kernel_t;
+
+typedef struct _trace_record
+{
+	uint64_t time;			// prof_ticks()
+	uint16_t kernel;		// trace_kernel_t
+	uint16_t thread;		// ring of the thread, in order of first record
+	uint32_t seq;			// per thread sequence number, wraps
+	int32_t i, j;			// indices
+	double a, b, sum;		// operands and partial result
+} trace_record_t;			// 48 bytes
+
+typedef struct _trace_header
+{
+	char magic[4];			// TRACE_MAGIC
+	uint16_t version;		// TRACE_VERSION
+	uint16_t record_size;	// sizeof(trace_record_t)
+	double ns_per_tick;		// time scale of the records
+	uint64_t start;			// prof_ticks() at trace_start
+	uint8_t reserved[8];
+} trace_header_t;			// 32 bytes
+
+extern volatile int trace_on;	// set between trace_start and trace_stop
+
+int trace_start(const char* file_name);
+void trace_stop(void);
+void trace_emit(const trace_kernel_t kernel, const int32_t i, const int32_t j, const double a, const double b, const double sum);
+uint64_t trace_dropped(void);	// records lost since trace_start, all threads
+int trace_decode(const char* file_name, FILE* out);
+
+#define TRACE(kernel, i, j, a, b, sum) do { if (trace_on) trace_emit(kernel, (int32_t)(i), (int32_t)(j), a, b, sum); } while (0)
+
+/* wrapper function : trace */
+#define fa_trace TRACE
+#define fa_trace_decode trace_decode
+
+#endif
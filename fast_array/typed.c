@@ -0,0 +1,221 @@
+/**
+* @ author : junyeong heo
+*
+\brief
+** Kernels for float32, double, Q15 and Q31 element types.
+** The element-wise kernels are written once in typed_template.h,
+** dot products and scaling are written per type because the
+** accumulator and the fixed point gain differ.
+*/
+
+#include "typed.h"
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          ELEMENT TYPE
+*******************************************************************************/
+elem_t elem_type(const type_t data_type)
+{
+	if (!(strcmp(data_type, "double") && strcmp(data_type, "float64") && strcmp(data_type, "signed double") && strcmp(data_type, "signed float64")))
+		return ELEM_F64;
+
+	if (!(strcmp(data_type, "float") && strcmp(data_type, "float32") && strcmp(data_type, "signed float") && strcmp(data_type, "signed float32")))
+		return ELEM_F32;
+
+	if (!(strcmp(data_type, "q15") && strcmp(data_type, "short") && strcmp(data_type, "int16") && strcmp(data_type, "signed short") && strcmp(data_type, "signed int16")))
+		return ELEM_Q15;
+
+	if (!(strcmp(data_type, "q31") && strcmp(data_type, "int") && strcmp(data_type, "int32") && strcmp(data_type, "signed int") && strcmp(data_type, "signed int32")))
+		return ELEM_Q31;
+
+	return ELEM_UNKNOWN;
+}
+
+size_t elem_size(const elem_t type)
+{
+	switch (type)
+	{
+	case ELEM_F64: return sizeof(f64_t);
+	case ELEM_F32: return sizeof(f32_t);
+	case ELEM_Q15: return sizeof(q15_t);
+	case ELEM_Q31: return sizeof(q31_t);
+	default: return 0;
+	}
+}
+
+const char* elem_name(const elem_t type)
+{
+	switch (type)
+	{
+	case ELEM_F64: return "float64";
+	case ELEM_F32: return "float32";
+	case ELEM_Q15: return "q15";
+	case ELEM_Q31: return "q31";
+	default: return "unknown";
+	}
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          DOT PRODUCT
+*******************************************************************************/
+float dot_f32(const f32_t* a, const f32_t* b, const size_t size)
+{
+	return simd_dot_f32(a, b, size);
+}
+
+double dot_f64(const f64_t* a, const f64_t* b, const size_t size)
+{
+	return simd_dot(a, b, size);
+}
+
+int64_t dot_q15(const q15_t* a, const q15_t* b, const size_t size)
+{
+	return simd_dot_q15(a, b, size);
+}
+
+int64_t dot_q31(const q31_t* a, const q31_t* b, const size_t size)
+{
+	/*
+	Description
+	-	Each Q62 product is truncated to Q48 before accumulation,
+		leaving 15 guard bits for the sum.
+	*/
+
+	int64_t s0 = 0, s1 = 0;
+	size_t i = 0;
+
+	for (; i + 2 <= size; i += 2)
+	{
+		s0 += ((int64_t)a[i] * b[i]) >> 14;
+		s1 += ((int64_t)a[i + 1] * b[i + 1]) >> 14;
+	}
+	for (; i < size; i++) s0 += ((int64_t)a[i] * b[i]) >> 14;
+
+	return s0 + s1;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          SCALING
+*******************************************************************************/
+void scaling_f32(f32_t* arr, const size_t size, dtype scaling_factor)
+{
+	const float g = (float)scaling_factor;
+	size_t i; for (i = 0; i < size; i++) arr[i] *= g;
+}
+
+void scaling_f64(f64_t* arr, const size_t size, dtype scaling_factor)
+{
+	size_t i; for (i = 0; i < size; i++) arr[i] *= scaling_factor;
+}
+
+void scaling_q15(q15_t* arr, const size_t size, dtype scaling_factor)
+{
+	/*
+	Description
+	-	scaling_factor = frac * 2^shift with |frac| < 1, frac in Q15.
+		Factors above one are allowed, the result saturates.
+	*/
+
+	int shift, i_shift;
+	const int32_t g = (int32_t)floor(frexp(scaling_factor, &shift) * 32768.0 + 0.5);
+	size_t i;
+
+	if (shift > 15) shift = 15; // saturates anyway
+	i_shift = 15 - shift;
+	if (i_shift > 62) // |arr * g| < 2^62 : every result rounds to 0, and the shift would be undefined
+	{
+		memset(arr, 0, sizeof(q15_t) * size);
+		return;
+	}
+	for (i = 0; i < size; i++)
+		arr[i] = q15_sat((int32_t)(((int64_t)arr[i] * g + ((int64_t)1 << i_shift >> 1)) >> i_shift));
+}
+
+void scaling_q31(q31_t* arr, const size_t size, dtype scaling_factor)
+{
+	int shift, i_shift;
+	const int64_t g = (int64_t)floor(frexp(scaling_factor, &shift) * 2147483648.0 + 0.5);
+	size_t i;
+
+	if (shift > 31) shift = 31;
+	i_shift = 31 - shift;
+	if (i_shift > 62)
+	{
+		memset(arr, 0, sizeof(q31_t) * size);
+		return;
+	}
+	for (i = 0; i < size; i++)
+		arr[i] = q31_sat(((int64_t)arr[i] * g + ((int64_t)1 << i_shift >> 1)) >> i_shift);
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          TEMPLATE INSTANCES
+*******************************************************************************/
+static inline q15_t q15_from_q30(int64_t a)
+{
+	a = (a + (1 << 14)) >> 15;
+	return (q15_t)(a > Q15_MAX ? Q15_MAX : (a < Q15_MIN ? Q15_MIN : a));
+}
+
+#define TYPED_T f32_t
+#define TYPED_S f32
+#define TYPED_ADD(a, b) ((a) + (b))
+#define TYPED_MUL(a, b) ((a) * (b))
+#define TYPED_ONE 1.0f
+#define TYPED_FROM_D(x) ((f32_t)(x))
+#define TYPED_TO_D(x) ((dtype)(x))
+#define TYPED_ACC(a) (a)
+#define TYPED_FMT "%.3f "
+#include "typed_template.h"
+
+#define TYPED_T f64_t
+#define TYPED_S f64
+#define TYPED_ADD(a, b) ((a) + (b))
+#define TYPED_MUL(a, b) ((a) * (b))
+#define TYPED_ONE 1.0
+#define TYPED_FROM_D(x) ((f64_t)(x))
+#define TYPED_TO_D(x) ((dtype)(x))
+#define TYPED_ACC(a) (a)
+#define TYPED_FMT "%.4lf "
+#include "typed_template.h"
+
+#define TYPED_T q15_t
+#define TYPED_S q15
+#define TYPED_ADD(a, b) q15_add(a, b)
+#define TYPED_MUL(a, b) q15_mul(a, b)
+#define TYPED_ONE Q15_MAX
+#define TYPED_FROM_D(x) q15_from_double(x)
+#define TYPED_TO_D(x) q15_to_double(x)
+#define TYPED_ACC(a) q15_from_q30(a)
+#define TYPED_FMT "%d "
+#include "typed_template.h"
+
+#define TYPED_T q31_t
+#define TYPED_S q31
+#define TYPED_ADD(a, b) q31_add(a, b)
+#define TYPED_MUL(a, b) q31_mul(a, b)
+#define TYPED_ONE Q31_MAX
+#define TYPED_FROM_D(x) q31_from_double(x)
+#define TYPED_TO_D(x) q31_to_double(x)
+#define TYPED_ACC(a) q31_sat(((a) + (1 << 16)) >> 17) // Q48 -> Q31
+#define TYPED_FMT "%d "
+#include "typed_template.h"
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          PRINT ARRAY
+*******************************************************************************/
+void print_arr1d_typed(const void* arr, const size_t size, type_t data_type)
+{
+	switch (elem_type(data_type))
+	{
+	case ELEM_F64: print_arr1d_f64((const f64_t*)arr, size); break;
+	case ELEM_F32: print_arr1d_f32((const f32_t*)arr, size); break;
+	case ELEM_Q15: print_arr1d_q15((const q15_t*)arr, size); break;
+	case ELEM_Q31: print_arr1d_q31((const q31_t*)arr, size); break;
+	default: fprintf(stderr, "error : \"(%s)\" is Unsuppored data type \n", data_type); break;
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef __TYPED_H__
+#define __TYPED_H__
+
+#include "common.h"
+#include "simd.h"
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          FIXED POINT ARITHMETIC
+*******************************************************************************/
+/*
+* Q15 / Q31 values are fractions in [-1, 1). Every operation rounds to
+* nearest and saturates instead of wrapping.
+*/
+#define Q15_MAX 32767
+#define Q15_MIN (-32768)
+#define Q31_MAX 2147483647
+#define Q31_MIN (-2147483647 - 1)
+
+static inline q15_t q15_sat(int32_t x) { return (q15_t)(x > Q15_MAX ? Q15_MAX : (x < Q15_MIN ? Q15_MIN : x)); }
+static inline q31_t q31_sat(int64_t x) { return (q31_t)(x > Q31_MAX ? Q31_MAX : (x < Q31_MIN ? Q31_MIN : x)); }
+
+static inline q15_t q15_add(q15_t a, q15_t b) { return q15_sat((int32_t)a + b); }
+static inline q31_t q31_add(q31_t a, q31_t b) { return q31_sat((int64_t)a + b); }
+static inline q15_t q15_mul(q15_t a, q15_t b) { return q15_sat(((int32_t)a * b + (1 << 14)) >> 15); }
+static inline q31_t q31_mul(q31_t a, q31_t b) { return q31_sat(((int64_t)a * b + (1LL << 30)) >> 31); }
+
+static inline q15_t q15_from_double(double x) { x = floor(x * 32768.0 + 0.5); return (q15_t)(x >= Q15_MAX ? Q15_MAX : (x <= Q15_MIN ? Q15_MIN : x)); }
+static inline q31_t q31_from_double(double x) { x = floor(x * 2147483648.0 + 0.5); return (q31_t)(x >= Q31_MAX ? Q31_MAX : (x <= Q31_MIN ? Q31_MIN : x)); }
+static inline double q15_to_double(q15_t x) { return x * (1.0 / 32768.0); }
+static inline double q31_to_double(q31_t x) { return x * (1.0 / 2147483648.0); }
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          ELEMENT TYPE
+*******************************************************************************/
+elem_t elem_type(const type_t data_type);
+	// "double"/"float64" -> ELEM_F64, "float"/"float32" -> ELEM_F32,
+	// "q15"/"short"/"int16" -> ELEM_Q15, "q31"/"int"/"int32" -> ELEM_Q31, else ELEM_UNKNOWN
+size_t elem_size(const elem_t type);
+const char* elem_name(const elem_t type);
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          TYPED KERNELS
+*******************************************************************************/
+/*
+* The same kernels exist for every element type, suffixed _f32, _f64,
+* _q15 and _q31 (typed_template.h instantiates them in typed.c).
+* dot products return the accumulator type :
+*	f32 -> float, f64 -> double,
+*	q15 -> int64 Q30 (exact at every simd level, -32768 * -32768 pairs included),
+*	q31 -> int64 Q48 (products >> 14).
+*/
+#define TYPED_DECLARE(T, S) \
+void zeros_##S(T* arr, const size_t size); \
+void ones_##S(T* arr, const size_t size); \
+void scaling_##S(T* arr, const size_t size, dtype scaling_factor); \
+void add_##S(const T* a, const T* b, T* out, const size_t size); \
+void mul_##S(const T* a, const T* b, T* out, const size_t size); \
+void push_block_##S(T* ptr, const size_t size, pIdx* ptr_idx, const T* block, const size_t n); \
+T fast_fir_filtering_##S(const T* x1, const T* x2, const size_t size, pIdx idx); \
+void from_dtype_##S(const dtype* in, T* out, const size_t size); \
+void to_dtype_##S(const T* in, dtype* out, const size_t size); \
+void print_arr1d_##S(const T* arr, const size_t size);
+
+TYPED_DECLARE(f32_t, f32)
+TYPED_DECLARE(f64_t, f64)
+TYPED_DECLARE(q15_t, q15)
+TYPED_DECLARE(q31_t, q31)
+
+float dot_f32(const f32_t* a, const f32_t* b, const size_t size);
+double dot_f64(const f64_t* a, const f64_t* b, const size_t size);
+int64_t dot_q15(const q15_t* a, const q15_t* b, const size_t size);
+int64_t dot_q31(const q31_t* a, const q31_t* b, const size_t size);
+
+void print_arr1d_typed(const void* arr, const size_t size, type_t data_type);
+	// arr holds elements of data_type, not dtype
+
+/******************************************************************************
+**                          TYPE GENERIC WRAPPER
+*******************************************************************************/
+/*
+* C11 _Generic picks the kernel from the pointer type of the first
+* argument, e.g. dot_typed(a, b, n) with q15_t* a calls dot_q15.
+* Under msvc this needs /std:c11 (set in the project).
+*/
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define TYPED_SELECT(x, name) _Generic((x), \
+	f32_t*: name##_f32, const f32_t*: name##_f32, \
+	f64_t*: name##_f64, const f64_t*: name##_f64, \
+	q15_t*: name##_q15, const q15_t*: name##_q15, \
+	q31_t*: name##_q31, const q31_t*: name##_q31)
+
+#define zeros_typed(arr, size) TYPED_SELECT(arr, zeros)(arr, size)
+#define ones_typed(arr, size) TYPED_SELECT(arr, ones)(arr, size)
+#define scaling_typed(arr, size, factor) TYPED_SELECT(arr, scaling)(arr, size, factor)
+#define add_typed(a, b, out, size) TYPED_SELECT(a, add)(a, b, out, size)
+#define mul_typed(a, b, out, size) TYPED_SELECT(a, mul)(a, b, out, size)
+#define dot_typed(a, b, size) TYPED_SELECT(a, dot)(a, b, size)
+#define push_block_typed(ptr, size, ptr_idx, block, n) TYPED_SELECT(ptr, push_block)(ptr, size, ptr_idx, block, n)
+#define fast_fir_filtering_typed(x1, x2, size, idx) TYPED_SELECT(x1, fast_fir_filtering)(x1, x2, size, idx)
+#define from_dtype_typed(in, out, size) TYPED_SELECT(out, from_dtype)(in, out, size)
+#define to_dtype_typed(in, out, size) TYPED_SELECT(in, to_dtype)(in, out, size)
+#define print_arr1d_generic(arr, size) TYPED_SELECT(arr, print_arr1d)(arr, size)
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+/*
+* Kernel template of typed.c, included once per element type with
+*	TYPED_T : element type
+*	TYPED_S : name suffix
+*	TYPED_ADD(a, b), TYPED_MUL(a, b) : saturating arithmetic
+*	TYPED_ONE : largest value not above 1
+*	TYPED_FROM_D(x), TYPED_TO_D(x) : conversion from / to dtype
+*	TYPED_ACC(a) : dot_S accumulator to TYPED_T
+*	TYPED_FMT : printf format of one element
+* No include guard on purpose, every macro is undefined at the end.
+*/
+
+#define TYPED_CAT_(a, b) a##_##b
+#define TYPED_CAT(a, b) TYPED_CAT_(a, b)
+#define TY(name) TYPED_CAT(name, TYPED_S)
+
+void TY(zeros)(TYPED_T* arr, const size_t size)
+{
+	memset(arr, 0, sizeof(TYPED_T) * size);
+}
+
+void TY(ones)(TYPED_T* arr, const size_t size)
+{
+	size_t i; for (i = 0; i < size; i++) arr[i] = TYPED_ONE;
+}
+
+void TY(add)(const TYPED_T* a, const TYPED_T* b, TYPED_T* out, const size_t size)
+{
+	size_t i; for (i = 0; i < size; i++) out[i] = TYPED_ADD(a[i], b[i]);
+}
+
+void TY(mul)(const TYPED_T* a, const TYPED_T* b, TYPED_T* out, const size_t size)
+{
+	size_t i; for (i = 0; i < size; i++) out[i] = TYPED_MUL(a[i], b[i]);
+}
+
+void TY(push_block)(TYPED_T* ptr, const size_t size, pIdx* ptr_idx, const TYPED_T* block, const size_t n)
+{
+	/*
+	Description
+	-	push_block_pidx for TYPED_T, see fast_array.c.
+	*/
+
+	TYPED_T* dst;
+	size_t i, m = n, new_idx, end;
+
+	if (m == 0) return;
+	if (m > size) { block += m - size; m = size; }
+
+	new_idx = ((size_t)*ptr_idx + size - n % size) % size;
+	dst = ptr + new_idx;
+	end = new_idx + m;
+
+	for (i = 0; i < m; i++) dst[i] = block[m - 1 - i];
+
+	if (end <= size)
+	{
+		memcpy(ptr + new_idx + size, ptr + new_idx, sizeof(TYPED_T) * m);
+	}
+	else
+	{
+		memcpy(ptr + new_idx + size, ptr + new_idx, sizeof(TYPED_T) * (size - new_idx));
+		memcpy(ptr, ptr + size, sizeof(TYPED_T) * (end - size));
+	}
+	*ptr_idx = (pIdx)new_idx;
+}
+
+TYPED_T TY(fast_fir_filtering)(const TYPED_T* x1, const TYPED_T* x2, const size_t size, pIdx idx)
+{
+	/* both fast arrays read from idx, as the dtype fast_fir_filtering */
+	return TYPED_ACC(TY(dot)(x1 + idx, x2 + idx, size));
+}
+
+void TY(from_dtype)(const dtype* in, TYPED_T* out, const size_t size)
+{
+	size_t i; for (i = 0; i < size; i++) out[i] = TYPED_FROM_D(in[i]);
+}
+
+void TY(to_dtype)(const TYPED_T* in, dtype* out, const size_t size)
+{
+	size_t i; for (i = 0; i < size; i++) out[i] = TYPED_TO_D(in[i]);
+}
+
+void TY(print_arr1d)(const TYPED_T* arr, const size_t size)
+{
+	size_t i; for (i = 0; i < size; i++) fprintf(stdout, TYPED_FMT, arr[i]);
+	printf("\n");
+}
+
+#undef TY
+#undef TYPED_CAT
+#undef TYPED_CAT_
+#undef TYPED_T
+#undef TYPED_S
+#undef TYPED_ADD
+#undef TYPED_MUL
+#undef TYPED_ONE
+#undef TYPED_FROM_D
+#undef TYPED_TO_D
+#undef TYPED_ACC
+#undef TYPED_FMT
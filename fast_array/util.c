@@ -1,184 +1,711 @@
-/**
-* @ author : junyeong heo
-*
-\brief
-** This source code defines utility functions 
-** such as data or file I/O that make program 
-** development overall easier.
-*/
-
-#include "util.h"
-
-// Get length of char array
-int getLength(char* str)
-{
-    int i, len = 0;
-    for (i = 0; str[i] != '\0'; i++) len++; return len;
-}
-
-char* concat(const char* str1, const char* str2)
-{
-    char* strto = (char*)malloc(getLength(str1) + getLength(str2) + 1);
-    int tlen = getLength(str1), i;
-	for (i = 0; str2[i] != '\0'; i++) strto[i] = str1[i];
-    for (i = 0; str2[i] != '\0'; i++) strto[tlen + i] = str2[i];
-    strto[tlen + i] = '\0';
-    return strto;
-}
-
-char* concat_token(const char* str1, const char token)
-{
-    char* strto = (char*)malloc(strlen(str1) + 2);
-    int tlen = strlen(str1), i;
-    for (i = 0; i < tlen; i++) strto[i] = str1[i];
-    strto[tlen] = token, strto[tlen + 1] = '\0';
-    return strto;
-}
-string_dir dir_join(const char* dir1, const char* dir2)
-{
-    /*
-       join directory ,, ex) "directory1 // directory2"
-    */
-#ifdef __WINDOWS__
-    return concat(concat(dir1, "\\"), dir2);
-#endif
-#ifdef __LINUX__
-    return concat(concat(dir1, "/"), dir2);
-#endif
-
-}
-
-string_dir dir_joins_va(size_t args, string_dir root_dir, ...)
-{
-    /*
-      strcats for directory
-    */
-    int i;
-    va_list ap;
-    string_dir sd, dir = root_dir;
-
-    va_start(ap, root_dir);
-
-    for (i = 0; i < args - 1; i++)
-    {
-        sd = va_arg(ap, string_dir);
-        dir = dir_join(dir, sd);
-    }
-    va_end(ap);
-
-    return dir;
-}
-
-int write_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type)
-{
-	int i; // for iteration
-	FILE* inout_fp;
-	char* fn = NULL; // temp file name
-
-	if ((strstr(file_name, ".dat") == NULL) || (strstr(file_name, ".txt") == NULL))
-	{
-		if ((inout_fp = fopen(concat(file_name, ".dat"), "w")) == NULL)
-		{
-			fprintf(stderr, "File Open Error!\n");
-			return -1;
-		}
-	}
-	else
-	{
-		if ((inout_fp = fopen(file_name, "w")) == NULL)
-		{
-			fprintf(stderr, "File Open Error!\n");
-			return -1;
-		}
-	}
-
-	fseek(inout_fp, NULL, SEEK_SET);
-
-	// data type
-	if (!(strcmp(data_type, "int") && strcmp(data_type, "int32") && strcmp(data_type, "signed int") && strcmp(data_type, "signed int32")))
-		fn = concat_token("%d", token);
-
-	else if (!(strcmp(data_type, "uint") && strcmp(data_type, "uint32") && strcmp(data_type, "unsigned int") && strcmp(data_type, "unsigned int32")))
-		fn = concat_token("%u", token);
-
-	else if (!(strcmp(data_type, "short") && strcmp(data_type, "int16") && strcmp(data_type, "signed short") && strcmp(data_type, "signed int16")))
-		fn = concat_token("%d", token);
-
-	else if (!(strcmp(data_type, "ushort") && strcmp(data_type, "uint16") && strcmp(data_type, "unsigned short") && strcmp(data_type, "unsigned int16")))
-		fn = concat_token("%u", token);
-
-	else if (!(strcmp(data_type, "float") && strcmp(data_type, "float32") && strcmp(data_type, "signed float") && strcmp(data_type, "signed float32")))
-		fn = concat_token("%f", token);
-
-	else if (!(strcmp(data_type, "double") && strcmp(data_type, "float64") && strcmp(data_type, "signed double") && strcmp(data_type, "signed float64")))
-		fn = concat_token("%lf", token);
-
-	else
-	{
-		printf("write_data_file : \"(%s)\" is Unsuppored data type \n", data_type);
-		return -1;
-	}
-
-	for (i = 0; i < size; i++) fprintf(inout_fp, fn, arr[i]);
-
-	fclose(inout_fp);
-
-	return 0;
-}
-
-int read_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type)
-{
-	int i; // for iteration
-	FILE* inout_fp;
-	char* fn = NULL; // temp file name
-
-	if ((strstr(file_name, ".dat") == NULL) || (strstr(file_name, ".txt") == NULL))
-	{
-		if ((inout_fp = fopen(concat(file_name, ".dat"), "r")) == NULL)
-		{
-			fprintf(stderr, "File Open Error!\n");
-			return -1;
-		}
-	}
-	else
-	{
-		if ((inout_fp = fopen(file_name, "r")) == NULL)
-		{
-			fprintf(stderr, "File Open Error!\n");
-			return -1;
-		}
-	}
-
-	fseek(inout_fp, NULL, SEEK_SET);
-
-	// data type
-	if (!(strcmp(data_type, "int") && strcmp(data_type, "int32") && strcmp(data_type, "signed int") && strcmp(data_type, "signed int32")))
-		fn = concat_token("%d", token);
-
-	else if (!(strcmp(data_type, "uint") && strcmp(data_type, "uint32") && strcmp(data_type, "unsigned int") && strcmp(data_type, "unsigned int32")))
-		fn = concat_token("%u", token);
-
-	else if (!(strcmp(data_type, "short") && strcmp(data_type, "int16") && strcmp(data_type, "signed short") && strcmp(data_type, "signed int16")))
-		fn = concat_token("%d", token);
-
-	else if (!(strcmp(data_type, "ushort") && strcmp(data_type, "uint16") && strcmp(data_type, "unsigned short") && strcmp(data_type, "unsigned int16")))
-		fn = concat_token("%u", token);
-
-	else if (!(strcmp(data_type, "float") && strcmp(data_type, "float32") && strcmp(data_type, "signed float") && strcmp(data_type, "signed float32")))
-		fn = concat_token("%f", token);
-
-	else if (!(strcmp(data_type, "double") && strcmp(data_type, "float64") && strcmp(data_type, "signed double") && strcmp(data_type, "signed float64")))
-		fn = concat_token("%lf", token);
-
-	else
-	{
-		printf("write_data_file : \"(%s)\" is Unsuppored data type \n", data_type);
-		return -1;
-	}
-
-	for (i = 0; i < size; i++) fscanf(inout_fp, fn, &arr[i]);
-
-	fclose(inout_fp);
-
-	return 0;
+/**
+* @ author : junyeong heo
+*
+\brief
+** This source code defines utility functions 
+** such as data or file I/O that make program 
+** development overall easier.
+*/
+
+#ifdef __linux__
+#define _GNU_SOURCE // clock_gettime, fseeko under -std=c11
+#endif
+
+#include "util.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Get length of char array
+int getLength(char* str)
+{
+    int i, len = 0;
+    for (i = 0; str[i] != '\0'; i++) len++; return len;
+}
+
+char* concat(const char* str1, const char* str2)
+{
+    char* strto = (char*)malloc(getLength(str1) + getLength(str2) + 1);
+    int tlen = getLength(str1), i;
+	for (i = 0; str1[i] != '\0'; i++) strto[i] = str1[i];
+    for (i = 0; str2[i] != '\0'; i++) strto[tlen + i] = str2[i];
+    strto[tlen + i] = '\0';
+    return strto;
+}
+
+char* concat_token(const char* str1, const char token)
+{
+    char* strto = (char*)malloc(strlen(str1) + 2);
+    int tlen = strlen(str1), i;
+    for (i = 0; i < tlen; i++) strto[i] = str1[i];
+    strto[tlen] = token, strto[tlen + 1] = '\0';
+    return strto;
+}
+string_dir dir_join(const char* dir1, const char* dir2)
+{
+    /*
+       join directory ,, ex) "directory1 // directory2"
+    */
+#ifdef __WINDOWS__
+    return concat(concat(dir1, "\\"), dir2);
+#endif
+#ifdef __LINUX__
+    return concat(concat(dir1, "/"), dir2);
+#endif
+
+}
+
+string_dir dir_joins_va(size_t args, string_dir root_dir, ...)
+{
+    /*
+      strcats for directory
+    */
+    int i;
+    va_list ap;
+    string_dir sd, dir = root_dir;
+
+    va_start(ap, root_dir);
+
+    for (i = 0; i < args - 1; i++)
+    {
+        sd = va_arg(ap, string_dir);
+        dir = dir_join(dir, sd);
+    }
+    va_end(ap);
+
+    return dir;
+}
+
+uint64_t time_now_ns(void)
+{
+	/*
+	Description
+	-	Monotonic high resolution clock for timing, unlike clock()
+		it counts wall time in nanoseconds and never goes back.
+	*/
+
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+
+	if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000000ULL
+		+ (uint64_t)(now.QuadPart % freq.QuadPart) * 1000000000ULL / (uint64_t)freq.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+int file_seek(FILE* fp, const int64_t offset, const int origin)
+{
+	/* fseek with a 64 bit offset, long is 32 bit on Win64. Returns 0 or -1 */
+
+#ifdef _WIN32
+	return _fseeki64(fp, offset, origin) == 0 ? 0 : -1;
+#else
+	return fseeko(fp, (off_t)offset, origin) == 0 ? 0 : -1;
+#endif
+}
+
+int64_t file_tell(FILE* fp)
+{
+	/* ftell with a 64 bit result, -1 on error */
+
+#ifdef _WIN32
+	return (int64_t)_ftelli64(fp);
+#else
+	return (int64_t)ftello(fp);
+#endif
+}
+
+FILE* open_data_file(char* file_name, const char* mode)
+{
+	/* ".dat" is appended only when the name has neither ".dat" nor ".txt" */
+
+	FILE* inout_fp;
+	char* fn = NULL;
+
+	if ((strstr(file_name, ".dat") == NULL) && (strstr(file_name, ".txt") == NULL))
+		file_name = fn = concat(file_name, ".dat");
+
+	inout_fp = fopen(file_name, mode);
+	free(fn);
+
+	if (inout_fp == NULL)
+	{
+		fprintf(stderr, "File Open Error!\n");
+		return NULL;
+	}
+
+	return inout_fp;
+}
+
+elem_t text_elem(const type_t data_type)
+{
+	/*
+	* element type a data_type string formats as :
+	* int / uint families as integers (ELEM_Q31, ELEM_Q15), float and double round trip
+	*/
+
+	if (!(strcmp(data_type, "uint") && strcmp(data_type, "uint32") && strcmp(data_type, "unsigned int") && strcmp(data_type, "unsigned int32")))
+		return ELEM_Q31;
+
+	if (!(strcmp(data_type, "ushort") && strcmp(data_type, "uint16") && strcmp(data_type, "unsigned short") && strcmp(data_type, "unsigned int16")))
+		return ELEM_Q15;
+
+	return elem_type(data_type);
+}
+
+static char* read_text(char* file_name, size_t* length)
+{
+	/* whole file into one buffer, terminated with '\0' for the parser */
+
+	FILE* fp;
+	char* text;
+	int64_t bytes;
+
+	if ((fp = open_data_file(file_name, "rb")) == NULL) return NULL;
+
+	bytes = file_seek(fp, 0, SEEK_END) == 0 ? file_tell(fp) : -1;
+	file_seek(fp, 0, SEEK_SET);
+
+	if (bytes < 0 || (uint64_t)bytes >= SIZE_MAX || (text = (char*)malloc((size_t)bytes + 1)) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		fclose(fp);
+		return NULL;
+	}
+
+	*length = fread(text, 1, (size_t)bytes, fp);
+	text[*length] = '\0';
+	fclose(fp);
+
+	return text;
+}
+
+static int write_text(FILE* fp, const dtype* arr, const size_t size, const char token, const elem_t type)
+{
+	/* formats TEXT_BLOCK values at a time into one buffer and writes it with one fwrite */
+
+	char* text;
+	size_t i, n, bytes;
+
+	if ((text = (char*)malloc(TEXT_BLOCK * (TEXT_MAX_CHARS + 1))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return -1;
+	}
+
+	for (i = 0; i < size; i += n)
+	{
+		n = size - i < TEXT_BLOCK ? size - i : TEXT_BLOCK;
+		bytes = format_text(text, arr + i, n, token, type);
+		if (fwrite(text, 1, bytes, fp) != bytes)
+		{
+			fprintf(stderr, "File Write Error!\n");
+			free(text);
+			return -1;
+		}
+	}
+
+	free(text);
+	return 0;
+}
+
+size_t read_data_chunk(FILE* fp, dtype* arr, const size_t size, const char token, const type_t data_type)
+{
+	/*
+	* Arguments
+	- fp : File opened by open_data_file in binary mode ("rb"), the read position is kept between calls
+	- data_type : Element type of the text, as in read_data_file
+
+	Description
+	-	Reads up to size token separated values and returns how many were read,
+		fewer than size only at the end of the file.
+		Text is read TEXT_BLOCK bytes at a time and cut at the last separator,
+		the unused tail is given back with fseek.
+	*/
+
+	char buffer[TEXT_BLOCK + 1];
+	size_t n = 0, got, limit, used, k;
+	PROF_BEGIN(PROF_FILE_READ);
+
+	if (text_elem(data_type) == ELEM_UNKNOWN)
+	{
+		printf("read_data_chunk : \"(%s)\" is Unsuppored data type \n", data_type);
+		return 0;
+	}
+
+	while (n < size)
+	{
+		if ((got = fread(buffer, 1, TEXT_BLOCK, fp)) == 0) break;
+		buffer[got] = '\0';
+
+		limit = got;
+		if (got == TEXT_BLOCK) // more may follow, do not parse a cut number
+		{
+			while (limit > 0 && !text_separator(buffer[limit - 1], token)) limit--;
+			if (limit == 0) limit = got;
+		}
+
+		k = parse_text(buffer, limit, arr + n, size - n, token, &used);
+		n += k;
+		if (used < got) fseek(fp, -(long)(got - used), SEEK_CUR);
+		if (k == 0) break;
+	}
+
+	PROF_END(PROF_FILE_READ, n);
+	return n;
+}
+
+int write_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type)
+{
+	/*
+	Description
+	-	Every value followed by token. float and double values are written with
+		digits that read back to the same float / double, the shortest in almost
+		every case (Grisu2), the int and uint types as integers.
+	*/
+
+	FILE* inout_fp;
+	int ret;
+	const elem_t type = text_elem(data_type);
+	PROF_BEGIN(PROF_FILE_WRITE);
+
+	if (type == ELEM_UNKNOWN)
+	{
+		printf("write_data_file : \"(%s)\" is Unsuppored data type \n", data_type);
+		return -1;
+	}
+
+	if ((inout_fp = open_data_file(file_name, "wb")) == NULL) return -1;
+
+	ret = write_text(inout_fp, arr, size, token, type);
+	fclose(inout_fp);
+
+	PROF_END(PROF_FILE_WRITE, size);
+	return ret;
+}
+
+int read_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type)
+{
+	/*
+	Description
+	-	Reads the whole file and parses up to size values separated by token
+		and / or white space. Files of TEXT_PARALLEL_MIN bytes and more are parsed
+		on all cores.
+	*/
+
+	char* text;
+	size_t length;
+	PROF_BEGIN(PROF_FILE_READ);
+
+	if (text_elem(data_type) == ELEM_UNKNOWN)
+	{
+		printf("read_data_file : \"(%s)\" is Unsuppored data type \n", data_type);
+		return -1;
+	}
+
+	if ((text = read_text(file_name, &length)) == NULL) return -1;
+
+	parse_text_parallel(text, length, arr, size, token, 0);
+	free(text);
+
+	PROF_END(PROF_FILE_READ, size);
+	return 0;
+}
+
+int write_data_file_typed(const void* arr, const size_t size, char* file_name, const char token, const type_t data_type)
+{
+	/*
+	* Arguments
+	- arr : Array of data_type elements (float32, float64, q15/int16, q31/int32)
+
+	Description
+	-	Same file layout as write_data_file, but arr is read with the element type
+		named by data_type. Q15 / Q31 samples are written as raw integers.
+	*/
+
+	size_t i, n; // for iteration
+	FILE* inout_fp;
+	dtype* block;
+	int ret = 0;
+	const elem_t type = elem_type(data_type);
+	PROF_BEGIN(PROF_FILE_WRITE);
+
+	if (type == ELEM_UNKNOWN)
+	{
+		printf("write_data_file_typed : \"(%s)\" is Unsuppored data type \n", data_type);
+		return -1;
+	}
+
+	if (type == ELEM_F64) return write_data_file((dtype*)arr, size, file_name, token, data_type);
+
+	if ((block = (dtype*)malloc(sizeof(dtype) * TEXT_BLOCK)) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return -1;
+	}
+	if ((inout_fp = open_data_file(file_name, "wb")) == NULL)
+	{
+		free(block);
+		return -1;
+	}
+
+	for (i = 0; i < size && ret == 0; i += n)
+	{
+		n = size - i < TEXT_BLOCK ? size - i : TEXT_BLOCK;
+		switch (type)
+		{
+		case ELEM_F32: { size_t j; for (j = 0; j < n; j++) block[j] = ((const f32_t*)arr)[i + j]; } break;
+		case ELEM_Q15: { size_t j; for (j = 0; j < n; j++) block[j] = ((const q15_t*)arr)[i + j]; } break;
+		default: { size_t j; for (j = 0; j < n; j++) block[j] = ((const q31_t*)arr)[i + j]; } break;
+		}
+		ret = write_text(inout_fp, block, n, token, type);
+	}
+
+	free(block);
+	fclose(inout_fp);
+
+	PROF_END(PROF_FILE_WRITE, size);
+	return ret;
+}
+
+int read_data_file_typed(void* arr, const size_t size, char* file_name, const char token, const type_t data_type)
+{
+	size_t i, n; // for iteration
+	char* text;
+	size_t length;
+	dtype* values;
+	const elem_t type = elem_type(data_type);
+	PROF_BEGIN(PROF_FILE_READ);
+
+	if (type == ELEM_UNKNOWN)
+	{
+		printf("read_data_file_typed : \"(%s)\" is Unsuppored data type \n", data_type);
+		return -1;
+	}
+
+	if (type == ELEM_F64) return read_data_file((dtype*)arr, size, file_name, token, data_type);
+
+	if ((values = (dtype*)malloc(sizeof(dtype) * (size ? size : 1))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return -1;
+	}
+	if ((text = read_text(file_name, &length)) == NULL)
+	{
+		free(values);
+		return -1;
+	}
+
+	n = parse_text_parallel(text, length, values, size, token, 0);
+	free(text);
+
+	switch (type)
+	{
+	case ELEM_F32: for (i = 0; i < n; i++) ((f32_t*)arr)[i] = (f32_t)values[i]; break;
+	case ELEM_Q15: for (i = 0; i < n; i++) ((q15_t*)arr)[i] = q15_sat((int32_t)floor(values[i] + 0.5)); break;
+	default: for (i = 0; i < n; i++) ((q31_t*)arr)[i] = q31_sat((int64_t)floor(values[i] + 0.5)); break;
+	}
+
+	free(values);
+	PROF_END(PROF_FILE_READ, n);
+	return 0;
+}
+
+/******************************************************************************
+**                          FUNCTION IMPLEMENTAION
+**                          BINARY SIGNAL FILE
+*******************************************************************************/
+static int signal_header_check(const signal_header_t* header, const uint64_t file_bytes)
+{
+	uint64_t frame_bytes;
+
+	if (memcmp(header->magic, SIGNAL_MAGIC, 4) != 0)
+	{
+		fprintf(stderr, "signal file : bad magic, not a signal file\n");
+		return -1;
+	}
+	if (header->version != SIGNAL_VERSION)
+	{
+		fprintf(stderr, "signal file : unsupported version %u (byte order?)\n", (unsigned)header->version);
+		return -1;
+	}
+	if (elem_size((elem_t)header->elem) == 0 || header->channels == 0 || header->data_offset < sizeof(signal_header_t))
+	{
+		fprintf(stderr, "signal file : corrupted header\n");
+		return -1;
+	}
+	if (header->data_offset % elem_size((elem_t)header->elem) != 0) // the mapped view starts on a page, the samples must stay aligned
+	{
+		fprintf(stderr, "signal file : data offset %llu not aligned to the element size\n", (unsigned long long)header->data_offset);
+		return -1;
+	}
+
+	// compared by division : a crafted length or offset must not wrap the byte count
+	frame_bytes = (uint64_t)header->channels * elem_size((elem_t)header->elem);
+	if (header->data_offset > file_bytes || header->length > (file_bytes - header->data_offset) / frame_bytes)
+	{
+		fprintf(stderr, "signal file : truncated, %llu frames of %llu bytes after offset %llu do not fit in %llu bytes\n",
+			(unsigned long long)header->length, (unsigned long long)frame_bytes,
+			(unsigned long long)header->data_offset, (unsigned long long)file_bytes);
+		return -1;
+	}
+	return 0;
+}
+
+int write_signal_file(const char* file_name, const void* data, const elem_t type, const uint32_t channels, const double sample_rate, const uint64_t length)
+{
+	/*
+	* Arguments
+	- data : length frames of channels interleaved samples of element type
+	- length : Number of frames (samples per channel)
+
+	Description
+	-	Writes the 64 byte header and the samples with one bulk fwrite.
+		The samples start at SIGNAL_DATA_OFFSET so a mapped view is cache line aligned.
+	*/
+
+	signal_header_t header;
+	FILE* fp;
+	const size_t bytes = (size_t)(length * channels * elem_size(type));
+	PROF_BEGIN(PROF_FILE_WRITE);
+
+	if (elem_size(type) == 0 || channels == 0)
+	{
+		fprintf(stderr, "write_signal_file : invalid element type or channel count\n");
+		return -1;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SIGNAL_MAGIC, 4);
+	header.version = SIGNAL_VERSION;
+	header.elem = (uint16_t)type;
+	header.channels = channels;
+	header.sample_rate = sample_rate;
+	header.length = length;
+	header.data_offset = SIGNAL_DATA_OFFSET;
+
+	if ((fp = fopen(file_name, "wb")) == NULL)
+	{
+		fprintf(stderr, "File Open Error!\n");
+		return -1;
+	}
+
+	if (fwrite(&header, sizeof(header), 1, fp) != 1 || (bytes && fwrite(data, 1, bytes, fp) != bytes))
+	{
+		fprintf(stderr, "write_signal_file : write error\n");
+		fclose(fp);
+		return -1;
+	}
+
+	if (fclose(fp) != 0) return -1;
+	PROF_END(PROF_FILE_WRITE, length * channels);
+	return 0;
+}
+
+int read_signal_header(const char* file_name, signal_header_t* header)
+{
+	FILE* fp;
+	int64_t file_bytes;
+
+	if ((fp = fopen(file_name, "rb")) == NULL)
+	{
+		fprintf(stderr, "File Open Error!\n");
+		return -1;
+	}
+
+	if (fread(header, sizeof(*header), 1, fp) != 1)
+	{
+		fprintf(stderr, "signal file : truncated header\n");
+		fclose(fp);
+		return -1;
+	}
+
+	file_bytes = file_seek(fp, 0, SEEK_END) == 0 ? file_tell(fp) : -1;
+	fclose(fp);
+	if (file_bytes < 0)
+	{
+		fprintf(stderr, "signal file : cannot measure the file\n");
+		return -1;
+	}
+
+	return signal_header_check(header, (uint64_t)file_bytes);
+}
+
+int64_t read_signal_file(const char* file_name, void* data, const uint64_t max_frames, signal_header_t* header)
+{
+	/*
+	* Arguments
+	- data : Destination of at most max_frames frames
+	- header : Header of the file (output)
+
+	Description
+	-	Bulk fread of the samples, returns the number of frames read or -1.
+	*/
+
+	FILE* fp;
+	uint64_t frames;
+	size_t frame_bytes;
+	PROF_BEGIN(PROF_FILE_READ);
+
+	if (read_signal_header(file_name, header) < 0) return -1;
+
+	frames = header->length < max_frames ? header->length : max_frames;
+	frame_bytes = header->channels * elem_size((elem_t)header->elem);
+
+	if ((fp = fopen(file_name, "rb")) == NULL)
+	{
+		fprintf(stderr, "File Open Error!\n");
+		return -1;
+	}
+
+	if (file_seek(fp, (int64_t)header->data_offset, SEEK_SET) < 0
+		|| (frames && fread(data, frame_bytes, (size_t)frames, fp) != (size_t)frames))
+	{
+		fprintf(stderr, "read_signal_file : read error\n");
+		fclose(fp);
+		return -1;
+	}
+
+	fclose(fp);
+	PROF_END(PROF_FILE_READ, frames * header->channels);
+	return (int64_t)frames;
+}
+
+signal_handle signal_map(const char* file_name, const int writable)
+{
+	/*
+	* Arguments
+	- writable : 0 maps read only, otherwise stores go back to the file
+
+	Description
+	-	Maps the whole file. The samples are used in place through
+		signal_data / signal_view, nothing is copied.
+		Returns NULL on failure.
+	*/
+
+	signal_handle sig;
+	uint64_t file_bytes;
+
+	if ((sig = (signal_handle)calloc(1, sizeof(signal_file_t))) == NULL)
+	{
+		fprintf(stderr, "Memory Allocation Error!\n");
+		return NULL;
+	}
+	sig->writable = writable;
+#ifndef _WIN32
+	sig->fd = -1;
+#endif
+
+#ifdef _WIN32
+	{
+		LARGE_INTEGER size;
+
+		sig->file = CreateFileA(file_name, GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (sig->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(sig->file, &size))
+		{
+			fprintf(stderr, "File Open Error!\n");
+			sig->file = NULL;
+			signal_unmap(sig);
+			return NULL;
+		}
+		file_bytes = (uint64_t)size.QuadPart;
+
+		if (file_bytes >= sizeof(signal_header_t))
+		{
+			sig->mapping = CreateFileMappingA(sig->file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+			if (sig->mapping != NULL) sig->base = MapViewOfFile(sig->mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+		}
+	}
+#else
+	{
+		struct stat st;
+		void* base;
+
+		if ((sig->fd = open(file_name, writable ? O_RDWR : O_RDONLY)) < 0 || fstat(sig->fd, &st) < 0)
+		{
+			fprintf(stderr, "File Open Error!\n");
+			signal_unmap(sig);
+			return NULL;
+		}
+		file_bytes = (uint64_t)st.st_size;
+
+		if (file_bytes >= sizeof(signal_header_t))
+		{
+			base = mmap(NULL, (size_t)file_bytes, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, sig->fd, 0);
+			if (base != MAP_FAILED) sig->base = base;
+		}
+	}
+#endif
+
+	if (sig->base == NULL)
+	{
+		fprintf(stderr, "signal_map : cannot map %s\n", file_name);
+		signal_unmap(sig);
+		return NULL;
+	}
+	sig->bytes = file_bytes;
+	memcpy(&sig->header, sig->base, sizeof(signal_header_t));
+
+	if (signal_header_check(&sig->header, file_bytes) < 0)
+	{
+		signal_unmap(sig);
+		return NULL;
+	}
+	sig->data = (char*)sig->base + sig->header.data_offset;
+
+	return sig;
+}
+
+void signal_unmap(signal_handle sig)
+{
+	if (sig == NULL) return;
+
+#ifdef _WIN32
+	if (sig->base) UnmapViewOfFile(sig->base);
+	if (sig->mapping) CloseHandle(sig->mapping);
+	if (sig->file) CloseHandle(sig->file);
+#else
+	if (sig->base) munmap(sig->base, (size_t)sig->bytes);
+	if (sig->fd >= 0) close(sig->fd);
+#endif
+	free(sig);
+}
+
+const signal_header_t* signal_info(const signal_handle sig)
+{
+	return &sig->header;
+}
+
+void* signal_data(const signal_handle sig)
+{
+	return sig->data;
+}
+
+dtype* signal_view(const signal_handle sig)
+{
+	/*
+	Description
+	-	Zero copy dtype view of the samples, frame n channel c at view[n * channels + c].
+		NULL if the file does not store dtype elements (use signal_data and the typed kernels).
+	*/
+
+	if (sig->header.elem != SIGNAL_DTYPE_ELEM)
+	{
+		fprintf(stderr, "signal_view : file holds %s, not dtype\n", elem_name((elem_t)sig->header.elem));
+		return NULL;
+	}
+	return (dtype*)sig->data;
 }
\ No newline at end of file
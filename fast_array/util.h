@@ -1,26 +1,100 @@
-#pragma once
-
-#ifndef __UTIL_H__
-#define __UTIL_H__
-
-
-#define _CRT_SECURE_NO_WARNINGS
-
-#include "common.h"
-
-#define __WINDOWS__ // for windows applications
-//#define __LINUX__
-
-
-#define strconcat concat
-
-int getLength(char str[]);
-char* concat(const char str1[], const char str2[]);
-char* concat_token(const char* str1, const char token);
-string_dir dir_join(const char* dir1, const char* dir2);
-string_dir dir_joins_va(size_t args, string_dir root_dir, ...);
-
-
-int write_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type);
-int read_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type);
+#pragma once
+
+#ifndef __UTIL_H__
+#define __UTIL_H__
+
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "common.h"
+#include "typed.h"
+#include "text.h"
+
+#define __WINDOWS__ // for windows applications
+//#define __LINUX__
+
+
+#define strconcat concat
+
+int getLength(char str[]);
+char* concat(const char str1[], const char str2[]);
+char* concat_token(const char* str1, const char token);
+string_dir dir_join(const char* dir1, const char* dir2);
+string_dir dir_joins_va(size_t args, string_dir root_dir, ...);
+
+
+uint64_t time_now_ns(void);
+	// monotonic clock in nanoseconds (QueryPerformanceCounter / CLOCK_MONOTONIC)
+
+int file_seek(FILE* fp, const int64_t offset, const int origin);
+int64_t file_tell(FILE* fp);
+	// 64 bit fseek / ftell (_fseeki64 / fseeko), long offsets are 32 bit on Win64
+FILE* open_data_file(char* file_name, const char* mode);
+	// appends ".dat" when the name has neither ".dat" nor ".txt"
+#define TEXT_BLOCK 4096 // values (or bytes for read_data_chunk) converted per pass
+
+elem_t text_elem(const type_t data_type);
+	// element type a text data_type reads and writes as, ELEM_UNKNOWN when unsupported
+size_t read_data_chunk(FILE* fp, dtype* arr, const size_t size, const char token, const type_t data_type);
+
+int write_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type);
+int read_data_file(dtype* arr, const size_t size, char* file_name, const char token, const type_t data_type);
+int write_data_file_typed(const void* arr, const size_t size, char* file_name, const char token, const type_t data_type);
+int read_data_file_typed(void* arr, const size_t size, char* file_name, const char token, const type_t data_type);
+	// arr holds elements of data_type ("float", "double", "q15"/"int16", "q31"/"int32"), not dtype
+
+/******************************************************************************
+**                          FUNCTION DEFINITIONS
+**                          BINARY SIGNAL FILE
+*******************************************************************************/
+/*
+* A signal file is a 64 byte header followed by the raw samples,
+* interleaved by frame (sample n of channel c at n * channels + c),
+* in the byte order of the writer (little endian on every supported target).
+* The samples start on a cache line, so a mapped view can be handed
+* directly to the kernels.
+*/
+#define SIGNAL_MAGIC "FASG"
+#define SIGNAL_VERSION 1
+#define SIGNAL_DATA_OFFSET 64
+#define SIGNAL_DTYPE_ELEM ELEM_F64 // element type of dtype
+
+typedef struct _signal_header
+{
+	char magic[4];			// SIGNAL_MAGIC
+	uint16_t version;		// SIGNAL_VERSION
+	uint16_t elem;			// elem_t
+	uint32_t channels;
+	uint32_t reserved0;
+	double sample_rate;		// Hz
+	uint64_t length;		// frames
+	uint64_t data_offset;	// byte offset of the first sample
+	uint8_t reserved[24];
+} signal_header_t;			// 64 bytes
+
+typedef struct _signal_file
+{
+	signal_header_t header;
+	void* base;				// mapped file
+	void* data;				// first sample
+	uint64_t bytes;			// mapped length
+	int writable;
+#ifdef _WIN32
+	void* file, * mapping;	// HANDLE
+#else
+	int fd;
+#endif
+} signal_file_t;
+
+typedef signal_file_t* signal_handle;
+
+int write_signal_file(const char* file_name, const void* data, const elem_t type, const uint32_t channels, const double sample_rate, const uint64_t length);
+int read_signal_header(const char* file_name, signal_header_t* header);
+int64_t read_signal_file(const char* file_name, void* data, const uint64_t max_frames, signal_header_t* header);
+
+signal_handle signal_map(const char* file_name, const int writable);
+void signal_unmap(signal_handle sig);
+const signal_header_t* signal_info(const signal_handle sig);
+void* signal_data(const signal_handle sig);
+dtype* signal_view(const signal_handle sig);
 #endif
\ No newline at end of file